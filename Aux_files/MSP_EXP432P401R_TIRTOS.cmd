@@ -77,6 +77,9 @@ SECTIONS
 
     .stack  :   > SRAM_DATA (HIGH)
 
+    /* Formatos de HVAC_LOG: van en el .out para Tools/log_decoder.py, no al MSP432. */
+    .log_fmt : > 0x90000000, type = COPY
+
 /*
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
@@ -0,0 +1,197 @@
+ //FileName:        gpio_exp_MSP432.c
+ //Dependencies:    system.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Expansor de GPIO por SPI (74HC595 / 74HC165) para los archivos "gpio:". Source File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#include "HVAC.h"
+
+extern GPIO_PIN_MAP gpio_global_pin_map;                       // Los pines del bus no se pueden abrir como GPIO.
+
+// Pines de eUSCI_B0 en P1 (función primaria): P1.5 UCB0CLK, P1.6 UCB0SIMO, P1.7 UCB0SOMI.
+#define GPIO_EXP_SPI_PORT   0
+#define GPIO_EXP_SPI_PINS   0xE0
+
+// Puerto (0 -> P1) y máscara de un GPIO_PIN_STRUCT de BSP.h.
+#define GPIO_EXP_PORT_OF(p) ((((p) & GPIO_PIN_ADDR) >> 3) - 1)
+#define GPIO_EXP_MASK_OF(p) (1 << ((p) & 0x07))
+
+static uint_8  gpio_exp_out_image [GPIO_EXP_OUT_PORTS] = { 0 };    // Lo que deben mostrar los 74HC595.
+static uint_8  gpio_exp_in_image  [GPIO_EXP_IN_PORTS]  = { 0 };    // Última captura de los 74HC165.
+static boolean gpio_exp_dirty = FALSE;                             // Hay salidas por enviar.
+static boolean gpio_exp_ready = FALSE;
+
+#ifdef GPIO_EXPANDER_SIM
+uint_8  gpio_exp_sim_outputs [GPIO_EXP_OUT_PORTS] = { 0 };
+uint_8  gpio_exp_sim_inputs  [GPIO_EXP_IN_PORTS]  = { 0 };
+uint_32 gpio_exp_sim_transfers = 0;
+#endif
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : gpio_exp_init
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Reserva los pines del bus, configura eUSCI_B0 como maestro SPI (modo 0,
+*    MSB primero) y engancha la actualización al tick. Solo la primera vez.
+*
+*END***********************************************************************************/
+
+_mqx_int gpio_exp_init (void)
+{
+    if (gpio_exp_ready)
+        return IO_OK;
+
+#ifndef GPIO_EXPANDER_SIM
+    Int_disable();
+
+    if ((gpio_global_pin_map.memory8[GPIO_EXP_SPI_PORT] & GPIO_EXP_SPI_PINS) ||
+        (gpio_global_pin_map.memory8[GPIO_EXP_PORT_OF(BSP_EXP_LATCH)] & GPIO_EXP_MASK_OF(BSP_EXP_LATCH)) ||
+        (gpio_global_pin_map.memory8[GPIO_EXP_PORT_OF(BSP_EXP_LOAD)]  & GPIO_EXP_MASK_OF(BSP_EXP_LOAD)))
+    {
+        Int_enable();                                           // Bus ocupado por otro archivo.
+        return IO_ERR;
+    }
+
+    gpio_global_pin_map.memory8[GPIO_EXP_SPI_PORT] |= GPIO_EXP_SPI_PINS;
+    gpio_global_pin_map.memory8[GPIO_EXP_PORT_OF(BSP_EXP_LATCH)] |= GPIO_EXP_MASK_OF(BSP_EXP_LATCH);
+    gpio_global_pin_map.memory8[GPIO_EXP_PORT_OF(BSP_EXP_LOAD)]  |= GPIO_EXP_MASK_OF(BSP_EXP_LOAD);
+
+    // RCLK de los 595 en bajo; SH/LD de los 165 en alto (modo corrimiento).
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LATCH), OFS_PAOUT) &= ~GPIO_EXP_MASK_OF(BSP_EXP_LATCH);
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LATCH), OFS_PADIR) |=  GPIO_EXP_MASK_OF(BSP_EXP_LATCH);
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LOAD),  OFS_PAOUT) |=  GPIO_EXP_MASK_OF(BSP_EXP_LOAD);
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LOAD),  OFS_PADIR) |=  GPIO_EXP_MASK_OF(BSP_EXP_LOAD);
+
+    GPIO_PORT_REG(GPIO_EXP_SPI_PORT, OFS_PASEL1) &= ~GPIO_EXP_SPI_PINS;
+    GPIO_PORT_REG(GPIO_EXP_SPI_PORT, OFS_PASEL0) |=  GPIO_EXP_SPI_PINS;
+
+    EUSCI_B0 -> CTLW0 = EUSCI_B_CTLW0_SWRST;
+    EUSCI_B0 -> CTLW0 = EUSCI_B_CTLW0_SWRST | EUSCI_B_CTLW0_CKPH | EUSCI_B_CTLW0_MSB |    // Captura en el primer flanco,
+                        EUSCI_B_CTLW0_MST   | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_SSEL__SMCLK; // como lo esperan los HC.
+    EUSCI_B0 -> BRW   = (pwm_smclk() + BSP_EXP_SPI_HZ - 1) / BSP_EXP_SPI_HZ;                // Sin pasar de BSP_EXP_SPI_HZ.
+    EUSCI_B0 -> CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+
+    Int_enable();
+#endif
+
+    gpio_exp_dirty = TRUE;                                      // La primera actualización fija todas las salidas.
+
+    if (IO_OK != timer_hook_add(gpio_exp_update))               // Sin gancho el bus se libera.
+    {
+        gpio_exp_dirty = FALSE;
+#ifndef GPIO_EXPANDER_SIM
+        Int_disable();
+        EUSCI_B0 -> CTLW0 = EUSCI_B_CTLW0_SWRST;
+        gpio_global_pin_map.memory8[GPIO_EXP_SPI_PORT] &= ~GPIO_EXP_SPI_PINS;
+        gpio_global_pin_map.memory8[GPIO_EXP_PORT_OF(BSP_EXP_LATCH)] &= ~GPIO_EXP_MASK_OF(BSP_EXP_LATCH);
+        gpio_global_pin_map.memory8[GPIO_EXP_PORT_OF(BSP_EXP_LOAD)]  &= ~GPIO_EXP_MASK_OF(BSP_EXP_LOAD);
+        Int_enable();
+#endif
+        return IO_ERR;
+    }
+
+    gpio_exp_ready = TRUE;
+
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : gpio_exp_read / gpio_exp_output / gpio_exp_write
+* Returned Value   : Imagen del puerto / None.
+* Comments         :
+*    Acceso del driver de GPIO a las imágenes, con el índice de puerto del
+*    archivo (GPIO_EXP_OUT_FIRST.., GPIO_EXP_IN_FIRST..). La escritura solo
+*    marca el cambio (y despierta al tick); sale al bus en la siguiente
+*    actualización. Se llaman con interrupciones desactivadas.
+*
+*END***********************************************************************************/
+
+uint_8 gpio_exp_read (uint_32 port)
+{
+    if (port >= GPIO_EXP_IN_FIRST)
+        return gpio_exp_in_image[port - GPIO_EXP_IN_FIRST];
+    return gpio_exp_out_image[port - GPIO_EXP_OUT_FIRST];      // Las salidas se leen como se escribieron.
+}
+
+uint_8 gpio_exp_output (uint_32 port)
+{
+    return gpio_exp_out_image[port - GPIO_EXP_OUT_FIRST];
+}
+
+void gpio_exp_write (uint_32 port, uint_8 mask, boolean level)
+{
+    if (level)
+        gpio_exp_out_image[port - GPIO_EXP_OUT_FIRST] |=  mask;
+    else
+        gpio_exp_out_image[port - GPIO_EXP_OUT_FIRST] &= ~mask;
+
+    if (!gpio_exp_dirty)
+    {
+        gpio_exp_dirty = TRUE;
+        timer_reschedule();
+    }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : gpio_exp_update
+* Returned Value   : TIMER_HOOK_NEXT mientras haya entradas o salidas
+*                    pendientes, si no TIMER_HOOK_IDLE.
+* Comments         :
+*    Enganchada al tick del timer32_2. Una sola transacción por tick, con
+*    todos los cambios acumulados: SH/LD captura las entradas, se corren
+*    GPIO_EXP_BYTES bytes en ambos sentidos y RCLK pasa las salidas a la
+*    vez. El primer byte enviado termina en el último 595 de la cadena,
+*    así que se envían al revés; el primer byte recibido es el 165 que
+*    maneja SOMI (PORT_XI0). Si no hay salidas pendientes ni entradas en
+*    la tarjeta, no se toca el bus ni se pide el siguiente tick.
+*
+*END***********************************************************************************/
+
+uint_32 gpio_exp_update (uint_32 elapsed)
+{
+    uint_8  tx, rx [GPIO_EXP_BYTES];
+    uint_32 i, k;
+
+    if (!gpio_exp_dirty && (BSP_EXP_IN_BYTES == 0))
+        return TIMER_HOOK_IDLE;
+    if (elapsed == 0)
+        return TIMER_HOOK_NEXT;
+
+#ifdef GPIO_EXPANDER_SIM
+    for (i = 0; i < BSP_EXP_OUT_BYTES; i++)
+        gpio_exp_sim_outputs[i] = gpio_exp_out_image[i];
+    for (i = 0; i < BSP_EXP_IN_BYTES; i++)
+        rx[i] = gpio_exp_sim_inputs[i];
+    gpio_exp_sim_transfers++;
+#else
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LOAD), OFS_PAOUT) &= ~GPIO_EXP_MASK_OF(BSP_EXP_LOAD);  // Captura.
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LOAD), OFS_PAOUT) |=  GPIO_EXP_MASK_OF(BSP_EXP_LOAD);
+
+    for (i = 0; i < GPIO_EXP_BYTES; i++)
+    {
+        k  = GPIO_EXP_BYTES - 1 - i;                                // Relleno primero si hay más 165 que 595.
+        tx = (k < BSP_EXP_OUT_BYTES) ? gpio_exp_out_image[k] : 0;
+
+        while (!(EUSCI_B0 -> IFG & EUSCI_B_IFG_TXIFG));
+        EUSCI_B0 -> TXBUF = tx;
+        while (!(EUSCI_B0 -> IFG & EUSCI_B_IFG_RXIFG));
+        rx[i] = EUSCI_B0 -> RXBUF;
+    }
+
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LATCH), OFS_PAOUT) |=  GPIO_EXP_MASK_OF(BSP_EXP_LATCH); // Flanco de subida:
+    GPIO_PORT_REG(GPIO_EXP_PORT_OF(BSP_EXP_LATCH), OFS_PAOUT) &= ~GPIO_EXP_MASK_OF(BSP_EXP_LATCH); // salidas nuevas.
+#endif
+
+    for (i = 0; i < BSP_EXP_IN_BYTES; i++)
+        gpio_exp_in_image[i] = rx[i];
+    gpio_exp_dirty = FALSE;
+
+    return (BSP_EXP_IN_BYTES == 0) ? TIMER_HOOK_IDLE : TIMER_HOOK_NEXT;   // Las entradas se leen cada tick.
+}
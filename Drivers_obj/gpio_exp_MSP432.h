@@ -0,0 +1,42 @@
+ //FileName:        gpio_exp_MSP432.h
+ //Dependencies:    None.
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Expansor de GPIO por SPI (74HC595 / 74HC165) para los archivos "gpio:". Header File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#ifndef GPIO_EXP_MSP432_H_
+#define GPIO_EXP_MSP432_H_
+
+/*
+ *  Los pines del expansor se abren como cualquier pin de GPIO, con los
+ *  puertos PORT_XO0..PORT_XO3 (salidas, cadena de 74HC595) y PORT_XI0..
+ *  PORT_XI3 (entradas, cadena de 74HC165). El driver de GPIO solo escribe
+ *  y lee imágenes en RAM; en cada tick del timer32_2 (si hay salidas
+ *  pendientes o entradas en la tarjeta) se hace una sola transacción SPI
+ *  por eUSCI_B0 que captura todas las entradas, corre todas las salidas
+ *  y las pasa a los latches a la vez.
+ *
+ *  Con GPIO_EXPANDER_SIM no se toca hardware: la transacción copia la
+ *  imagen de salidas a gpio_exp_sim_outputs y toma las entradas de
+ *  gpio_exp_sim_inputs, para probar la lógica en el host.
+ */
+
+#define GPIO_EXP_BYTES      ((BSP_EXP_OUT_BYTES > BSP_EXP_IN_BYTES) ? BSP_EXP_OUT_BYTES : BSP_EXP_IN_BYTES)
+
+extern _mqx_int gpio_exp_init   (void);
+extern uint_8   gpio_exp_read   (uint_32 port);
+extern uint_8   gpio_exp_output (uint_32 port);
+extern void     gpio_exp_write  (uint_32 port, uint_8 mask, boolean level);
+extern uint_32  gpio_exp_update (uint_32 elapsed);
+
+#ifdef GPIO_EXPANDER_SIM
+extern uint_8   gpio_exp_sim_outputs [GPIO_EXP_OUT_PORTS];     // Lo que muestran los 74HC595 simulados.
+extern uint_8   gpio_exp_sim_inputs  [GPIO_EXP_IN_PORTS];      // Lo que presentan los 74HC165 simulados.
+extern uint_32  gpio_exp_sim_transfers;                        // Transacciones hechas.
+#endif
+
+#endif /* GPIO_EXP_MSP432_H_ */
@@ -1,683 +1,1463 @@
- //FileName:        gpio_f_MSP432.c
- //Dependencies:    system.h
- //Processor:       MSP432
- //Board:			MSP432P401R
- //Program version: CCS V8.3 TI
- //Company:         Texas Instruments
- //Description:     Driver para GPIO por medio de archivos. Source File.
- //Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- //Updated:         12/2018
-
-#include "HVAC.h"
-
-GPIO_PIN_MAP gpio_global_pin_map = {.memory8[0] = 0, .memory8[1] = 0, .memory8[2] = 0,
-                                    .memory8[3] = 0, .memory8[4] = 0, .memory8[5] = 0},
-            gpio_global_irq_map =  {.memory8[0] = 0, .memory8[1] = 0, .memory8[2] = 0,
-                                    .memory8[3] = 0, .memory8[4] = 0, .memory8[5] = 0};
-
-/*FUNCTION***************************************************************************
-*
-* Function Name    : gpio_open
-* Returned Value   : IO_OK or IO_ERR
-* Comments         :
-*    Prepara los archivos para su uso. Reservacin de memoria y llenado de formatos.
-*
-*END********************************************************************************/
-
-_mqx_int gpio_open  (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags)
-{
-    _mqx_int            i;
-    uint_8              pin;
-    uint_32             addr;
-
-    GPIO_DEV_DATA_PTR   dev_data_ptr;
-    GPIO_PIN_STRUCT _PTR_ pin_table = (GPIO_PIN_STRUCT _PTR_) flags;
-
-    if (NULL == (dev_data_ptr = (GPIO_DEV_DATA_PTR) malloc(sizeof(GPIO_DEV_DATA)))) // Reservacin de memoria de datos.
-        return ERR_FUNC;
-
-    // Inicializacin en cero's.
-    dev_data_ptr -> irq_func = 0;
-    for(i = 0; i < (MAX_PORTS); i++)
-    {
-       dev_data_ptr-> pin_map.memory8 [i] = 0;
-       dev_data_ptr-> irq_map.memory8[i] = 0;
-       dev_data_ptr-> irq_edge_map.memory8[i] = 0;
-    }
-    dev_data_ptr -> type = 0;
-
-
-    fd_ptr -> DEV_DATA_PTR = (pointer) dev_data_ptr;    // Esta informacin, para GPIO se guarda en el apuntador vaco del disp.
-
-    /* Checar puertos y pines. */
-
-    Int_disable();                                                          // Conviene desactivar interrupciones.
-    for (; *pin_table != GPIO_LIST_END; pin_table++)
-    {
-        if (*pin_table & GPIO_PIN_VALID)                                    // Valida pin.
-        {
-            addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                       // Encuentra puerto.
-            pin = 1 << (*pin_table & 0x07);                                 // Prepara mascara de bit.
-
-            if (addr > 0 && addr <= MAX_PORTS)                              // Valida puerto.
-                if (! (gpio_global_pin_map.memory8[addr-1] & pin))          // El pin es usado ya en otro archivo?
-                {
-                    if (*pin_table & GPIO_PIN_IRQ)
-                    {
-                        if (!(gpio_global_irq_map.memory8[addr-1] & pin))
-                        {                                                       // Con o sin funcin de interrupcin.
-                            dev_data_ptr->irq_map.memory8[addr-1] |= pin;       // Marca pin para uso en interrupcin.
-                            dev_data_ptr->pin_map.memory8[addr-1] |= pin;
-
-                            if(*pin_table & GPIO_IRQ_EDGE_H_TO_L)               // Ante interrupcin, modo de flanco.
-                                dev_data_ptr->irq_edge_map.memory8[addr-1]|= pin;
-                            continue;
-                        }
-                    }
-                    else
-                    {
-                        dev_data_ptr->pin_map.memory8[addr-1] |= pin;       // Solo marca pin, sin interrupcin.
-                        continue;
-                    }
-                }
-        }
-
-        free(dev_data_ptr); // Libera memoria temporal al haber procedimiento incorrecto.
-        Int_enable();       // Reanudacin de interrupciones.
-        return IO_ERR;
-    }
-
-    if (IO_OK != gpio_cpu_open(fd_ptr, open_name_ptr, flags))   // Configura realmente pines en HW.
-    {
-            free(dev_data_ptr);
-            return IO_ERR;
-    }
-
-    /* Ahora se llena el uso de bits pero en la estructura general. */
-    for (i = 0; i < MAX_PORTS; i++)
-    {
-        gpio_global_pin_map.memory8[i] |= dev_data_ptr->pin_map.memory8[i];
-        gpio_global_irq_map.memory8[i] |= dev_data_ptr->irq_map.memory8[i];
-    }
-
-    Int_enable();       // Reanudacin de interrupciones.
-    return IO_OK;
-}
-
-/*FUNCTION*****************************************************************
-*
-* Function Name    : gpio_cpu_open
-* Returned Value   : IO_OK or error
-* Comments         :
-*    Implementa la verdadera inicializacin en HW del GPIO.
-*
-*END*********************************************************************/
-
-_mqx_int gpio_cpu_open (FILE_PTR_f fd_ptr, char_ptr file_name, char_ptr param_ptr)
-{
-   static _mqx_int   bandera = 0;
-   _mqx_int          i;
-   GPIO_DEV_DATA_PTR dev_data_ptr = (GPIO_DEV_DATA_PTR) fd_ptr->DEV_DATA_PTR;
-
-
-   GPIO_PIN_STRUCT _PTR_   pin_table;
-   uint_32                 addr;
-   uint_8                  pin;
-   GPIO_PIN_MAP_PTR        temp_pin_map_ptr;
-
-   /* Determina accesso de GPIO (I o O). */
-    if ((file_name != NULL) && (*file_name != 0))
-    {
-        if (!strncmp(file_name, "gpio:write", 11))
-            dev_data_ptr->type = DEV_OUTPUT;
-        else if (!strncmp(file_name, "gpio:output", 12))
-            dev_data_ptr->type = DEV_OUTPUT;
-        else if (!strncmp(file_name, "gpio:read", 10))
-            dev_data_ptr->type = DEV_INPUT;
-        else if (!strncmp(file_name, "gpio:input", 11))
-            dev_data_ptr->type = DEV_INPUT;
-        else
-            return IO_ERR;                                  /* Error. */
-    }
-    else
-            return IO_ERR;                                  /* Error. */
-
-    if ((param_ptr != NULL) && (dev_data_ptr->type == DEV_OUTPUT))
-    {
-        // Reservacin de memoria.
-        if (NULL == (temp_pin_map_ptr = (GPIO_PIN_MAP_PTR) malloc(sizeof(GPIO_PIN_MAP))))
-            return IO_ERR;
-
-        // Inicializacin en cero's.
-        for(i = 0; i < (MAX_PORTS); i++)
-        {
-           temp_pin_map_ptr-> memory8[i] = 0;
-        }
-
-        // Prepara mapeo de pin.
-        for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
-        {
-            addr = (*pin_table & GPIO_PIN_ADDR) >> 3;           /* Puerto. */
-            pin = 1 << (*pin_table & 0x07);                     /* Mscara de bit. */
-            if (*pin_table & GPIO_PIN_STATUS)
-                temp_pin_map_ptr->memory8[addr-1] |= pin;
-        }
-
-        /* Aplicacin de la salida inicial segn respuesta recibida. */
-
-        P1 -> OUT = temp_pin_map_ptr->memory8[0];
-        P2 -> OUT = temp_pin_map_ptr->memory8[1];
-        P3 -> OUT = temp_pin_map_ptr->memory8[2];
-        P4 -> OUT = temp_pin_map_ptr->memory8[3];
-        P5 -> OUT = temp_pin_map_ptr->memory8[4];
-        P6 -> OUT = temp_pin_map_ptr->memory8[5];
-        P7 -> OUT = temp_pin_map_ptr->memory8[6];
-        P8 -> OUT = temp_pin_map_ptr->memory8[7];
-        P9 -> OUT = temp_pin_map_ptr->memory8[8];
-        P10 -> OUT =temp_pin_map_ptr->memory8[9];
-
-       free(temp_pin_map_ptr);
-    }
-
-    if (dev_data_ptr->type == DEV_OUTPUT)               // Tipo salida.
-    {
-       P1 -> DIR |= dev_data_ptr->pin_map.memory8[0];
-       P2 -> DIR |= dev_data_ptr->pin_map.memory8[1];
-       P3 -> DIR |= dev_data_ptr->pin_map.memory8[2];
-       P4 -> DIR |= dev_data_ptr->pin_map.memory8[3];
-       P5 -> DIR |= dev_data_ptr->pin_map.memory8[4];
-       P6 -> DIR |= dev_data_ptr->pin_map.memory8[5];
-       P7 -> DIR |= dev_data_ptr->pin_map.memory8[6];
-       P8 -> DIR |= dev_data_ptr->pin_map.memory8[7];
-       P9 -> DIR |= dev_data_ptr->pin_map.memory8[8];
-       P10 -> DIR |=dev_data_ptr->pin_map.memory8[9];
-
-   }
-
-   else                                                 // Tipo entrada.
-   {
-       P1 -> DIR &= ~dev_data_ptr->pin_map.memory8[0];
-       P2 -> DIR &= ~dev_data_ptr->pin_map.memory8[1];
-       P3 -> DIR &= ~dev_data_ptr->pin_map.memory8[2];
-       P4 -> DIR &= ~dev_data_ptr->pin_map.memory8[3];
-       P5 -> DIR &= ~dev_data_ptr->pin_map.memory8[4];
-       P6 -> DIR &= ~dev_data_ptr->pin_map.memory8[5];
-       P7 -> DIR &= ~dev_data_ptr->pin_map.memory8[6];
-       P8 -> DIR &= ~dev_data_ptr->pin_map.memory8[7];
-       P9 -> DIR &= ~dev_data_ptr->pin_map.memory8[8];
-       P10 -> DIR &=~dev_data_ptr->pin_map.memory8[9];
-
-       P1 -> REN |= dev_data_ptr->pin_map.memory8[0];  // Habilitar resistencias de pull-up.
-       P2 -> REN |= dev_data_ptr->pin_map.memory8[1];
-       P3 -> REN |= dev_data_ptr->pin_map.memory8[2];
-       P4 -> REN |= dev_data_ptr->pin_map.memory8[3];
-       P5 -> REN |= dev_data_ptr->pin_map.memory8[4];
-       P6 -> REN |= dev_data_ptr->pin_map.memory8[5];
-       P7 -> REN |= dev_data_ptr->pin_map.memory8[6];
-       P8 -> REN |= dev_data_ptr->pin_map.memory8[7];
-       P9 -> REN |= dev_data_ptr->pin_map.memory8[8];
-       P10 -> REN |=dev_data_ptr->pin_map.memory8[9];
-
-       P1 -> OUT |= dev_data_ptr->pin_map.memory8[0];
-       P2 -> OUT |= dev_data_ptr->pin_map.memory8[1];  // Esto es necesario en algunas tarjetas...
-       P3 -> OUT |= dev_data_ptr->pin_map.memory8[2];
-       P4 -> OUT |= dev_data_ptr->pin_map.memory8[3];
-       P5 -> OUT |= dev_data_ptr->pin_map.memory8[4];
-       P6 -> OUT |= dev_data_ptr->pin_map.memory8[5];
-       P3 -> OUT |= dev_data_ptr->pin_map.memory8[6];
-       P4 -> OUT |= dev_data_ptr->pin_map.memory8[7];
-       P5 -> OUT |= dev_data_ptr->pin_map.memory8[8];
-       P6 -> OUT |= dev_data_ptr->pin_map.memory8[9];
-
-       P1 -> IFG &= ~dev_data_ptr->pin_map.memory8[0];  // Elimina alguna posible bandera de interrupcin.
-       P2 -> IFG &= ~dev_data_ptr->pin_map.memory8[1];
-       P3 -> IFG &= ~dev_data_ptr->pin_map.memory8[2];
-       P4 -> IFG &= ~dev_data_ptr->pin_map.memory8[3];
-       P5 -> IFG &= ~dev_data_ptr->pin_map.memory8[4];
-       P6 -> IFG &= ~dev_data_ptr->pin_map.memory8[5];
-       P3 -> IFG &= ~dev_data_ptr->pin_map.memory8[6];
-       P4 -> IFG &= ~dev_data_ptr->pin_map.memory8[7];
-       P5 -> IFG &= ~dev_data_ptr->pin_map.memory8[8];
-       P6 -> IFG &= ~dev_data_ptr->pin_map.memory8[9];
-
-       if(bandera == 0)                                 // En un inicio, es correcto eliminar banderas en registros.
-       {
-           P1 -> IFG = 0x00;    P1-> IE = dev_data_ptr-> irq_map.memory8[0]; P1 -> IES =  dev_data_ptr-> irq_edge_map.memory8[0];
-           P2 -> IFG = 0x00;    P2-> IE = dev_data_ptr-> irq_map.memory8[1]; P2 -> IES =  dev_data_ptr-> irq_edge_map.memory8[1];
-           P3 -> IFG = 0x00;    P3-> IE = dev_data_ptr-> irq_map.memory8[2]; P3 -> IES =  dev_data_ptr-> irq_edge_map.memory8[2];
-           P4 -> IFG = 0x00;    P4-> IE = dev_data_ptr-> irq_map.memory8[3]; P4 -> IES =  dev_data_ptr-> irq_edge_map.memory8[3];
-           P5 -> IFG = 0x00;    P5-> IE = dev_data_ptr-> irq_map.memory8[4]; P5 -> IES =  dev_data_ptr-> irq_edge_map.memory8[4];
-           P6 -> IFG = 0x00;    P6-> IE = dev_data_ptr-> irq_map.memory8[5]; P6 -> IES =  dev_data_ptr-> irq_edge_map.memory8[5];
-           P7 -> IFG = 0x00;    P7-> IE = dev_data_ptr-> irq_map.memory8[6]; P7 -> IES =  dev_data_ptr-> irq_edge_map.memory8[6];
-           P8 -> IFG = 0x00;    P8-> IE = dev_data_ptr-> irq_map.memory8[7]; P8 -> IES =  dev_data_ptr-> irq_edge_map.memory8[7];
-           P9 -> IFG = 0x00;    P9-> IE = dev_data_ptr-> irq_map.memory8[8]; P9 -> IES =  dev_data_ptr-> irq_edge_map.memory8[8];
-           P10-> IFG = 0x00;    P10->IE = dev_data_ptr-> irq_map.memory8[9]; P10-> IES =  dev_data_ptr-> irq_edge_map.memory8[9];
-           bandera = 1;
-       }
-
-       else
-       {
-           P1-> IE |= dev_data_ptr-> irq_map.memory8[0]; P1 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[0];
-           P2-> IE |= dev_data_ptr-> irq_map.memory8[1]; P2 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[1];
-           P3-> IE |= dev_data_ptr-> irq_map.memory8[2]; P3 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[2];
-           P4-> IE |= dev_data_ptr-> irq_map.memory8[3]; P4 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[3];
-           P5-> IE |= dev_data_ptr-> irq_map.memory8[4]; P5 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[4];
-           P6-> IE |= dev_data_ptr-> irq_map.memory8[5]; P6 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[5];
-           P7-> IE |= dev_data_ptr-> irq_map.memory8[6]; P7 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[6];
-           P8-> IE |= dev_data_ptr-> irq_map.memory8[7]; P8 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[7];
-           P9-> IE |= dev_data_ptr-> irq_map.memory8[8]; P9 -> IES |=  dev_data_ptr-> irq_edge_map.memory8[8];
-           P10->IE |= dev_data_ptr-> irq_map.memory8[9]; P10-> IES |=  dev_data_ptr-> irq_edge_map.memory8[9];
-       }
-   }
-
-    return IO_OK;
-
-}
-
-
-/*FUNCTION*****************************************************************
-*
-* Function Name    : gpio_cpu_ioctl
-* Returned Value   : depends on IOCTL command
-* Comments         :
-*    Implementa funciones de control para el GPIO.
-*
-*END*********************************************************************/
-
-_mqx_int gpio_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
-{
-    _mqx_int            i;
-    GPIO_DEV_DATA_PTR  dev_data_ptr = (GPIO_DEV_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
-
-       switch (cmd)
-       {
-
-           case GPIO_IOCTL_ADD_PINS:
-           {
-               // Agregar pines al archivo.
-               GPIO_PIN_STRUCT _PTR_  pin_table;
-               uint_32        addr;
-               uint_8         pin;
-
-               // Checar si no son usados ya por otro puerto.
-               Int_disable();
-               for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
-               {
-                   if (*pin_table & GPIO_PIN_VALID)                                            // Validacin bit.
-                   {
-                       addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                               // Puerto.
-                       pin = 1 << (*pin_table & 0x07);                                         // Mscara de bit.
-                       if (addr < MAX_PORTS)                                                   // Validacin puerto.
-                           if (!(gpio_global_pin_map.memory8[addr-1] & pin))                   // Chequeo.
-                               continue;                                                       // Siguiente chequeo de pin.
-                   }                                                                           // Algn problema ocurri.
-                   Int_enable();
-                   return IO_ERR;
-               }
-
-               // Chequeo correcto, se procede a agregar los pines.
-               for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
-               {
-                   addr = (*pin_table & GPIO_PIN_ADDR)  >> 3;                                   // Puerto.
-                   pin = 1 << (*pin_table & 0x07);                                              // Mscara de bit.
-                   dev_data_ptr->pin_map.memory8[addr-1] |= pin;                                // Validacin puerto.
-                   gpio_global_pin_map.memory8[addr-1] |= pin;                                  // Marcar pin como global.
-               }
-
-               if (dev_data_ptr->type == DEV_OUTPUT)                                            // Tipo salida.
-               {
-                  P1 -> DIR |= dev_data_ptr->pin_map.memory8[0];
-                  P2 -> DIR |= dev_data_ptr->pin_map.memory8[1];
-                  P3 -> DIR |= dev_data_ptr->pin_map.memory8[2];
-                  P4 -> DIR |= dev_data_ptr->pin_map.memory8[3];
-                  P5 -> DIR |= dev_data_ptr->pin_map.memory8[4];
-                  P6 -> DIR |= dev_data_ptr->pin_map.memory8[5];
-                  P7 -> DIR |= dev_data_ptr->pin_map.memory8[6];
-                  P8 -> DIR |= dev_data_ptr->pin_map.memory8[7];
-                  P9 -> DIR |= dev_data_ptr->pin_map.memory8[8];
-                  P10-> DIR |= dev_data_ptr->pin_map.memory8[9];
-              }
-
-              else                                                                              // Tipo entrada.
-              {
-                  P1 -> DIR &= ~dev_data_ptr->pin_map.memory8[0];
-                  P2 -> DIR &= ~dev_data_ptr->pin_map.memory8[1];
-                  P3 -> DIR &= ~dev_data_ptr->pin_map.memory8[2];
-                  P4 -> DIR &= ~dev_data_ptr->pin_map.memory8[3];
-                  P5 -> DIR &= ~dev_data_ptr->pin_map.memory8[4];
-                  P6 -> DIR &= ~dev_data_ptr->pin_map.memory8[5];
-                  P7 -> DIR &= ~dev_data_ptr->pin_map.memory8[6];
-                  P8 -> DIR &= ~dev_data_ptr->pin_map.memory8[7];
-                  P9 -> DIR &= ~dev_data_ptr->pin_map.memory8[8];
-                  P10-> DIR &= ~dev_data_ptr->pin_map.memory8[9];
-
-                  P1 -> REN |= dev_data_ptr->pin_map.memory8[0];                                // Habilitar resistencias de pull-up.
-                  P2 -> REN |= dev_data_ptr->pin_map.memory8[1];
-                  P3 -> REN |= dev_data_ptr->pin_map.memory8[2];
-                  P4 -> REN |= dev_data_ptr->pin_map.memory8[3];
-                  P5 -> REN |= dev_data_ptr->pin_map.memory8[4];
-                  P6 -> REN |= dev_data_ptr->pin_map.memory8[5];
-                  P6 -> REN |= dev_data_ptr->pin_map.memory8[5];
-                  P7 -> REN |= dev_data_ptr->pin_map.memory8[6];
-                  P8 -> REN |= dev_data_ptr->pin_map.memory8[7];
-                  P9 -> REN |= dev_data_ptr->pin_map.memory8[8];
-                  P10-> REN |= dev_data_ptr->pin_map.memory8[9];
-
-                  P1 -> OUT |= dev_data_ptr->pin_map.memory8[0];                                // Esto es necesario en algunas
-                  P2 -> OUT |= dev_data_ptr->pin_map.memory8[1];                                // tarjetas ...
-                  P3 -> OUT |= dev_data_ptr->pin_map.memory8[2];
-                  P4 -> OUT |= dev_data_ptr->pin_map.memory8[3];
-                  P5 -> OUT |= dev_data_ptr->pin_map.memory8[4];
-                  P6 -> OUT |= dev_data_ptr->pin_map.memory8[5];
-                  P7 -> OUT |= dev_data_ptr->pin_map.memory8[6];
-                  P8 -> OUT |= dev_data_ptr->pin_map.memory8[7];
-                  P9 -> OUT |= dev_data_ptr->pin_map.memory8[8];
-                  P10-> OUT |= dev_data_ptr->pin_map.memory8[9];
-              }
-
-              Int_enable();                                         // Renueva interrupciones.
-           }
-           break;
-
-           // Poner en alto varias o todos las salidas (cuando entra de parmetro un NULL) del archivo.
-           case GPIO_IOCTL_WRITE_LOG1:
-           {
-
-               if (dev_data_ptr->type != DEV_OUTPUT)
-                   return IO_ERR;
-               if (param_ptr == NULL)                               // Comando al archivo entero.
-               {
-                   Int_disable();
-                   P1 -> OUT |= dev_data_ptr->pin_map.memory8[0];
-                   P2 -> OUT |= dev_data_ptr->pin_map.memory8[1];
-                   P3 -> OUT |= dev_data_ptr->pin_map.memory8[2];
-                   P4 -> OUT |= dev_data_ptr->pin_map.memory8[3];
-                   P5 -> OUT |= dev_data_ptr->pin_map.memory8[4];
-                   P6 -> OUT |= dev_data_ptr->pin_map.memory8[5];
-                   P6 -> OUT |= dev_data_ptr->pin_map.memory8[5];
-                   P7 -> OUT |= dev_data_ptr->pin_map.memory8[6];
-                   P8 -> OUT |= dev_data_ptr->pin_map.memory8[7];
-                   P9 -> OUT |= dev_data_ptr->pin_map.memory8[8];
-                   P10-> OUT |= dev_data_ptr->pin_map.memory8[9];
-                   Int_enable();
-                   break;
-               }
-
-               // De otro modo, solo las salidas marcadas.
-               else
-               {
-                   GPIO_PIN_STRUCT _PTR_  pin_table;
-                   uint_32                addr;
-                   uint_8                 pin;
-                   GPIO_PIN_MAP_PTR       temp_pin_map_ptr;
-
-                   if (NULL == (temp_pin_map_ptr = (GPIO_PIN_MAP_PTR) malloc(sizeof(GPIO_PIN_MAP))))
-                       return IO_ERR;
-
-                   Int_disable();
-                   for(i = 0; i < (MAX_PORTS); i++)
-                   {
-                      temp_pin_map_ptr-> memory8[i] = 0;
-                   }
-
-                   // Ya comentado arriba.
-                   for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
-                   {
-                       if (*pin_table & GPIO_PIN_VALID) {
-                           addr = (*pin_table & GPIO_PIN_ADDR) >> 3;
-                           pin = 1 << (*pin_table & 0x07);
-                           if (addr < MAX_PORTS)
-                               if (dev_data_ptr->pin_map.memory8[addr-1] & pin)
-                               {
-                                   temp_pin_map_ptr->memory8[addr-1] |= pin;
-                                   continue;
-                               }
-                       }
-
-                       Int_enable();                        // Renueva interrupciones.
-                       free(temp_pin_map_ptr);
-                       return IO_ERR;
-                   }
-
-                   // Se aplica nuevo mapa.
-
-                   P1 -> OUT |= temp_pin_map_ptr->memory8[0];
-                   P2 -> OUT |= temp_pin_map_ptr->memory8[1];
-                   P3 -> OUT |= temp_pin_map_ptr->memory8[2];
-                   P4 -> OUT |= temp_pin_map_ptr->memory8[3];
-                   P5 -> OUT |= temp_pin_map_ptr->memory8[4];
-                   P6 -> OUT |= temp_pin_map_ptr->memory8[5];
-                   P7 -> OUT |= temp_pin_map_ptr->memory8[6];
-                   P8 -> OUT |= temp_pin_map_ptr->memory8[7];
-                   P9 -> OUT |= temp_pin_map_ptr->memory8[8];
-                   P10-> OUT |= temp_pin_map_ptr->memory8[9];
-
-                   Int_enable();                                // Renueva interrupciones.
-                   free(temp_pin_map_ptr);
-               }
-           }
-           break;
-
-           // Apagar varios o todos los led's (cuando entra de parmetro un NULL) del archivo.
-           case GPIO_IOCTL_WRITE_LOG0:
-           {
-               if (dev_data_ptr->type != DEV_OUTPUT)
-                   return IO_ERR;
-
-
-               if (param_ptr == NULL)                               // Comando al archivo entero.
-               {
-                   Int_disable();
-                   P1 -> OUT &= ~dev_data_ptr->pin_map.memory8[0];
-                   P2 -> OUT &= ~dev_data_ptr->pin_map.memory8[1];
-                   P3 -> OUT &= ~dev_data_ptr->pin_map.memory8[2];
-                   P4 -> OUT &= ~dev_data_ptr->pin_map.memory8[3];
-                   P5 -> OUT &= ~dev_data_ptr->pin_map.memory8[4];
-                   P6 -> OUT &= ~dev_data_ptr->pin_map.memory8[5];
-                   P7 -> OUT &= ~dev_data_ptr->pin_map.memory8[6];
-                   P8 -> OUT &= ~dev_data_ptr->pin_map.memory8[7];
-                   P9 -> OUT &= ~dev_data_ptr->pin_map.memory8[8];
-                   P10 ->OUT &= ~dev_data_ptr->pin_map.memory8[9];
-                   Int_enable();                                    // Renueva interrupciones.
-                   break;
-               }
-
-               // De otro modo, solo los led's marcados.
-               else
-               {
-                   GPIO_PIN_STRUCT _PTR_  pin_table;
-                   uint_32                addr;
-                   uint_8                 pin;
-                   GPIO_PIN_MAP_PTR       temp_pin_map_ptr;
-
-                   if (NULL == (temp_pin_map_ptr = (GPIO_PIN_MAP_PTR) malloc(sizeof(GPIO_PIN_MAP))))
-                       return IO_ERR;
-
-                   for(i = 0; i < (MAX_PORTS); i++)
-                   {
-                      temp_pin_map_ptr-> memory8[i] = 0;
-                   }
-
-                   Int_disable();
-
-                   // Ya comentado arriba.
-                   for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
-                   {
-                       if (*pin_table & GPIO_PIN_VALID)
-                       {
-                           addr = (*pin_table & GPIO_PIN_ADDR) >> 3;
-                           pin = 1 << (*pin_table & 0x07);
-                           if (addr < MAX_PORTS)
-                               if (dev_data_ptr->pin_map.memory8[addr-1] & pin)
-                               {
-                                   temp_pin_map_ptr->memory8[addr-1] |= pin;
-                                   continue;
-                               }
-                       }
-
-                       Int_enable();                            // Renueva interrupciones.
-                       free(temp_pin_map_ptr);
-                       return IO_ERR;
-                   }
-
-                   // Aplicar nuevo mapa.
-
-                   P1 -> OUT &= ~temp_pin_map_ptr->memory8[0];
-                   P2 -> OUT &= ~temp_pin_map_ptr->memory8[1];
-                   P3 -> OUT &= ~temp_pin_map_ptr->memory8[2];
-                   P4 -> OUT &= ~temp_pin_map_ptr->memory8[3];
-                   P5 -> OUT &= ~temp_pin_map_ptr->memory8[4];
-                   P6 -> OUT &= ~temp_pin_map_ptr->memory8[5];
-                   P7 -> OUT &= ~temp_pin_map_ptr->memory8[6];
-                   P8 -> OUT &= ~temp_pin_map_ptr->memory8[7];
-                   P9 -> OUT &= ~temp_pin_map_ptr->memory8[8];
-                   P10-> OUT &= ~temp_pin_map_ptr->memory8[9];
-                   Int_enable();                                // Renueva interrupciones.
-                   free(temp_pin_map_ptr);
-               }
-           }
-           break;
-
-           // Lee el estado de los pines de entrada.
-           case GPIO_IOCTL_READ:
-           {
-               GPIO_PIN_STRUCT _PTR_  pin_table;
-               uint_32                addr;
-               uint_8                 pin;
-               uint_8                 value;
-
-               if (dev_data_ptr->type != DEV_INPUT)
-                   return IO_ERR;
-               if (param_ptr == NULL)                                                   // No hay de donde leer.
-                   return IO_ERR;
-
-               Int_disable();
-
-               // Checar si todos los pines que se demandan leer estn dentro del archivo.
-               for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
-               {
-                 if (*pin_table & GPIO_PIN_VALID)                                       // Checar validacin de pin.
-                   {
-                       addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                        // Puerto.
-                       pin = 1 << (*pin_table & 0x07);                                  // Mscara de bit.
-                       if (addr < MAX_PORTS)                                            // Fuera de rango?
-                           if (dev_data_ptr->pin_map.memory8[addr-1] & pin)
-                           {
-                               switch(addr)
-                               {
-                                   case 1: value = (uint_8)(P1 -> IN) & (pin); break;
-                                   case 2: value = (uint_8)(P2 -> IN) & (pin); break;
-                                   case 3: value = (uint_8)(P3 -> IN) & (pin); break;
-                                   case 4: value = (uint_8)(P4 -> IN) & (pin); break;
-                                   case 5: value = (uint_8)(P5 -> IN) & (pin); break;
-                                   case 6: value = (uint_8)(P6 -> IN) & (pin); break;
-                                   case 7: value = (uint_8)(P7 -> IN) & (pin); break;
-                                   case 8: value = (uint_8)(P8 -> IN) & (pin); break;
-                                   case 9: value = (uint_8)(P9 -> IN) & (pin); break;
-                                   case 10:value = (uint_8)(P10 -> IN)& (pin); break;
-                                   default:value = 0;                          break;
-
-                               }
-
-                               if(value)
-                                   *pin_table |= GPIO_PIN_STATUS;                    // Pone en alto pin_status de la lista.
-                               else
-                                   *pin_table &= ~GPIO_PIN_STATUS;                   // Pone en bajo pin_status de la lista.
-                               continue;
-                           }
-                   }
-                                                                                     // Algn problema ocurri.
-                 Int_enable();
-                   return IO_ERR;
-               }
-               Int_enable();
-           }
-           break;
-
-           // Establece funcin que se activar por todos los pines de todos los puertos con el bit irq_map.memory8[i].
-            case GPIO_IOCTL_SET_IRQ_FUNCTION:
-           {
-               if (dev_data_ptr->type == DEV_OUTPUT)
-                   return IO_ERR;                                             // No hay interrupciones en salidas.
-
-               dev_data_ptr->irq_func = param_ptr;
-
-               Int_disable();
-               if (param_ptr != NULL)
-               {
-                   // Se relacionan todos los puertos involucrados con una sola funcin.
-                   for(i = 0; i < MAX_PORTS; i++)
-                   {
-                       if((dev_data_ptr-> irq_map.memory8[i]) != 0)
-                       {
-                          Int_registerInterrupt(i + INT_PORT1, (void(*)(void)) dev_data_ptr->irq_func);
-                          Int_enableInterrupt(i + INT_PORT1);
-                       }
-                   }
-               }
-               Int_enable();    // Se reanudan las interrupciones.
-
-           }
-           break;
-
-           default:
-               return IO_ERR;
-       }
-
-       return IO_OK;
-}
-
-/*FUNCTION*****************************************************************
-*
-* Function Name    : gpio_close
-* Returned Value   : IO_OK or IO_ERR
-* Comments         :
-*    Cierre de archivo GPIO, con su implicacin en estructuras generales.
-*
-*END*********************************************************************/
-
-_mqx_int gpio_close (FILE _PTR_ fd_ptr)
-{
-    _mqx_int               i;
-    GPIO_DEV_DATA_PTR      dev_data_ptr;
-    FILE_f                 struct_file[1];
-    FILE_PTR_f             struct_file_ptr;
-
-    Int_disable();
-
-    fread(struct_file, sizeof(struct_file),1, fd_ptr);
-    rewind(fd_ptr);
-
-    struct_file_ptr = struct_file;
-    dev_data_ptr = (GPIO_DEV_DATA_PTR) struct_file_ptr -> DEV_DATA_PTR;
-
-    ioctl (fd_ptr, GPIO_IOCTL_SET_IRQ_FUNCTION, NULL); // Retira funcin IRQ.
-
-    // Excluye pines del mapeo global.
-    for (i = 0; i < MAX_PORTS; i++)
-    {
-        gpio_global_pin_map.memory8[i] &= ~dev_data_ptr->pin_map.memory8[i];
-        gpio_global_irq_map.memory8[i] &= ~dev_data_ptr->irq_map.memory8[i];
-    }
-
-    Int_enable();
-
-    free(fd_ptr);
-
-    return IO_OK;
-}
-
-/*FUNCTION*****************************************************************
-*
-* Function Name    : gpio_read
-* Returned Value   : IO_OK or IO_ERR
-* Comments         :
-*    No hay definicin de esta funcin, GPIO se controla por IOCTL.
-*
-*END*********************************************************************/
-
-_mqx_int gpio_read  (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num)
-{
-    // No hay definicin de gpio_read. Solo el adc y el timer tiene definicin de esta funcin.
-    return 0;
-}
+ //FileName:        gpio_f_MSP432.c
+ //Dependencies:    system.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Driver para GPIO por medio de archivos. Source File.
+ //Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         12/2018
+
+#include "HVAC.h"
+
+GPIO_PIN_MAP gpio_global_pin_map = {.memory8[0] = 0, .memory8[1] = 0, .memory8[2] = 0,
+                                    .memory8[3] = 0, .memory8[4] = 0, .memory8[5] = 0},
+            gpio_global_irq_map =  {.memory8[0] = 0, .memory8[1] = 0, .memory8[2] = 0,
+                                    .memory8[3] = 0, .memory8[4] = 0, .memory8[5] = 0};
+
+/* Puertos (bit 0 -> P1) cuyo PxIE manejan Int_disable/Int_enable. */
+uint_32 gpio_irq_ports = 0;
+
+/* Dirección base de cada puerto (P1..P10, PJ); los registros se alcanzan con OFS_PAxxx. */
+const uint32_t GPIO_PORT_ADDR[GPIO_HW_PORTS] =
+{
+    0x40004C00, 0x40004C01,     // P1, P2.
+    0x40004C20, 0x40004C21,     // P3, P4.
+    0x40004C40, 0x40004C41,     // P5, P6.
+    0x40004C60, 0x40004C61,     // P7, P8.
+    0x40004C80, 0x40004C81,     // P9, P10.
+    0x40004D20                  // PJ.
+};
+
+/* Archivos con antirrebote activo (los recorre el tick del timer32_2). */
+static GPIO_DEBOUNCE_PTR gpio_debounce_list = NULL;
+
+/* uS del tick que aún no completan un paso de STEP (el tick de "timer:" puede ser otro). */
+static uint_32 gpio_debounce_rem = 0;
+
+/* Archivos con cola de eventos y pines de P1..P6 que atiende gpio_port_isr. */
+static GPIO_QUEUE_PTR gpio_queue_list = NULL;
+static uint_8         gpio_queue_irq_map [GPIO_IRQ_PORTS] = {0};
+
+/* Contador para pines fuera del orden de apertura (más de 32 pines). */
+static uint_32        gpio_changes_untracked = 0;
+
+/* Lectura de un puerto: PxIN, o la última captura del expansor. */
+static uint_8 gpio_port_in (uint_32 port)
+{
+    if (port >= GPIO_HW_PORTS)
+        return gpio_exp_read(port);
+    return GPIO_PORT_REG(port, OFS_PAIN);
+}
+
+/* Estado de salida de un puerto: PxOUT, o la imagen del expansor. */
+static uint_8 gpio_port_out (uint_32 port)
+{
+    if (port >= GPIO_HW_PORTS)
+        return gpio_exp_output(port);
+    return GPIO_PORT_REG(port, OFS_PAOUT);
+}
+
+/* Los puertos del expansor tienen dirección fija: 595 solo salida, 165 solo entrada. */
+static boolean gpio_port_fits (uint_32 type, uint_32 port)
+{
+    if ((port >= GPIO_EXP_OUT_FIRST) && (port < GPIO_EXP_IN_FIRST))
+        return type == DEV_OUTPUT;
+    if (port >= GPIO_EXP_IN_FIRST)
+        return type == DEV_INPUT;
+    return TRUE;
+}
+
+/* Contador de cambios de un pin (o el común, si quedó fuera del orden de apertura). */
+static uint_32_ptr gpio_pin_counter (GPIO_DEV_DATA_PTR dev_data_ptr, uint_32 port, uint_8 pin)
+{
+    uint_32 i;
+
+    for (i = 0; i < dev_data_ptr->pin_count; i++)
+        if ((dev_data_ptr->pin_port[i] == port) && (dev_data_ptr->pin_mask[i] == pin))
+            return &dev_data_ptr->changes[i];
+    return &gpio_changes_untracked;
+}
+
+/* Agrega un pin al orden del archivo (para GPIO_IOCTL_READ_MASK) y marca su puerto. */
+static void gpio_order_add (GPIO_DEV_DATA_PTR dev_data_ptr, uint_32 port, uint_8 pin)
+{
+    dev_data_ptr->ports |= 1 << port;
+
+    if (dev_data_ptr->pin_count < GPIO_MAX_MASK_PINS)
+    {
+        dev_data_ptr->pin_port[dev_data_ptr->pin_count] = port;
+        dev_data_ptr->pin_mask[dev_data_ptr->pin_count] = pin;
+        dev_data_ptr->pin_count++;
+    }
+}
+
+/*FUNCTION***************************************************************************
+*
+* Function Name    : gpio_open
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Prepara los archivos para su uso. Reservación de memoria y llenado de formatos.
+*
+*END********************************************************************************/
+
+_mqx_int gpio_open  (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags)
+{
+    _mqx_int            i;
+    uint_8              pin;
+    uint_32             addr;
+
+    GPIO_DEV_DATA_PTR   dev_data_ptr;
+    GPIO_PIN_STRUCT _PTR_ pin_table = (GPIO_PIN_STRUCT _PTR_) flags;
+
+    if (NULL == (dev_data_ptr = (GPIO_DEV_DATA_PTR) malloc(sizeof(GPIO_DEV_DATA)))) // Reservación de memoria de datos.
+        return ERR_FUNC;
+
+    // Inicialización en cero's.
+    dev_data_ptr -> irq_func = 0;
+    for(i = 0; i < (MAX_PORTS); i++)
+    {
+       dev_data_ptr-> pin_map.memory8 [i] = 0;
+       dev_data_ptr-> irq_map.memory8[i] = 0;
+       dev_data_ptr-> irq_edge_map.memory8[i] = 0;
+    }
+    dev_data_ptr -> type = 0;
+    dev_data_ptr -> ports = 0;
+    dev_data_ptr -> pin_count = 0;
+    dev_data_ptr -> debounce = NULL;
+    dev_data_ptr -> queue = NULL;
+    for (i = 0; i < GPIO_MAX_MASK_PINS; i++)
+        dev_data_ptr -> changes[i] = 0;
+
+
+    fd_ptr -> DEV_DATA_PTR = (pointer) dev_data_ptr;    // Esta información, para GPIO se guarda en el apuntador vacío del disp.
+
+    // Pines del expansor: el bus se levanta antes de reservar nada.
+    for (; *pin_table != GPIO_LIST_END; pin_table++)
+        if ((((*pin_table & GPIO_PIN_ADDR) >> 3) > GPIO_HW_PORTS) && (((*pin_table & GPIO_PIN_ADDR) >> 3) <= MAX_PORTS))
+        {
+            if (IO_OK != gpio_exp_init())
+            {
+                free(dev_data_ptr);
+                return IO_ERR;
+            }
+            break;
+        }
+    pin_table = (GPIO_PIN_STRUCT _PTR_) flags;
+
+    /* Checar puertos y pines. */
+
+    Int_disable();                                                          // Conviene desactivar interrupciones.
+    for (; *pin_table != GPIO_LIST_END; pin_table++)
+    {
+        if (*pin_table & GPIO_PIN_VALID)                                    // Valida pin.
+        {
+            addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                       // Encuentra puerto.
+            pin = 1 << (*pin_table & 0x07);                                 // Prepara mascara de bit.
+
+            if (addr > 0 && addr <= MAX_PORTS)                              // Valida puerto.
+                if (! (gpio_global_pin_map.memory8[addr-1] & pin))          // El pin es usado ya en otro archivo?
+                {
+                    if (*pin_table & GPIO_PIN_IRQ)
+                    {
+                        if ((addr <= GPIO_IRQ_PORTS) && !(gpio_global_irq_map.memory8[addr-1] & pin))
+                        {                                                       // Con o sin función de interrupción.
+                            dev_data_ptr->irq_map.memory8[addr-1] |= pin;       // Marca pin para uso en interrupción.
+                            dev_data_ptr->pin_map.memory8[addr-1] |= pin;
+
+                            if(*pin_table & GPIO_IRQ_EDGE_H_TO_L)               // Ante interrupción, modo de flanco.
+                                dev_data_ptr->irq_edge_map.memory8[addr-1]|= pin;
+                            gpio_order_add(dev_data_ptr, addr-1, pin);
+                            continue;
+                        }
+                    }
+                    else
+                    {
+                        dev_data_ptr->pin_map.memory8[addr-1] |= pin;       // Solo marca pin, sin interrupción.
+                        gpio_order_add(dev_data_ptr, addr-1, pin);
+                        continue;
+                    }
+                }
+        }
+
+        free(dev_data_ptr); // Libera memoria temporal al haber procedimiento incorrecto.
+        Int_enable();       // Reanudación de interrupciones.
+        return IO_ERR;
+    }
+
+    if (IO_OK != gpio_cpu_open(fd_ptr, open_name_ptr, flags))   // Configura realmente pines en HW.
+    {
+            free(dev_data_ptr);
+            Int_enable();
+            return IO_ERR;
+    }
+
+    /* Ahora se llena el uso de bits pero en la estructura general. */
+    for (i = 0; i < MAX_PORTS; i++)
+    {
+        if (!(dev_data_ptr->ports & (1 << i)))
+            continue;
+
+        dev_data_ptr->shadow[i] = gpio_port_out(i) & dev_data_ptr->pin_map.memory8[i];
+        gpio_global_pin_map.memory8[i] |= dev_data_ptr->pin_map.memory8[i];
+        gpio_global_irq_map.memory8[i] |= dev_data_ptr->irq_map.memory8[i];
+        if (dev_data_ptr->irq_map.memory8[i])
+            gpio_irq_ports |= 1 << i;
+    }
+
+    Int_enable();       // Reanudación de interrupciones.
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_cpu_open
+* Returned Value   : IO_OK or error
+* Comments         :
+*    Implementa la verdadera inicialización en HW del GPIO.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_cpu_open (FILE_PTR_f fd_ptr, char_ptr file_name, char_ptr param_ptr)
+{
+   _mqx_int          i;
+   GPIO_DEV_DATA_PTR dev_data_ptr = (GPIO_DEV_DATA_PTR) fd_ptr->DEV_DATA_PTR;
+
+
+   GPIO_PIN_STRUCT _PTR_   pin_table;
+   uint_32                 addr;
+   uint_8                  pin;
+   uint_8                  initial [MAX_PORTS];
+
+   /* Determina accesso de GPIO (I o O). */
+    if ((file_name != NULL) && (*file_name != 0))
+    {
+        if (!strncmp(file_name, "gpio:write", 11))
+            dev_data_ptr->type = DEV_OUTPUT;
+        else if (!strncmp(file_name, "gpio:output", 12))
+            dev_data_ptr->type = DEV_OUTPUT;
+        else if (!strncmp(file_name, "gpio:read", 10))
+            dev_data_ptr->type = DEV_INPUT;
+        else if (!strncmp(file_name, "gpio:input", 11))
+            dev_data_ptr->type = DEV_INPUT;
+        else
+            return IO_ERR;                                  /* Error. */
+    }
+    else
+            return IO_ERR;                                  /* Error. */
+
+    for (i = 0; i < MAX_PORTS; i++)                     // Dirección fija de los puertos del expansor.
+        if ((dev_data_ptr->ports & (1 << i)) && !gpio_port_fits(dev_data_ptr->type, i))
+            return IO_ERR;
+
+    if (dev_data_ptr->type == DEV_OUTPUT)               // Tipo salida.
+    {
+        // Salida inicial según la lista (solo los pines del archivo).
+        for (i = 0; i < MAX_PORTS; i++)
+            initial[i] = 0;
+
+        if (param_ptr != NULL)
+            for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
+            {
+                addr = (*pin_table & GPIO_PIN_ADDR) >> 3;           /* Puerto. */
+                pin = 1 << (*pin_table & 0x07);                     /* Máscara de bit. */
+                if (*pin_table & GPIO_PIN_STATUS)
+                    initial[addr-1] |= pin;
+            }
+
+        for (i = 0; i < MAX_PORTS; i++)
+        {
+            if (!(dev_data_ptr->ports & (1 << i)))
+                continue;
+
+            if (i >= GPIO_HW_PORTS)                                                 // Expansor: sale en la siguiente actualización.
+            {
+                gpio_exp_write(i, dev_data_ptr->pin_map.memory8[i] & ~initial[i], FALSE);
+                gpio_exp_write(i, initial[i], TRUE);
+                continue;
+            }
+
+            GPIO_PORT_REG(i, OFS_PAOUT) = (GPIO_PORT_REG(i, OFS_PAOUT) & ~dev_data_ptr->pin_map.memory8[i]) | initial[i];
+            GPIO_PORT_REG(i, OFS_PADIR) |= dev_data_ptr->pin_map.memory8[i];
+        }
+    }
+
+    else                                                // Tipo entrada.
+    {
+        for (i = 0; i < GPIO_HW_PORTS; i++)                                         // Las entradas del expansor no se configuran.
+        {
+            if (!(dev_data_ptr->ports & (1 << i)))
+                continue;
+
+            GPIO_PORT_REG(i, OFS_PADIR) &= ~dev_data_ptr->pin_map.memory8[i];
+            GPIO_PORT_REG(i, OFS_PAREN) |=  dev_data_ptr->pin_map.memory8[i];   // Habilitar resistencias de pull-up.
+            GPIO_PORT_REG(i, OFS_PAOUT) |=  dev_data_ptr->pin_map.memory8[i];   // Esto es necesario en algunas tarjetas...
+
+            if (i < GPIO_IRQ_PORTS)                                             // Solo P1..P6 tienen interrupción.
+            {
+                GPIO_PORT_REG(i, OFS_PAIES) = (GPIO_PORT_REG(i, OFS_PAIES) & ~dev_data_ptr->irq_map.memory8[i])
+                                              | dev_data_ptr->irq_edge_map.memory8[i];
+                GPIO_PORT_REG(i, OFS_PAIFG) &= ~dev_data_ptr->pin_map.memory8[i];  // Elimina alguna posible bandera.
+            }
+        }
+    }
+
+    return IO_OK;
+
+}
+
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_cpu_ioctl
+* Returned Value   : depends on IOCTL command
+* Comments         :
+*    Implementa funciones de control para el GPIO.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
+{
+    _mqx_int            i;
+    GPIO_DEV_DATA_PTR  dev_data_ptr = (GPIO_DEV_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
+
+       switch (cmd)
+       {
+
+           case GPIO_IOCTL_ADD_PINS:
+           {
+               // Agregar pines al archivo.
+               GPIO_PIN_STRUCT _PTR_  pin_table;
+               uint_32        addr;
+               uint_8         pin;
+
+               // Checar si no son usados ya por otro puerto.
+               Int_disable();
+               for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
+               {
+                   if (*pin_table & GPIO_PIN_VALID)                                            // Validación bit.
+                   {
+                       addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                               // Puerto.
+                       pin = 1 << (*pin_table & 0x07);                                         // Máscara de bit.
+                       if ((addr > 0) && (addr <= MAX_PORTS) && gpio_port_fits(dev_data_ptr->type, addr-1))
+                           if (!(gpio_global_pin_map.memory8[addr-1] & pin))                   // Chequeo.
+                               continue;                                                       // Siguiente chequeo de pin.
+                   }                                                                           // Algún problema ocurrió.
+                   Int_enable();
+                   return IO_ERR;
+               }
+
+               // Chequeo correcto, se procede a agregar los pines.
+               for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
+               {
+                   addr = (*pin_table & GPIO_PIN_ADDR)  >> 3;                                   // Puerto.
+                   pin = 1 << (*pin_table & 0x07);                                              // Máscara de bit.
+                   dev_data_ptr->pin_map.memory8[addr-1] |= pin;                                // Validación puerto.
+                   gpio_global_pin_map.memory8[addr-1] |= pin;                                  // Marcar pin como global.
+                   gpio_order_add(dev_data_ptr, addr-1, pin);                                   // Siguiente bit de la máscara.
+               }
+
+               for (i = 0; i < MAX_PORTS; i++)
+               {
+                   if (!(dev_data_ptr->ports & (1 << i)))
+                       continue;
+
+                   if (i >= GPIO_HW_PORTS)                                                      // Expansor: dirección fija.
+                   {
+                       dev_data_ptr->shadow[i] = gpio_port_out(i) & dev_data_ptr->pin_map.memory8[i];
+                       continue;
+                   }
+
+                   if (dev_data_ptr->type == DEV_OUTPUT)                                        // Tipo salida.
+                   {
+                       GPIO_PORT_REG(i, OFS_PADIR) |= dev_data_ptr->pin_map.memory8[i];
+                       dev_data_ptr->shadow[i] = GPIO_PORT_REG(i, OFS_PAOUT) & dev_data_ptr->pin_map.memory8[i];
+                   }
+                   else                                                                         // Tipo entrada.
+                   {
+                       GPIO_PORT_REG(i, OFS_PADIR) &= ~dev_data_ptr->pin_map.memory8[i];
+                       GPIO_PORT_REG(i, OFS_PAREN) |=  dev_data_ptr->pin_map.memory8[i];        // Habilitar resistencias de pull-up.
+                       GPIO_PORT_REG(i, OFS_PAOUT) |=  dev_data_ptr->pin_map.memory8[i];        // Esto es necesario en algunas tarjetas ...
+                   }
+               }
+
+              Int_enable();                                         // Renueva interrupciones.
+           }
+           break;
+
+           // Poner en alto varias o todos las salidas (cuando entra de parámetro un NULL) del archivo.
+           case GPIO_IOCTL_WRITE_LOG1:
+           {
+
+               if (dev_data_ptr->type != DEV_OUTPUT)
+                   return IO_ERR;
+               if (param_ptr == NULL)                               // Comando al archivo entero.
+               {
+                   GPIO_PIN_SET           set;
+
+                   gpio_set_all(dev_data_ptr, &set);
+                   gpio_set_apply(&set, TRUE);
+                   break;
+               }
+
+               // De otro modo, solo las salidas marcadas.
+               else
+               {
+                   GPIO_PIN_SET           set;                  // Conjunto temporal en la pila.
+
+                   set.list = (const GPIO_PIN_STRUCT _PTR_) param_ptr;
+                   if (IO_OK != gpio_set_compile(dev_data_ptr, &set))
+                       return IO_ERR;
+
+                   gpio_set_apply(&set, TRUE);                  // Solo los puertos involucrados.
+               }
+           }
+           break;
+
+           // Apagar varios o todos los led's (cuando entra de parámetro un NULL) del archivo.
+           case GPIO_IOCTL_WRITE_LOG0:
+           {
+               if (dev_data_ptr->type != DEV_OUTPUT)
+                   return IO_ERR;
+
+
+               if (param_ptr == NULL)                               // Comando al archivo entero.
+               {
+                   GPIO_PIN_SET           set;
+
+                   gpio_set_all(dev_data_ptr, &set);
+                   gpio_set_apply(&set, FALSE);
+                   break;
+               }
+
+               // De otro modo, solo los led's marcados.
+               else
+               {
+                   GPIO_PIN_SET           set;                  // Conjunto temporal en la pila.
+
+                   set.list = (const GPIO_PIN_STRUCT _PTR_) param_ptr;
+                   if (IO_OK != gpio_set_compile(dev_data_ptr, &set))
+                       return IO_ERR;
+
+                   gpio_set_apply(&set, FALSE);                  // Solo los puertos involucrados.
+               }
+           }
+           break;
+
+           // Lee el estado de los pines de entrada.
+           case GPIO_IOCTL_READ:
+           {
+               GPIO_PIN_STRUCT _PTR_  pin_table;
+               uint_32                addr;
+               uint_8                 pin;
+               uint_8                 value;
+
+               if (dev_data_ptr->type != DEV_INPUT)
+                   return IO_ERR;
+               if (param_ptr == NULL)                                                   // No hay de donde leer.
+                   return IO_ERR;
+
+               Int_disable();
+
+               // Checar si todos los pines que se demandan leer están dentro del archivo.
+               for (pin_table = (GPIO_PIN_STRUCT _PTR_) param_ptr; *pin_table != GPIO_LIST_END; pin_table++)
+               {
+                 if (*pin_table & GPIO_PIN_VALID)                                       // Checar validación de pin.
+                   {
+                       addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                        // Puerto.
+                       pin = 1 << (*pin_table & 0x07);                                  // Máscara de bit.
+                       if ((addr > 0) && (addr <= MAX_PORTS))                           // Fuera de rango?
+                           if (dev_data_ptr->pin_map.memory8[addr-1] & pin)
+                           {
+                               value = gpio_port_in(addr-1) & pin;
+
+                               if(value)
+                                   *pin_table |= GPIO_PIN_STATUS;                    // Pone en alto pin_status de la lista.
+                               else
+                                   *pin_table &= ~GPIO_PIN_STATUS;                   // Pone en bajo pin_status de la lista.
+                               continue;
+                           }
+                   }
+                                                                                     // Algún problema ocurrió.
+                 Int_enable();
+                   return IO_ERR;
+               }
+               Int_enable();
+           }
+           break;
+
+           // Establece función que se activará por todos los pines de todos los puertos con el bit irq_map.memory8[i].
+            case GPIO_IOCTL_SET_IRQ_FUNCTION:
+           {
+               if (dev_data_ptr->type == DEV_OUTPUT)
+                   return IO_ERR;                                             // No hay interrupciones en salidas.
+
+               dev_data_ptr->irq_func = param_ptr;
+
+               Int_disable();
+               if (param_ptr != NULL)
+               {
+                   // Se relacionan todos los puertos involucrados con una sola función.
+                   for(i = 0; i < GPIO_IRQ_PORTS; i++)
+                   {
+                       if((dev_data_ptr-> irq_map.memory8[i]) != 0)
+                       {
+                          Int_registerInterrupt(i + INT_PORT1, (void(*)(void)) dev_data_ptr->irq_func);
+                          Int_enableInterrupt(i + INT_PORT1);
+                       }
+                   }
+               }
+               Int_enable();    // Se reanudan las interrupciones.
+
+           }
+           break;
+
+           // Compila una lista de pines del archivo a un conjunto (puerto, máscara).
+           case GPIO_IOCTL_COMPILE_SET:
+               if (param_ptr == NULL)
+                   return IO_ERR;
+               return gpio_set_compile(dev_data_ptr, (GPIO_PIN_SET_PTR) param_ptr);
+
+           // Escritura de un conjunto compilado por este mismo archivo.
+           case GPIO_IOCTL_SET_LOG1:
+           case GPIO_IOCTL_SET_LOG0:
+           {
+               GPIO_PIN_SET_PTR set = (GPIO_PIN_SET_PTR) param_ptr;
+
+               if ((set == NULL) || (set->owner != dev_data_ptr) || (dev_data_ptr->type != DEV_OUTPUT))
+                   return IO_ERR;
+
+               gpio_set_apply(set, cmd == GPIO_IOCTL_SET_LOG1);
+           }
+           break;
+
+           // Operaciones de un solo pin por bit-band (sin desactivar interrupciones).
+           case GPIO_IOCTL_PIN_LOG1:
+           case GPIO_IOCTL_PIN_LOG0:
+           case GPIO_IOCTL_PIN_TOGGLE:
+           case GPIO_IOCTL_PIN_READ:
+           {
+               GPIO_PIN_HANDLE handle;
+
+               if (param_ptr == NULL)
+                   return IO_ERR;
+
+               handle.pin = *(GPIO_PIN_STRUCT _PTR_) param_ptr;
+               if (IO_OK != gpio_pin_prepare(dev_data_ptr, &handle))
+                   return IO_ERR;
+
+               if (cmd == GPIO_IOCTL_PIN_READ)
+               {
+                   if (gpio_pin_read(&handle))
+                       *(GPIO_PIN_STRUCT _PTR_) param_ptr |= GPIO_PIN_STATUS;
+                   else
+                       *(GPIO_PIN_STRUCT _PTR_) param_ptr &= ~GPIO_PIN_STATUS;
+                   break;
+               }
+
+               if (dev_data_ptr->type != DEV_OUTPUT)
+                   return IO_ERR;
+
+               if (cmd == GPIO_IOCTL_PIN_LOG1)
+                   gpio_pin_log1(&handle);
+               else if (cmd == GPIO_IOCTL_PIN_LOG0)
+                   gpio_pin_log0(&handle);
+               else
+                   gpio_pin_toggle(&handle);
+           }
+           break;
+
+           // Lee todos los pines del archivo: una lectura por puerto involucrado.
+           case GPIO_IOCTL_READ_MASK:
+               if (param_ptr == NULL)
+                   return IO_ERR;
+               *(uint_32_ptr) param_ptr = gpio_read_mask(dev_data_ptr);
+               break;
+
+           // Activa el antirrebote de los pines indicados.
+           case GPIO_IOCTL_DEBOUNCE:
+               if ((param_ptr == NULL) || (dev_data_ptr->type != DEV_INPUT))
+                   return IO_ERR;
+               return gpio_debounce_open(dev_data_ptr, (GPIO_DEBOUNCE_INIT_STRUCT_PTR) param_ptr);
+
+           // Entrega estado filtrado y eventos; los eventos se limpian al leerse.
+           case GPIO_IOCTL_GET_EVENTS:
+           {
+               GPIO_DEBOUNCE_PTR db = (GPIO_DEBOUNCE_PTR) dev_data_ptr->debounce;
+
+               if ((param_ptr == NULL) || (db == NULL))
+                   return IO_ERR;
+
+               Int_disable();
+               *(GPIO_DEBOUNCE_EVENTS_PTR) param_ptr = db->events;
+               db->events.press      = 0;
+               db->events.release    = 0;
+               db->events.long_press = 0;
+               Int_enable();
+           }
+           break;
+
+           // Pasa los pines indicados a interrupción con cola de eventos.
+           case GPIO_IOCTL_EVENT_QUEUE:
+               if ((param_ptr == NULL) || (dev_data_ptr->type != DEV_INPUT))
+                   return IO_ERR;
+               return gpio_queue_open(dev_data_ptr, (GPIO_QUEUE_INIT_STRUCT_PTR) param_ptr);
+
+           // Registros pendientes y perdidos de la cola.
+           case GPIO_IOCTL_QUEUE_STATUS:
+           {
+               GPIO_QUEUE_PTR q = (GPIO_QUEUE_PTR) dev_data_ptr->queue;
+
+               if ((param_ptr == NULL) || (q == NULL))
+                   return IO_ERR;
+
+               Int_disable();
+               ((GPIO_QUEUE_STATUS_PTR) param_ptr)->pending = q->count;
+               ((GPIO_QUEUE_STATUS_PTR) param_ptr)->lost    = q->lost;
+               Int_enable();
+           }
+           break;
+
+           // Cambios acumulados de un pin de salida (ej. desgaste de un relevador).
+           case GPIO_IOCTL_PIN_CHANGES:
+           {
+               GPIO_PIN_CHANGES_PTR query = (GPIO_PIN_CHANGES_PTR) param_ptr;
+               uint_32              addr;
+               uint_8               pin;
+
+               if ((query == NULL) || !(query->pin & GPIO_PIN_VALID))
+                   return IO_ERR;
+
+               addr = (query->pin & GPIO_PIN_ADDR) >> 3;
+               pin  = 1 << (query->pin & 0x07);
+               if ((addr == 0) || (addr > MAX_PORTS) || !(dev_data_ptr->pin_map.memory8[addr-1] & pin))
+                   return IO_ERR;
+
+               query->changes = *gpio_pin_counter(dev_data_ptr, addr-1, pin);
+           }
+           break;
+
+           // Prepara un pin para acceso directo.
+           case GPIO_IOCTL_PIN_HANDLE:
+               if (param_ptr == NULL)
+                   return IO_ERR;
+               return gpio_pin_prepare(dev_data_ptr, (GPIO_PIN_HANDLE_PTR) param_ptr);
+
+           default:
+               return IO_ERR;
+       }
+
+       return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_close
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Cierre de archivo GPIO, con su implicación en estructuras generales.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_close (FILE _PTR_ fd_ptr)
+{
+    _mqx_int               i;
+    GPIO_DEV_DATA_PTR      dev_data_ptr;
+    FILE_f                 struct_file[1];
+    FILE_PTR_f             struct_file_ptr;
+
+    Int_disable();
+
+    fread(struct_file, sizeof(struct_file),1, fd_ptr);
+    rewind(fd_ptr);
+
+    struct_file_ptr = struct_file;
+    dev_data_ptr = (GPIO_DEV_DATA_PTR) struct_file_ptr -> DEV_DATA_PTR;
+
+    ioctl (fd_ptr, GPIO_IOCTL_SET_IRQ_FUNCTION, NULL); // Retira función IRQ.
+    gpio_debounce_close(dev_data_ptr);                 // Retira antirrebote (si lo hay).
+    gpio_queue_close(dev_data_ptr);                    // Retira cola de eventos (si la hay).
+
+    // Excluye pines del mapeo global.
+    for (i = 0; i < MAX_PORTS; i++)
+    {
+        gpio_global_pin_map.memory8[i] &= ~dev_data_ptr->pin_map.memory8[i];
+        gpio_global_irq_map.memory8[i] &= ~dev_data_ptr->irq_map.memory8[i];
+    }
+
+    Int_enable();
+
+    free(fd_ptr);
+
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_read
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Lee registros GPIO_EVENT de la cola del archivo (GPIO_IOCTL_EVENT_QUEUE).
+*    Bloquea hasta que haya al menos uno o venza 'timeout_ms'; después copia
+*    los que quepan en 'num' bytes. Si sobra lugar, el siguiente registro se
+*    marca con GPIO_EVENT_NONE. Sin cola, GPIO se controla por IOCTL.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_read  (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num)
+{
+    GPIO_DEV_DATA_PTR  dev_data_ptr = (GPIO_DEV_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
+    GPIO_QUEUE_PTR     q = (GPIO_QUEUE_PTR) dev_data_ptr->queue;
+    GPIO_EVENT_PTR     event = (GPIO_EVENT_PTR) data_ptr;
+    struct timespec    limit;
+    _mqx_int           max, n, i;
+
+    max = num / sizeof(GPIO_EVENT);
+    if ((q == NULL) || (event == NULL) || (max <= 0))
+        return IO_ERR;
+
+    // Espera el primer registro; el hilo no ocupa CPU mientras tanto.
+    if (q->timeout_ms == 0)
+        sem_wait(&q->sem);
+    else
+    {
+        clock_gettime(CLOCK_REALTIME, &limit);
+        limit.tv_sec  += q->timeout_ms / 1000;
+        limit.tv_nsec += (q->timeout_ms % 1000) * 1000000;
+        if (limit.tv_nsec >= 1000000000)
+        {
+            limit.tv_sec++;
+            limit.tv_nsec -= 1000000000;
+        }
+        if (sem_timedwait(&q->sem, &limit) != 0)
+            return IO_ERR;                                      // Sin eventos en el tiempo dado.
+    }
+
+    Int_disable();
+    for (n = 0; (n < max) && (q->count > 0); n++)
+    {
+        event[n] = q->buffer[q->tail];
+        if (++q->tail == q->size)
+            q->tail = 0;
+        q->count--;
+    }
+    Int_enable();
+
+    for (i = 1; i < n; i++)                                     // Descuenta los registros extra ya publicados.
+        sem_trywait(&q->sem);
+
+    if (n < max)
+        event[n].edge = GPIO_EVENT_NONE;
+
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_set_compile
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Valida la lista 'set->list' contra los pines del archivo y la agrupa
+*    en pares (puerto, máscara). Se hace una sola vez por lista.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_set_compile (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_PIN_SET_PTR set)
+{
+    const GPIO_PIN_STRUCT _PTR_ pin_table;
+    uint_32                     addr, i;
+    uint_8                      pin;
+
+    set->owner = NULL;
+    set->count = 0;
+
+    if (set->list == NULL)
+        return IO_ERR;
+
+    for (pin_table = set->list; *pin_table != GPIO_LIST_END; pin_table++)
+    {
+        if (!(*pin_table & GPIO_PIN_VALID))                                 // Validación bit.
+            return IO_ERR;
+
+        addr = (*pin_table & GPIO_PIN_ADDR) >> 3;                           // Puerto.
+        pin = 1 << (*pin_table & 0x07);                                     // Máscara de bit.
+
+        if ((addr == 0) || (addr > MAX_PORTS))                              // Fuera de rango.
+            return IO_ERR;
+        if (!(dev_data_ptr->pin_map.memory8[addr-1] & pin))                 // El pin no es de este archivo.
+            return IO_ERR;
+
+        for (i = 0; (i < set->count) && (set->port[i] != addr - 1); i++);  // Busca el puerto en el conjunto.
+        if (i == set->count)
+        {
+            set->port[i] = addr - 1;
+            set->mask[i] = 0;
+            set->count++;
+        }
+        set->mask[i] |= pin;
+    }
+
+    set->owner = (pointer) dev_data_ptr;
+    return IO_OK;
+}
+
+/* Suma un cambio a cada pin del archivo que cambió en el puerto 'port'. */
+static void gpio_count_changes (GPIO_DEV_DATA_PTR dev_data_ptr, uint_32 port, uint_8 diff)
+{
+    uint_32 i;
+
+    for (i = 0; i < dev_data_ptr->pin_count; i++)
+        if ((dev_data_ptr->pin_port[i] == port) && (dev_data_ptr->pin_mask[i] & diff))
+            dev_data_ptr->changes[i]++;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_set_all
+* Returned Value   : None.
+* Comments         :
+*    Arma (sin lista) un conjunto con todos los pines del archivo.
+*
+*END*********************************************************************/
+
+void gpio_set_all (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_PIN_SET_PTR set)
+{
+    uint_32 i;
+
+    set->list  = NULL;
+    set->count = 0;
+    for (i = 0; i < MAX_PORTS; i++)
+        if (dev_data_ptr->ports & (1 << i))
+        {
+            set->port[set->count] = i;
+            set->mask[set->count] = dev_data_ptr->pin_map.memory8[i];
+            set->count++;
+        }
+    set->owner = (pointer) dev_data_ptr;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_set_apply
+* Returned Value   : None.
+* Comments         :
+*    Escribe un conjunto compilado. Primero compara contra la sombra del
+*    archivo: si ningún pin cambia, regresa sin desactivar interrupciones.
+*    Si hay cambios, una lectura-modificación-escritura por puerto que
+*    cambió y nada más.
+*
+*END*********************************************************************/
+
+void gpio_set_apply (GPIO_PIN_SET_PTR set, boolean level)
+{
+    GPIO_DEV_DATA_PTR dev_data_ptr = (GPIO_DEV_DATA_PTR) set->owner;
+    uint_32           i;
+    uint_8            port, diff;
+
+    for (i = 0; i < set->count; i++)                                    // Algo cambia?
+    {
+        port = set->port[i];
+        if ((level ? ~dev_data_ptr->shadow[port] : dev_data_ptr->shadow[port]) & set->mask[i])
+            break;
+    }
+    if (i == set->count)
+        return;                                                         // Mismo estado: nada que escribir.
+
+    Int_disable();
+    for (; i < set->count; i++)
+    {
+        port = set->port[i];
+        diff = (level ? ~dev_data_ptr->shadow[port] : dev_data_ptr->shadow[port]) & set->mask[i];
+        if (!diff)
+            continue;
+
+        if (port >= GPIO_HW_PORTS)                                      // Expansor: se junta con los demás
+            gpio_exp_write(port, diff, level);                          // cambios en una sola transacción.
+        else if (level)
+            GPIO_PORT_REG(port, OFS_PAOUT) |=  diff;
+        else
+            GPIO_PORT_REG(port, OFS_PAOUT) &= ~diff;
+        dev_data_ptr->shadow[port] ^= diff;
+        gpio_count_changes(dev_data_ptr, port, diff);
+    }
+    Int_enable();
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_set_log1 / gpio_set_log0
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Acceso directo a un conjunto ya compilado, sin copiar el archivo
+*    como lo hace ioctl(). Solo aplica a archivos de salida.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_set_log1 (GPIO_PIN_SET_PTR set)
+{
+    if ((set == NULL) || (set->owner == NULL) || (((GPIO_DEV_DATA_PTR) set->owner)->type != DEV_OUTPUT))
+        return IO_ERR;
+
+    gpio_set_apply(set, TRUE);
+    return IO_OK;
+}
+
+_mqx_int gpio_set_log0 (GPIO_PIN_SET_PTR set)
+{
+    if ((set == NULL) || (set->owner == NULL) || (((GPIO_DEV_DATA_PTR) set->owner)->type != DEV_OUTPUT))
+        return IO_ERR;
+
+    gpio_set_apply(set, FALSE);
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_pin_prepare
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Valida 'handle->pin' contra los pines del archivo y calcula los
+*    alias bit-band de su bit en PxOUT y PxIN.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_pin_prepare (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_PIN_HANDLE_PTR handle)
+{
+    uint_32 addr, bit;
+
+    handle->owner = NULL;
+
+    if (!(handle->pin & GPIO_PIN_VALID))                                    // Validación bit.
+        return IO_ERR;
+
+    addr = (handle->pin & GPIO_PIN_ADDR) >> 3;                              // Puerto.
+    bit = handle->pin & 0x07;                                               // Número de bit.
+
+    if ((addr == 0) || (addr > GPIO_HW_PORTS))                              // El expansor no tiene bit-band.
+        return IO_ERR;
+    if (!(dev_data_ptr->pin_map.memory8[addr-1] & (1 << bit)))             // El pin no es de este archivo.
+        return IO_ERR;
+
+    handle->out     = GPIO_BITBAND(GPIO_PORT_ADDR[addr-1] + OFS_PAOUT, bit);
+    handle->in      = GPIO_BITBAND(GPIO_PORT_ADDR[addr-1] + OFS_PAIN,  bit);
+    handle->owner   = (pointer) dev_data_ptr;
+    handle->changes = gpio_pin_counter(dev_data_ptr, addr-1, 1 << bit);
+
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_pin_log1 / gpio_pin_log0 / gpio_pin_toggle / gpio_pin_read
+* Returned Value   : None / estado del pin.
+* Comments         :
+*    Acceso directo a un pin preparado. El alias bit-band solo toca ese bit,
+*    así que no hay carrera con otros pines del puerto. El toggle lee y
+*    escribe el mismo bit; solo compite con quien escriba ese mismo pin.
+*    Solo se escribe (y se cuenta) cuando el bit realmente cambia.
+*
+*END*********************************************************************/
+
+void gpio_pin_log1 (GPIO_PIN_HANDLE_PTR handle)
+{
+    if (!*handle->out)
+    {
+        *handle->out = 1;
+        (*handle->changes)++;
+    }
+}
+
+void gpio_pin_log0 (GPIO_PIN_HANDLE_PTR handle)
+{
+    if (*handle->out)
+    {
+        *handle->out = 0;
+        (*handle->changes)++;
+    }
+}
+
+void gpio_pin_toggle (GPIO_PIN_HANDLE_PTR handle)
+{
+    *handle->out ^= 1;
+    (*handle->changes)++;
+}
+
+boolean gpio_pin_read (GPIO_PIN_HANDLE_PTR handle)
+{
+    return (boolean) *handle->in;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_read_mask
+* Returned Value   : uint_32 con el estado de los pines del archivo.
+* Comments         :
+*    Una lectura de PxIN (o de la imagen del expansor) por puerto
+*    involucrado; el bit 'n' es el pin 'n' en el orden de apertura.
+*
+*END*********************************************************************/
+
+uint_32 gpio_read_mask (GPIO_DEV_DATA_PTR dev_data_ptr)
+{
+    uint_8  value [MAX_PORTS];
+    uint_32 mask = 0;
+    uint_32 i;
+
+    for (i = 0; i < MAX_PORTS; i++)
+        if (dev_data_ptr->ports & (1 << i))
+            value[i] = gpio_port_in(i);
+
+    for (i = 0; i < dev_data_ptr->pin_count; i++)
+        if (value[dev_data_ptr->pin_port[i]] & dev_data_ptr->pin_mask[i])
+            mask |= 1 << i;
+
+    return mask;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_debounce_open
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Reserva el antirrebote del archivo, lo agrega a la lista que recorre
+*    el tick y engancha el tick al timer32_2 (solo la primera vez).
+*
+*END*********************************************************************/
+
+_mqx_int gpio_debounce_open (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_DEBOUNCE_INIT_STRUCT_PTR init)
+{
+    GPIO_DEBOUNCE_PTR db;
+    uint_32           i;
+
+    if (dev_data_ptr->debounce != NULL)                                 // Ya tiene antirrebote.
+        return IO_ERR;
+
+    if (NULL == (db = (GPIO_DEBOUNCE_PTR) malloc(sizeof(GPIO_DEBOUNCE))))
+        return IO_ERR;
+
+    db->owner      = dev_data_ptr;
+    db->pins       = init->pins;
+    db->active_low = init->active_low;
+    db->threshold  = (init->debounce_ms * MILLIS) / STEP;               // De milisegundos a ticks.
+    db->long_ticks = (init->long_ms * MILLIS) / STEP;
+
+    if (db->threshold == 0)
+        db->threshold = 1;
+    if (db->threshold > 0xFF)                                           // Cabe en el integrador de 8 bits.
+        db->threshold = 0xFF;
+    if (db->long_ticks > 0xFFFF)
+        db->long_ticks = 0xFFFF;
+
+    db->events.state      = 0;
+    db->events.press      = 0;
+    db->events.release    = 0;
+    db->events.long_press = 0;
+    db->settling          = init->pins;                             // Primera integración de todos.
+    db->level             = gpio_read_mask(dev_data_ptr) ^ init->active_low;
+    for (i = 0; i < GPIO_MAX_MASK_PINS; i++)
+    {
+        db->integrator[i] = 0;
+        db->held[i]       = 0;
+    }
+
+    if (IO_OK != timer_hook_add(gpio_debounce_tick))                    // Sin gancho no se enlaza.
+    {
+        free(db);
+        return IO_ERR;
+    }
+
+    Int_disable();
+    timer_sync();                                                       // Lo transcurrido no cuenta para este archivo.
+    db->next = gpio_debounce_list;
+    gpio_debounce_list = db;
+    dev_data_ptr->debounce = (pointer) db;
+    timer_reschedule();
+    Int_enable();
+
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_debounce_close
+* Returned Value   : None.
+* Comments         :
+*    Saca el antirrebote del archivo de la lista y lo libera. Con la lista
+*    vacía se retira el tick.
+*
+*END*********************************************************************/
+
+void gpio_debounce_close (GPIO_DEV_DATA_PTR dev_data_ptr)
+{
+    GPIO_DEBOUNCE_PTR _PTR_ link;
+    GPIO_DEBOUNCE_PTR       db = (GPIO_DEBOUNCE_PTR) dev_data_ptr->debounce;
+
+    if (db == NULL)
+        return;
+
+    Int_disable();
+    for (link = &gpio_debounce_list; *link != NULL; link = &(*link)->next)
+        if (*link == db)
+        {
+            *link = db->next;
+            break;
+        }
+    dev_data_ptr->debounce = NULL;
+    Int_enable();
+
+    if (gpio_debounce_list == NULL)
+        timer_hook_remove(gpio_debounce_tick);
+
+    free(db);
+}
+
+/* Deja un registro en la cola; con la cola llena se descarta y se cuenta.
+   Se llama desde Hwi (puerto o Timer32_2), donde sem_post está permitido. */
+static void gpio_queue_push (GPIO_QUEUE_PTR q, uint_32 pin, uint_32 edge, uint64_t timestamp)
+{
+    GPIO_EVENT_PTR event;
+
+    if (q->count == q->size)
+    {
+        q->lost++;
+        return;
+    }
+
+    event = &q->buffer[q->head];
+    event->pin       = pin;
+    event->edge      = edge;
+    event->reserved  = 0;
+    event->timestamp = timestamp;
+
+    if (++q->head == q->size)
+        q->head = 0;
+    q->count++;
+
+    sem_post(&q->sem);                                                  // Despierta al lector.
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_debounce_tick
+* Returned Value   : uS al siguiente paso en que algún pin puede cambiar,
+*                    o TIMER_HOOK_IDLE.
+* Comments         :
+*    Se ejecuta desde la interrupción del timer32_2 con los uS que pasaron
+*    (con 'elapsed' en cero solo pregunta). Cada pin avanza su integrador
+*    un paso por cada STEP uS, con el nivel que tuvo desde la lectura
+*    anterior y sin pasar de los extremos, y genera eventos de presión,
+*    liberación y 'long press'. Los pines que además están en la cola de
+*    eventos solo se integran después de un flanco y hasta quedar estables;
+*    como cada flanco llama a timer_sync, su nivel no cambia entre ticks y
+*    el tick puede esperar hasta el paso en que se decidan. Los demás pines
+*    se leen en cada tick.
+*
+*END*********************************************************************/
+
+uint_32 gpio_debounce_tick (uint_32 elapsed)
+{
+    GPIO_DEBOUNCE_PTR db;
+    GPIO_QUEUE_PTR    q;
+    uint_32           bit, i, irq_pins, steps, left, us, next = TIMER_HOOK_IDLE;
+
+    steps = (gpio_debounce_rem + elapsed) / STEP;                       // Pasos completos del integrador.
+    gpio_debounce_rem = (gpio_debounce_rem + elapsed) % STEP;
+
+    for (db = gpio_debounce_list; db != NULL; db = db->next)
+    {
+        q = (GPIO_QUEUE_PTR) db->owner->queue;
+        irq_pins = (q != NULL) ? (q->pins & db->pins) : 0;              // Pines despertados por flanco.
+
+        if (!(db->pins & ~irq_pins) && !db->settling)                   // Todo estable: nada que leer.
+            continue;
+
+        for (i = 0; (steps != 0) && (i < db->owner->pin_count); i++)
+        {
+            bit = 1 << i;
+            if (!(db->pins & bit))
+                continue;
+            if ((irq_pins & bit) && !(db->settling & bit))
+                continue;
+
+            if (db->level & bit)                                        // Integra con saturación.
+                db->integrator[i] = (db->integrator[i] + steps < db->threshold) ? db->integrator[i] + steps : db->threshold;
+            else
+                db->integrator[i] = (db->integrator[i] > steps) ? db->integrator[i] - steps : 0;
+
+            if ((db->integrator[i] == db->threshold) && !(db->events.state & bit))
+            {
+                db->events.state |= bit;                                // Presión aceptada.
+                db->events.press |= bit;
+                db->held[i] = 0;
+                if (q != NULL)
+                    gpio_queue_push(q, i, GPIO_EVENT_PRESS, timer_timebase_us());
+            }
+            else if ((db->integrator[i] == 0) && (db->events.state & bit))
+            {
+                db->events.state   &= ~bit;                             // Liberación aceptada.
+                db->events.release |= bit;
+                if (q != NULL)
+                    gpio_queue_push(q, i, GPIO_EVENT_RELEASE, timer_timebase_us());
+            }
+            else if ((db->events.state & bit) && (db->held[i] < db->long_ticks))
+            {
+                db->held[i] = (db->held[i] + steps < db->long_ticks) ? db->held[i] + steps : db->long_ticks;
+                if (db->held[i] == db->long_ticks)                      // Sigue activo: 'long press' una vez.
+                {
+                    db->events.long_press |= bit;
+                    if (q != NULL)
+                        gpio_queue_push(q, i, GPIO_EVENT_LONG, timer_timebase_us());
+                }
+            }
+
+            // Estable: en reposo, o activo con el 'long press' ya resuelto.
+            if ((db->integrator[i] == 0) ||
+                ((db->integrator[i] == db->threshold) && (db->held[i] >= db->long_ticks)))
+                db->settling &= ~bit;
+        }
+
+        if (elapsed != 0)
+            db->level = gpio_read_mask(db->owner) ^ db->active_low;    // Nivel para el siguiente intervalo.
+
+        if (db->pins & ~irq_pins)                                       // Pines sin flanco: se leen cada tick.
+        {
+            next = TIMER_HOOK_NEXT;
+            continue;
+        }
+
+        for (i = 0; i < db->owner->pin_count; i++)                      // Pasos a la siguiente decisión.
+        {
+            bit = 1 << i;
+            if (!(db->settling & bit))
+                continue;
+
+            if (!(db->level & bit))
+                left = db->integrator[i];                               // A la liberación (o a quedar en reposo).
+            else if (db->integrator[i] < db->threshold)
+                left = db->threshold - db->integrator[i];               // A la presión.
+            else
+                left = db->long_ticks - db->held[i];                    // Al 'long press'.
+            if (left == 0)
+                left = 1;                                               // Ya estable: el siguiente paso lo saca.
+
+            us = left * STEP - gpio_debounce_rem;
+            if (us < next)
+                next = us;
+        }
+    }
+
+    return next;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_port_isr
+* Returned Value   : None.
+* Comments         :
+*    Hwi de un puerto P1..P6 (el argumento) para los pines con cola de
+*    eventos. Invierte PxIES de cada pin que disparó (así se detectan ambos
+*    flancos) y deja el registro en la cola de su archivo; si el pin tiene
+*    antirrebote, solo lo marca para que el tick lo integre.
+*    No usa Int_disable/Int_enable (no se anidan: el Int_enable de aquí
+*    reactivaría las IE a media sección crítica de un hilo). Solo toca los
+*    registros de su puerto, y de lo que comparte con el tick (colas,
+*    antirrebote, rueda de tiempos) se excluye enmascarando la IE del
+*    timer32_2, que al final vuelve a su valor previo.
+*
+*END*********************************************************************/
+
+static void gpio_port_isr (UArg arg)
+{
+    GPIO_QUEUE_PTR    q;
+    GPIO_DEBOUNCE_PTR db;
+    uint_32           port, addr, bit, pin;
+    uint64_t          timestamp;
+    uint_32           t32_ie;
+    uint_8            flags, level, mine;
+    boolean           wake = FALSE;
+
+    timestamp = timer_timebase_us();
+
+    port = (uint_32) arg;
+    addr = GPIO_PORT_ADDR[port];
+    flags = HWREG8(addr + OFS_PAIFG) & gpio_queue_irq_map[port];
+    if (flags)
+    {
+        level = HWREG8(addr + OFS_PAIN);
+        HWREG8(addr + OFS_PAIES) = (HWREG8(addr + OFS_PAIES) & ~flags) | (level & flags);  // Siguiente: flanco contrario.
+        HWREG8(addr + OFS_PAIFG) &= ~flags;                            // Después de PxIES, que puede activar la bandera.
+
+        t32_ie = TIMER32_2 -> CONTROL & TIMER32_CONTROL_IE;             // Solo el tick; las demás IE no se tocan.
+        TIMER32_2 -> CONTROL &= ~TIMER32_CONTROL_IE;
+
+        for (q = gpio_queue_list; q != NULL; q = q->next)
+        {
+            if (!(mine = flags & q->port_mask[port]))
+                continue;
+
+            db = (GPIO_DEBOUNCE_PTR) q->owner->debounce;
+            for (bit = 0; bit < 8; bit++)
+            {
+                if (!(mine & (1 << bit)))
+                    continue;
+
+                pin = q->index[port][bit];
+                if ((db != NULL) && (db->pins & (1 << pin)))
+                {
+                    if (!wake)
+                        timer_sync();                                   // Lo anterior se integra con el nivel anterior.
+                    db->level = (db->level & ~(1 << pin)) |
+                                ((((level >> bit) & 1) << pin) ^ (db->active_low & (1 << pin)));
+                    db->settling |= 1 << pin;                           // El antirrebote decide el evento.
+                    wake = TRUE;
+                }
+                else
+                    gpio_queue_push(q, pin, (level & (1 << bit)) ? GPIO_EVENT_RISING : GPIO_EVENT_FALLING, timestamp);
+            }
+        }
+
+        if (wake)
+            timer_reschedule();                                         // El tick despierta a integrarlos.
+
+        TIMER32_2 -> CONTROL |= t32_ie;                                 // Vuelve a como estaba.
+    }
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_queue_open
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Reserva la cola del archivo y pasa sus pines a interrupción por ambos
+*    flancos. Los puertos involucrados quedan atendidos por gpio_port_isr,
+*    por lo que no se combina con GPIO_IOCTL_SET_IRQ_FUNCTION.
+*
+*END*********************************************************************/
+
+_mqx_int gpio_queue_open (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_QUEUE_INIT_STRUCT_PTR init)
+{
+    GPIO_QUEUE_PTR    q;
+    GPIO_DEBOUNCE_PTR db;
+    uint_32           i, port, bit, addr;
+    uint_8            level;
+
+    if ((dev_data_ptr->queue != NULL) || (dev_data_ptr->irq_func != NULL))
+        return IO_ERR;                                                  // Ya tiene cola o función IRQ propia.
+    if ((init->pins == 0) || (init->size == 0))
+        return IO_ERR;
+
+    for (i = 0; i < GPIO_MAX_MASK_PINS; i++)                            // Pines del archivo y con interrupción.
+        if ((init->pins & (1 << i)) &&
+            ((i >= dev_data_ptr->pin_count) || (dev_data_ptr->pin_port[i] >= GPIO_IRQ_PORTS)))
+            return IO_ERR;
+
+    if (NULL == (q = (GPIO_QUEUE_PTR) malloc(sizeof(GPIO_QUEUE))))
+        return IO_ERR;
+    if (NULL == (q->buffer = (GPIO_EVENT_PTR) malloc(init->size * sizeof(GPIO_EVENT))))
+    {
+        free(q);
+        return IO_ERR;
+    }
+
+    q->owner      = dev_data_ptr;
+    q->pins       = init->pins;
+    q->size       = init->size;
+    q->head       = 0;
+    q->tail       = 0;
+    q->count      = 0;
+    q->lost       = 0;
+    q->timeout_ms = init->timeout_ms;
+    sem_init(&q->sem, 0, 0);
+
+    for (port = 0; port < GPIO_IRQ_PORTS; port++)
+        q->port_mask[port] = 0;
+
+    for (i = 0; i < dev_data_ptr->pin_count; i++)
+    {
+        if (!(init->pins & (1 << i)))
+            continue;
+
+        port = dev_data_ptr->pin_port[i];
+        for (bit = 0; !(dev_data_ptr->pin_mask[i] & (1 << bit)); bit++);
+        q->port_mask[port] |= dev_data_ptr->pin_mask[i];
+        q->index[port][bit] = i;
+    }
+
+    Int_disable();
+    for (port = 0; port < GPIO_IRQ_PORTS; port++)
+    {
+        if (!q->port_mask[port])
+            continue;
+
+        addr  = GPIO_PORT_ADDR[port];
+        level = HWREG8(addr + OFS_PAIN);
+        HWREG8(addr + OFS_PAIES) = (HWREG8(addr + OFS_PAIES) & ~q->port_mask[port]) | (level & q->port_mask[port]);
+        HWREG8(addr + OFS_PAIFG) &= ~q->port_mask[port];
+
+        dev_data_ptr->irq_map.memory8[port] |= q->port_mask[port];
+        gpio_global_irq_map.memory8[port]   |= q->port_mask[port];     // Int_enable() pone PxIE.
+        gpio_queue_irq_map[port]            |= q->port_mask[port];
+        gpio_irq_ports                      |= 1 << port;
+
+        Int_registerHwi(port + INT_PORT1, gpio_port_isr, (UArg) port);
+        Int_enableInterrupt(port + INT_PORT1);
+    }
+
+    timer_sync();
+    if ((db = (GPIO_DEBOUNCE_PTR) dev_data_ptr->debounce) != NULL)
+        db->settling |= db->pins & q->pins;                             // Integra una vez el estado actual.
+
+    q->next = gpio_queue_list;
+    gpio_queue_list = q;
+    dev_data_ptr->queue = (pointer) q;
+    timer_reschedule();
+    Int_enable();
+
+    return IO_OK;
+}
+
+/*FUNCTION*****************************************************************
+*
+* Function Name    : gpio_queue_close
+* Returned Value   : None.
+* Comments         :
+*    Saca la cola del archivo de la lista y la libera. PxIE se limpia con
+*    el siguiente Int_enable(), que ya no ve estos pines en el mapeo global.
+*
+*END*********************************************************************/
+
+void gpio_queue_close (GPIO_DEV_DATA_PTR dev_data_ptr)
+{
+    GPIO_QUEUE_PTR _PTR_ link;
+    GPIO_QUEUE_PTR       q = (GPIO_QUEUE_PTR) dev_data_ptr->queue;
+    uint_32              port;
+
+    if (q == NULL)
+        return;
+
+    Int_disable();
+    for (link = &gpio_queue_list; *link != NULL; link = &(*link)->next)
+        if (*link == q)
+        {
+            *link = q->next;
+            break;
+        }
+
+    for (port = 0; port < GPIO_IRQ_PORTS; port++)
+    {
+        if (!q->port_mask[port])
+            continue;
+
+        dev_data_ptr->irq_map.memory8[port] &= ~q->port_mask[port];
+        gpio_global_irq_map.memory8[port]   &= ~q->port_mask[port];
+        gpio_queue_irq_map[port]            &= ~q->port_mask[port];
+        if (!gpio_queue_irq_map[port])
+            Int_disableInterrupt(port + INT_PORT1);
+    }
+    dev_data_ptr->queue = NULL;
+    Int_enable();
+
+    sem_destroy(&q->sem);
+    free(q->buffer);
+    free(q);
+}
@@ -1,91 +1,308 @@
- //FileName:        gpio_f_MSP432.h
- //Dependencies:    None.
- //Processor:       MSP432
- //Board:			MSP432P401R
- //Program version: CCS V8.3 TI
- //Company:         Texas Instruments
- //Description:     Driver para GPIO por medio de archivos. Header File.
- //Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- //Updated:         12/2018
-
-#ifndef GPIO_F_MSP432_H_
-#define GPIO_F_MSP432_H_
-
-/* Definiciones de configuracin para inicializacin. */
-
-#define GPIO_LIST_END           0x00000000
-#define GPIO_PIN_VALID          0x80000000
-#define GPIO_IRQ_EDGE_H_TO_L    0x10000000
-#define GPIO_PIN_STATUS_0       0x00000000
-#define GPIO_PIN_STATUS_1       0x40000000
-#define GPIO_PIN_IRQ            0x20000000
-
-/* Definiciones para el sistema, no se usan como tal, sirven como referencia. */
-#define GPIO_PIN_ADDR           0x00FFFFFF
-#define GPIO_PIN_STATUS         0x40000000
-
-/* Comandos IOCTL. */
-
-#define GPIO_IOCTL_ADD_PINS         13
-#define GPIO_IOCTL_WRITE_LOG0       14
-#define GPIO_IOCTL_WRITE_LOG1       15
-#define GPIO_IOCTL_READ             16
-#define GPIO_IOCTL_SET_IRQ_FUNCTION 17
-
-#define MAX_PORTS 10                // Aunque en realidad, solo 6 puertos estn plasmados ya en la tarjeta.
-typedef uint_32 GPIO_PIN_STRUCT;    // Su estructura basta con 32 bits.
-
-/*
- *  Estructura de mapeo de GPIO
- *  de los pines que se van 'ocupando' en los archivos.
- */
-
-typedef struct pin_mapping
-{
-    uint_32 memory8 [MAX_PORTS];
-
-} GPIO_PIN_MAP, _PTR_ GPIO_PIN_MAP_PTR;
-
-/*
- *  Estructura de mapeo de GPIO
- *  de los pines con propsito de interrupcin.
- */
-
-typedef struct irq_mapping
-{
-    uint_32 memory8 [MAX_PORTS];
-
-} GPIO_IRQ_MAP, _PTR_ GPIO_IRQ_MAP_PTR;
-
-/* Necesario saber si es entrada o salida. */
-typedef enum
-{
-  DEV_INPUT,
-  DEV_OUTPUT
-} device_type;
-
-/*
- *  Estructura gpio_device_struct.
- *  Funcin de interrupcin, mapeo de pines, cuales tienen interrupcin,
- *  flanco de interrupcin, y el tipo (entrada o salida).
- */
-
-typedef struct gpio_device_struct
-{
-    pointer                             irq_func;
-    GPIO_PIN_MAP                        pin_map;
-    GPIO_IRQ_MAP                        irq_map;
-    GPIO_IRQ_MAP                        irq_edge_map;
-    uint_32                             type;
-
-} GPIO_DEV_DATA, _PTR_ GPIO_DEV_DATA_PTR;
-
-/* Funciones bsicas pata el dispositivo. */
-
-extern _mqx_int gpio_open       (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags);
-extern _mqx_int gpio_cpu_open   (FILE_PTR_f fd_ptr, char_ptr file_name, char_ptr param_ptr);
-extern _mqx_int gpio_close      (FILE _PTR_ fd_ptr);
-extern _mqx_int gpio_read       (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num);
-extern _mqx_int gpio_ioctl      (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr);
-
-#endif /* GPIO_F_MSP432_H_ */
+ //FileName:        gpio_f_MSP432.h
+ //Dependencies:    None.
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Driver para GPIO por medio de archivos. Header File.
+ //Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         12/2018
+
+#ifndef GPIO_F_MSP432_H_
+#define GPIO_F_MSP432_H_
+
+/* Definiciones de configuración para inicialización. */
+
+#define GPIO_LIST_END           0x00000000
+#define GPIO_PIN_VALID          0x80000000
+#define GPIO_IRQ_EDGE_H_TO_L    0x10000000
+#define GPIO_PIN_STATUS_0       0x00000000
+#define GPIO_PIN_STATUS_1       0x40000000
+#define GPIO_PIN_IRQ            0x20000000
+
+/* Definiciones para el sistema, no se usan como tal, sirven como referencia. */
+#define GPIO_PIN_ADDR           0x00FFFFFF
+#define GPIO_PIN_STATUS         0x40000000
+
+/* Comandos IOCTL. */
+
+#define GPIO_IOCTL_ADD_PINS         13
+#define GPIO_IOCTL_WRITE_LOG0       14
+#define GPIO_IOCTL_WRITE_LOG1       15
+#define GPIO_IOCTL_READ             16
+#define GPIO_IOCTL_SET_IRQ_FUNCTION 17
+#define GPIO_IOCTL_COMPILE_SET      18      // Compila una lista de pines a un GPIO_PIN_SET.
+#define GPIO_IOCTL_SET_LOG1         19      // Pone en alto un GPIO_PIN_SET ya compilado.
+#define GPIO_IOCTL_SET_LOG0         20      // Pone en bajo un GPIO_PIN_SET ya compilado.
+#define GPIO_IOCTL_PIN_LOG1         21      // Un solo pin (apuntador a GPIO_PIN_STRUCT), por bit-band.
+#define GPIO_IOCTL_PIN_LOG0         22
+#define GPIO_IOCTL_PIN_TOGGLE       23
+#define GPIO_IOCTL_PIN_READ         24      // Actualiza GPIO_PIN_STATUS del pin recibido.
+#define GPIO_IOCTL_PIN_HANDLE       25      // Prepara un GPIO_PIN_HANDLE para acceso directo.
+#define GPIO_IOCTL_READ_MASK        26      // Estado de todos los pines del archivo en un uint_32.
+#define GPIO_IOCTL_DEBOUNCE         27      // Activa el antirrebote (GPIO_DEBOUNCE_INIT_STRUCT_PTR).
+#define GPIO_IOCTL_GET_EVENTS       28      // Estado filtrado y eventos pendientes (GPIO_DEBOUNCE_EVENTS_PTR).
+#define GPIO_IOCTL_EVENT_QUEUE      29      // Entradas por interrupción con cola de eventos (GPIO_QUEUE_INIT_STRUCT_PTR).
+#define GPIO_IOCTL_QUEUE_STATUS     30      // Registros pendientes y perdidos (GPIO_QUEUE_STATUS_PTR).
+#define GPIO_IOCTL_PIN_CHANGES      31      // Cambios de un pin de salida (GPIO_PIN_CHANGES_PTR).
+
+#define GPIO_HW_PORTS 11            // P1..P10 y PJ (índice 10).
+#define GPIO_EXP_OUT_FIRST 11       // Expansor (gpio_exp_MSP432.h): salidas 74HC595 en los índices 11..14,
+#define GPIO_EXP_OUT_PORTS 4
+#define GPIO_EXP_IN_FIRST  15       // entradas 74HC165 en los índices 15..18.
+#define GPIO_EXP_IN_PORTS  4
+#define MAX_PORTS 19                // Puertos de la tarjeta más los del expansor.
+#define GPIO_MAX_MASK_PINS 32       // Pines que caben en la máscara de GPIO_IOCTL_READ_MASK.
+#define GPIO_IRQ_PORTS 6            // Solo P1..P6 tienen interrupción.
+typedef uint_32 GPIO_PIN_STRUCT;    // Su estructura basta con 32 bits.
+
+/* Dirección base de cada puerto (P1..P10, PJ); los registros se alcanzan con OFS_PAxxx. */
+extern const uint32_t GPIO_PORT_ADDR[GPIO_HW_PORTS];
+#define GPIO_PORT_REG(port, ofs)    HWREG8(GPIO_PORT_ADDR[port] + (ofs))
+
+/* Alias bit-band (región periférica) del bit 'bit' del registro de 8 bits en 'addr'. */
+#define GPIO_BITBAND(addr, bit)     ((vuint_32_ptr) (BITBAND_PERI_BASE + (((addr) - PERIPH_BASE) << 5) + ((bit) << 2)))
+
+/*
+ *  Estructura de mapeo de GPIO
+ *  de los pines que se van 'ocupando' en los archivos.
+ */
+
+typedef struct pin_mapping
+{
+    uint_32 memory8 [MAX_PORTS];
+
+} GPIO_PIN_MAP, _PTR_ GPIO_PIN_MAP_PTR;
+
+/*
+ *  Estructura de mapeo de GPIO
+ *  de los pines con propósito de interrupción.
+ */
+
+typedef struct irq_mapping
+{
+    uint_32 memory8 [MAX_PORTS];
+
+} GPIO_IRQ_MAP, _PTR_ GPIO_IRQ_MAP_PTR;
+
+/* Necesario saber si es entrada o salida. */
+typedef enum
+{
+  DEV_INPUT,
+  DEV_OUTPUT
+} device_type;
+
+/*
+ *  Estructura gpio_device_struct.
+ *  Función de interrupción, mapeo de pines, cuales tienen interrupción,
+ *  flanco de interrupción, y el tipo (entrada o salida).
+ */
+
+typedef struct gpio_device_struct
+{
+    pointer                             irq_func;
+    GPIO_PIN_MAP                        pin_map;
+    GPIO_IRQ_MAP                        irq_map;
+    GPIO_IRQ_MAP                        irq_edge_map;
+    uint_32                             type;
+    uint_32                             ports;              // Puertos con pines del archivo (bit 0 -> P1).
+
+    // Orden de los pines como se abrieron: el bit 'n' de la máscara es el pin 'n'.
+    uint_32                             pin_count;
+    uint_8                              pin_port [GPIO_MAX_MASK_PINS];
+    uint_8                              pin_mask [GPIO_MAX_MASK_PINS];
+
+    pointer                             debounce;           // Antirrebote del archivo (NULL si no tiene).
+    pointer                             queue;              // Cola de eventos del archivo (NULL si no tiene).
+
+    // Salidas: último estado escrito (solo pines del archivo) y cambios por pin.
+    uint_8                              shadow  [MAX_PORTS];
+    uint_32                             changes [GPIO_MAX_MASK_PINS];
+
+} GPIO_DEV_DATA, _PTR_ GPIO_DEV_DATA_PTR;
+
+/*
+ *  Antirrebote por integrador: por cada STEP uS que pasan, el contador de
+ *  cada pin sube si el pin estuvo activo y baja si no. El cambio se acepta
+ *  cuando el contador llega a un extremo. Las máscaras usan el orden de
+ *  apertura de los pines (igual que GPIO_IOCTL_READ_MASK).
+ */
+
+typedef struct gpio_debounce_init_struct
+{
+    uint_32                             pins;               // Pines con antirrebote.
+    uint_32                             active_low;         // Pines que se consideran activos en bajo.
+    uint_32                             debounce_ms;        // Tiempo estable para aceptar un cambio (máx. 255 ticks).
+    uint_32                             long_ms;            // Tiempo activo para un 'long press' (0: sin long press).
+
+} GPIO_DEBOUNCE_INIT_STRUCT, _PTR_ GPIO_DEBOUNCE_INIT_STRUCT_PTR;
+
+typedef struct gpio_debounce_events
+{
+    uint_32                             state;              // Estado filtrado (1 = activo).
+    uint_32                             press;              // Pines que se activaron desde la última lectura.
+    uint_32                             release;            // Pines que se liberaron desde la última lectura.
+    uint_32                             long_press;         // Pines que cumplieron 'long_ms' activos.
+
+} GPIO_DEBOUNCE_EVENTS, _PTR_ GPIO_DEBOUNCE_EVENTS_PTR;
+
+typedef struct gpio_debounce
+{
+    struct gpio_debounce _PTR_          next;               // Siguiente archivo con antirrebote.
+    GPIO_DEV_DATA_PTR                   owner;
+    uint_32                             pins;
+    uint_32                             active_low;
+    uint_32                             threshold;          // En pasos de STEP uS.
+    uint_32                             long_ticks;         // En pasos de STEP uS.
+    GPIO_DEBOUNCE_EVENTS                events;
+    uint_32                             settling;           // Pines por integrar (solo con cola de eventos).
+    uint_32                             level;              // Nivel desde la última lectura (1 = activo).
+    uint_8                              integrator [GPIO_MAX_MASK_PINS];
+    uint_16                             held       [GPIO_MAX_MASK_PINS];
+
+} GPIO_DEBOUNCE, _PTR_ GPIO_DEBOUNCE_PTR;
+
+/*
+ *  Cola de eventos: los pines indicados trabajan por interrupción (ambos
+ *  flancos, alternando PxIES) y cada flanco deja un registro con su marca
+ *  de tiempo. Si el pin también tiene antirrebote, el flanco solo despierta
+ *  al integrador y a la cola llegan los eventos ya filtrados. Los registros
+ *  se leen con fread_f(), que bloquea hasta que haya al menos uno.
+ */
+
+#define GPIO_EVENT_NONE         0   // Fin de los registros válidos de una lectura.
+#define GPIO_EVENT_RISING       1   // Flancos crudos.
+#define GPIO_EVENT_FALLING      2
+#define GPIO_EVENT_PRESS        3   // Eventos del antirrebote.
+#define GPIO_EVENT_RELEASE      4
+#define GPIO_EVENT_LONG         5
+
+typedef struct gpio_event
+{
+    uint_8                              pin;                // Número de pin en el orden de apertura.
+    uint_8                              edge;               // GPIO_EVENT_xxx.
+    uint_16                             reserved;
+    uint64_t                            timestamp;          // timer_timebase_us() al ocurrir.
+
+} GPIO_EVENT, _PTR_ GPIO_EVENT_PTR;
+
+typedef struct gpio_queue_init_struct
+{
+    uint_32                             pins;               // Pines por interrupción (solo P1..P6).
+    uint_32                             size;               // Registros que caben en la cola.
+    uint_32                             timeout_ms;         // Espera máxima de fread_f() (0: sin límite).
+
+} GPIO_QUEUE_INIT_STRUCT, _PTR_ GPIO_QUEUE_INIT_STRUCT_PTR;
+
+typedef struct gpio_queue_status
+{
+    uint_32                             pending;            // Registros sin leer.
+    uint_32                             lost;               // Registros descartados por cola llena.
+
+} GPIO_QUEUE_STATUS, _PTR_ GPIO_QUEUE_STATUS_PTR;
+
+typedef struct gpio_queue
+{
+    struct gpio_queue _PTR_             next;               // Siguiente archivo con cola.
+    GPIO_DEV_DATA_PTR                   owner;
+    uint_32                             pins;
+    uint_8                              port_mask [GPIO_IRQ_PORTS];     // Pines de la cola en cada puerto.
+    uint_8                              index [GPIO_IRQ_PORTS][8];      // (puerto, bit) -> número de pin.
+    GPIO_EVENT_PTR                      buffer;
+    uint_32                             size;
+    uint_32                             head;
+    uint_32                             tail;
+    uint_32                             count;
+    uint_32                             lost;
+    uint_32                             timeout_ms;
+    sem_t                               sem;                // Cuenta registros disponibles.
+
+} GPIO_QUEUE, _PTR_ GPIO_QUEUE_PTR;
+
+/*
+ *  Conjunto de pines compilado: la lista original convertida a pares
+ *  (puerto, máscara), para escribir solo los puertos involucrados.
+ *  Se llena 'list' y se compila con GPIO_IOCTL_COMPILE_SET. La escritura
+ *  se compara contra la sombra del archivo: si no cambia ningún pin, no
+ *  se toca el hardware ni se desactivan interrupciones.
+ */
+
+typedef struct gpio_pin_set
+{
+    const GPIO_PIN_STRUCT _PTR_         list;               // Lista de origen, terminada en GPIO_LIST_END.
+    pointer                             owner;              // Datos del archivo que lo compiló (NULL: sin compilar).
+    uint_32                             count;              // Número de puertos involucrados.
+    uint_8                              port [MAX_PORTS];   // Índice de puerto (0 -> P1).
+    uint_8                              mask [MAX_PORTS];   // Pines del conjunto en ese puerto.
+
+} GPIO_PIN_SET, _PTR_ GPIO_PIN_SET_PTR;
+
+/*
+ *  Pin individual con sus alias bit-band ya calculados. Cada escritura
+ *  afecta un solo bit de PxOUT en una sola operación del bus, por lo que
+ *  no hace falta desactivar interrupciones. Se llena 'pin' y se prepara
+ *  con GPIO_IOCTL_PIN_HANDLE. Estas escrituras cuentan cambios pero no
+ *  pasan por la sombra, así que un pin no debe manejarse a la vez por
+ *  handle y por conjunto. Los pines del expansor no tienen alias bit-band;
+ *  se manejan por conjunto.
+ */
+
+typedef struct gpio_pin_handle
+{
+    GPIO_PIN_STRUCT                     pin;                // Pin de origen (ej. BSP_LED3).
+    pointer                             owner;              // Datos del archivo que lo preparó (NULL: sin preparar).
+    vuint_32_ptr                        out;                // Alias del bit en PxOUT.
+    vuint_32_ptr                        in;                 // Alias del bit en PxIN.
+    uint_32_ptr                         changes;            // Contador de cambios del pin en su archivo.
+
+} GPIO_PIN_HANDLE, _PTR_ GPIO_PIN_HANDLE_PTR;
+
+/* Consulta del contador de cambios de un pin de salida. */
+typedef struct gpio_pin_changes
+{
+    GPIO_PIN_STRUCT                     pin;                // Pin a consultar.
+    uint_32                             changes;            // Veces que cambió desde que se abrió el archivo.
+
+} GPIO_PIN_CHANGES, _PTR_ GPIO_PIN_CHANGES_PTR;
+
+/* Funciones básicas pata el dispositivo. */
+
+extern _mqx_int gpio_open       (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags);
+extern _mqx_int gpio_cpu_open   (FILE_PTR_f fd_ptr, char_ptr file_name, char_ptr param_ptr);
+extern _mqx_int gpio_close      (FILE _PTR_ fd_ptr);
+extern _mqx_int gpio_read       (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num);
+extern _mqx_int gpio_ioctl      (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr);
+
+/* Conjuntos de pines. */
+
+extern _mqx_int gpio_set_compile (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_PIN_SET_PTR set);
+extern void     gpio_set_all     (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_PIN_SET_PTR set);
+extern void     gpio_set_apply   (GPIO_PIN_SET_PTR set, boolean level);
+
+// Acceso directo (sin pasar por el archivo) para conjuntos ya compilados.
+extern _mqx_int gpio_set_log1    (GPIO_PIN_SET_PTR set);
+extern _mqx_int gpio_set_log0    (GPIO_PIN_SET_PTR set);
+
+/* Lectura empacada y antirrebote. */
+
+extern uint_32  gpio_read_mask      (GPIO_DEV_DATA_PTR dev_data_ptr);
+extern _mqx_int gpio_debounce_open  (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_DEBOUNCE_INIT_STRUCT_PTR init);
+extern void     gpio_debounce_close (GPIO_DEV_DATA_PTR dev_data_ptr);
+extern uint_32  gpio_debounce_tick  (uint_32 elapsed);
+
+/* Cola de eventos por interrupción. */
+
+extern _mqx_int gpio_queue_open     (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_QUEUE_INIT_STRUCT_PTR init);
+extern void     gpio_queue_close    (GPIO_DEV_DATA_PTR dev_data_ptr);
+
+/* Pines individuales por bit-band. */
+
+extern _mqx_int gpio_pin_prepare (GPIO_DEV_DATA_PTR dev_data_ptr, GPIO_PIN_HANDLE_PTR handle);
+
+// Acceso directo para pines ya preparados (sin desactivar interrupciones).
+extern void     gpio_pin_log1    (GPIO_PIN_HANDLE_PTR handle);
+extern void     gpio_pin_log0    (GPIO_PIN_HANDLE_PTR handle);
+extern void     gpio_pin_toggle  (GPIO_PIN_HANDLE_PTR handle);
+extern boolean  gpio_pin_read    (GPIO_PIN_HANDLE_PTR handle);
+
+#endif /* GPIO_F_MSP432_H_ */
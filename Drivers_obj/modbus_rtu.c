@@ -0,0 +1,189 @@
+ //FileName:        modbus_rtu.c
+ //Dependencies:    modbus_rtu.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Esclavo Modbus RTU: validación de tramas y funciones de registros. Source File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#include <stddef.h>
+#include "modbus_rtu.h"
+
+/* CRC-16 de Modbus por nibbles: tabla de 16 entradas en lugar de 256. */
+static const uint16_t modbus_crc_nibble[16] =
+{
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+
+/* Enteros de 16 bits dentro de la PDU: byte alto primero. */
+#define MODBUS_U16(p)       ((uint16_t) (((p)[0] << 8) | (p)[1]))
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : modbus_crc16
+* Returned Value   : CRC-16 de Modbus de 'length' bytes.
+* Comments         :
+*    Dos pasos de tabla por byte (nibble bajo y alto, por ser CRC reflejado).
+*
+*END***********************************************************************************/
+
+uint16_t modbus_crc16 (const uint8_t * data, uint32_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (length--)
+    {
+        crc = (crc >> 4) ^ modbus_crc_nibble[(crc ^ *data) & 0x0F];
+        crc = (crc >> 4) ^ modbus_crc_nibble[(crc ^ (*data >> 4)) & 0x0F];
+        data++;
+    }
+
+    return crc;
+}
+
+/* Agrega el CRC a los 'length' bytes de la respuesta; regresa el largo total. */
+static uint32_t modbus_seal (uint8_t * response, uint32_t length)
+{
+    uint16_t crc = modbus_crc16(response, length);
+
+    response[length++] = crc & 0xFF;
+    response[length++] = crc >> 8;
+    return length;
+}
+
+/* Lectura de 'count' registros (funciones 3 y 4). */
+static uint8_t modbus_read (uint16_t (*read)(uint16_t), uint16_t count, const uint8_t * pdu,
+                            uint32_t length, uint8_t * response, uint32_t * size)
+{
+    uint16_t first, quantity, i, value;
+
+    if (length != 4)
+        return MODBUS_EX_ILLEGAL_VALUE;
+
+    first    = MODBUS_U16(pdu);
+    quantity = MODBUS_U16(pdu + 2);
+    if ((quantity == 0) || (quantity > MODBUS_MAX_READ))
+        return MODBUS_EX_ILLEGAL_VALUE;
+    if ((read == NULL) || ((uint32_t) first + quantity > count))
+        return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    response[2] = 2 * quantity;
+    for (i = 0; i < quantity; i++)
+    {
+        value = read(first + i);
+        response[3 + 2 * i] = value >> 8;
+        response[4 + 2 * i] = value & 0xFF;
+    }
+
+    *size = 3 + 2 * quantity;
+    return MODBUS_EX_NONE;
+}
+
+/* Escritura de uno (función 6) o varios (función 16) registros. */
+static uint8_t modbus_write (MODBUS_SLAVE_PTR slave, uint8_t function, const uint8_t * pdu,
+                             uint32_t length, uint8_t * response, uint32_t * size)
+{
+    uint16_t first, quantity, i;
+    uint8_t  result;
+
+    if (function == MODBUS_WRITE_SINGLE)
+    {
+        if (length != 4)
+            return MODBUS_EX_ILLEGAL_VALUE;
+        quantity = 1;
+    }
+    else
+    {
+        if ((length < 5) || (length != 5 + (uint32_t) pdu[4]))
+            return MODBUS_EX_ILLEGAL_VALUE;
+        quantity = MODBUS_U16(pdu + 2);
+        if ((quantity == 0) || (quantity > MODBUS_MAX_WRITE) || (pdu[4] != 2 * quantity))
+            return MODBUS_EX_ILLEGAL_VALUE;
+    }
+
+    first = MODBUS_U16(pdu);
+    if ((slave -> write_holding == NULL) || ((uint32_t) first + quantity > slave -> holding_count))
+        return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    if (function == MODBUS_WRITE_SINGLE)
+        result = slave -> write_holding(first, MODBUS_U16(pdu + 2));
+    else                                                // Se detiene en el primer valor rechazado;
+        for (i = 0, result = MODBUS_EX_NONE; (i < quantity) && (result == MODBUS_EX_NONE); i++)
+            result = slave -> write_holding(first + i, MODBUS_U16(pdu + 5 + 2 * i));   // los anteriores quedan escritos.
+
+    if (result != MODBUS_EX_NONE)
+        return result;
+
+    for (i = 0; i < 4; i++)                             // Eco de la dirección y del valor o la cantidad.
+        response[2 + i] = pdu[i];
+    *size = 6;
+    return MODBUS_EX_NONE;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : modbus_process
+* Returned Value   : Bytes de la respuesta, con CRC (0: no se responde).
+* Comments         :
+*    Valida la trama completa (largo y CRC), descarta las de otros esclavos y
+*    ejecuta la función. Las tramas broadcast solo aplican escrituras y nunca
+*    se responden. 'response' necesita MODBUS_MAX_FRAME bytes.
+*
+*END***********************************************************************************/
+
+uint32_t modbus_process (MODBUS_SLAVE_PTR slave, const uint8_t * request, uint32_t length, uint8_t * response)
+{
+    uint8_t  function, result;
+    uint32_t size = 0;
+
+    if ((length < MODBUS_MIN_FRAME) || (length > MODBUS_MAX_FRAME) ||
+        (modbus_crc16(request, length - 2) != (request[length - 2] | (request[length - 1] << 8))))
+    {
+        slave -> errors++;
+        return 0;
+    }
+
+    if ((request[0] != slave -> address) && (request[0] != MODBUS_BROADCAST))
+        return 0;
+
+    slave -> requests++;
+    function    = request[1];
+    response[0] = slave -> address;
+    response[1] = function;
+
+    switch (function)
+    {
+        case MODBUS_READ_HOLDING:
+            result = modbus_read(slave -> read_holding, slave -> holding_count, request + 2, length - 4, response, &size);
+            break;
+
+        case MODBUS_READ_INPUT:
+            result = modbus_read(slave -> read_input, slave -> input_count, request + 2, length - 4, response, &size);
+            break;
+
+        case MODBUS_WRITE_SINGLE:
+        case MODBUS_WRITE_MULTIPLE:
+            result = modbus_write(slave, function, request + 2, length - 4, response, &size);
+            break;
+
+        default:
+            result = MODBUS_EX_ILLEGAL_FUNCTION;
+            break;
+    }
+
+    if (request[0] == MODBUS_BROADCAST)
+        return 0;
+
+    if (result != MODBUS_EX_NONE)
+    {
+        slave -> exceptions++;
+        response[1] = function | 0x80;
+        response[2] = result;
+        size = 3;
+    }
+
+    return modbus_seal(response, size);
+}
@@ -0,0 +1,61 @@
+ //FileName:        modbus_rtu.h
+ //Dependencies:    stdint.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Esclavo Modbus RTU: validación de tramas y funciones de registros. Header File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#ifndef MODBUS_RTU_H_
+#define MODBUS_RTU_H_
+
+#include <stdint.h>
+
+// Límites de la trama RTU (dirección + PDU + CRC).
+#define MODBUS_MAX_FRAME            256
+#define MODBUS_MIN_FRAME            4           // Dirección, función y CRC.
+#define MODBUS_BROADCAST            0
+#define MODBUS_MAX_READ             125         // Registros por lectura.
+#define MODBUS_MAX_WRITE            123         // Registros por escritura múltiple.
+
+// Funciones soportadas.
+#define MODBUS_READ_HOLDING         0x03
+#define MODBUS_READ_INPUT           0x04
+#define MODBUS_WRITE_SINGLE         0x06
+#define MODBUS_WRITE_MULTIPLE       0x10
+
+// Códigos de excepción.
+#define MODBUS_EX_NONE              0x00
+#define MODBUS_EX_ILLEGAL_FUNCTION  0x01
+#define MODBUS_EX_ILLEGAL_ADDRESS   0x02
+#define MODBUS_EX_ILLEGAL_VALUE     0x03
+#define MODBUS_EX_DEVICE_FAILURE    0x04
+
+// Esclavo: dirección, mapa de registros (por funciones de la aplicación) y contadores.
+// No toca el HW: recibe una trama completa y arma la respuesta, así que también
+// compila en la PC para probarlo contra un maestro.
+typedef struct modbus_slave
+{
+   uint8_t    address;                                  // 1..247.
+   uint16_t   holding_count;                            // Registros 0..holding_count - 1 (funciones 3, 6 y 16).
+   uint16_t   input_count;                              // Registros 0..input_count - 1 (función 4).
+
+   uint16_t   (*read_holding)  (uint16_t reg);
+   uint16_t   (*read_input)    (uint16_t reg);
+   uint8_t    (*write_holding) (uint16_t reg, uint16_t value);   // MODBUS_EX_NONE o la excepción.
+
+   uint32_t   requests;                                 // Tramas válidas para este esclavo (o broadcast).
+   uint32_t   errors;                                   // Tramas descartadas por CRC o largo.
+   uint32_t   exceptions;                               // Respuestas de excepción enviadas.
+
+} MODBUS_SLAVE, * MODBUS_SLAVE_PTR;
+
+// CRC-16 de Modbus (0xA001 reflejado, inicial 0xFFFF); se transmite el byte bajo primero.
+extern uint16_t modbus_crc16   (const uint8_t * data, uint32_t length);
+
+// Procesa una trama recibida; regresa los bytes de la respuesta (0: no se responde).
+extern uint32_t modbus_process (MODBUS_SLAVE_PTR slave, const uint8_t * request, uint32_t length, uint8_t * response);
+
+#endif /* MODBUS_RTU_H_ */
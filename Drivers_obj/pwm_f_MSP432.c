@@ -0,0 +1,322 @@
+ //FileName:        pwm_f_MSP432.c
+ //Dependencies:    system.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Driver para PWM (Timer_A) por medio de archivos. Source File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#include "HVAC.h"
+
+extern GPIO_PIN_MAP gpio_global_pin_map;                       // Los pines de PWM no se pueden abrir como GPIO.
+
+// Registros de cada Timer_A.
+static Timer_A_Type _PTR_ const PWM_MODULE[PWM_MAX_TIMERS] = { TIMER_A0, TIMER_A1, TIMER_A2, TIMER_A3 };
+
+// Pin de salida de cada comparador: {puerto (0 -> P1), bit}. Función primaria (PxSEL0 = 1).
+static const uint_8 PWM_PIN[PWM_MAX_TIMERS][PWM_MAX_CCR][2] =
+{
+    { {1, 4}, {1, 5}, {1, 6}, {1, 7} },     // TA0.1..4 -> P2.4..P2.7 (apartado para SYS/BIOS).
+    { {6, 7}, {6, 6}, {6, 5}, {6, 4} },     // TA1.1..4 -> P7.7..P7.4.
+    { {4, 6}, {4, 7}, {5, 6}, {5, 7} },     // TA2.1..4 -> P5.6, P5.7, P6.6, P6.7.
+    { {9, 5}, {7, 2}, {8, 2}, {8, 3} }      // TA3.1..4 -> P10.5, P8.2, P9.2, P9.3.
+};
+
+// Canales abiertos y configuración compartida por módulo (periodo 0: módulo libre).
+// TA0 es el tick del Clock de SYS/BIOS (TimerProxy en 0x40000000): nace apartado.
+static PWM_DEV_DATA_PTR pwm_channels  [PWM_MAX_TIMERS][PWM_MAX_CCR] = { 0 };
+static uint_32          pwm_period    [PWM_MAX_TIMERS] = { PWM_TIMER_RESERVED, 0, 0, 0 };  // Cuentas por periodo (CCR0 + 1).
+static uint_32          pwm_divider   [PWM_MAX_TIMERS] = { 0 };     // ID * IDEX.
+static uint_32          pwm_frequency [PWM_MAX_TIMERS] = { 0 };     // Frecuencia pedida en Hz.
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_smclk
+* Returned Value   : Frecuencia de SMCLK en Hz.
+* Comments         :
+*    SystemInit deja SMCLK en la misma fuente que MCLK; solo se aplica su divisor.
+*
+*END***********************************************************************************/
+
+uint_32 pwm_smclk (void)
+{
+    return (BSP_SYSTEM_CLOCK) >> ((CS -> CTL1 & CS_CTL1_DIVS_MASK) >> CS_CTL1_DIVS_OFS);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_timer_reserve
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Aparta un Timer_A sin canales abiertos para otro driver; desde ahí
+*    pwm_open lo rechaza. No hay liberación: se aparta para siempre.
+*
+*END***********************************************************************************/
+
+_mqx_int pwm_timer_reserve (uint_32 timer)
+{
+    _mqx_int result = IO_ERR;
+
+    if (timer >= PWM_MAX_TIMERS)
+        return IO_ERR;
+
+    Int_disable();
+    if (pwm_period[timer] == 0)
+    {
+        pwm_period[timer] = PWM_TIMER_RESERVED;
+        result = IO_OK;
+    }
+    Int_enable();
+
+    return result;
+}
+
+/* Escribe el ciclo de trabajo de un canal; 0 y 1000 fijan la salida sin comparar. */
+static void pwm_write_duty (PWM_DEV_DATA_PTR channel, uint_32 duty)
+{
+    if (duty > PWM_DUTY_FULL)
+        duty = PWM_DUTY_FULL;
+    if (duty == channel -> duty)                                // Sin cambio: no se toca el HW.
+        return;
+
+    if (duty == 0)
+        channel -> module -> CCTL[channel -> ccr] = TIMER_A_CCTLN_OUTMOD_0;                      // Siempre en bajo.
+    else if (duty == PWM_DUTY_FULL)
+        channel -> module -> CCTL[channel -> ccr] = TIMER_A_CCTLN_OUTMOD_0 | TIMER_A_CCTLN_OUT;  // Siempre en alto.
+    else
+    {
+        channel -> module -> CCR[channel -> ccr]  = (pwm_period[channel -> timer] * duty) / PWM_DUTY_FULL;
+        channel -> module -> CCTL[channel -> ccr] = TIMER_A_CCTLN_OUTMOD_7;                      // Reset/set.
+    }
+
+    channel -> duty = duty;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_timer_config
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Elige el menor divisor (ID x IDEX) con el que el periodo cabe en 16 bits,
+*    programa CCR0 en modo 'up' y reescala los canales abiertos del módulo.
+*
+*END***********************************************************************************/
+
+static _mqx_int pwm_timer_config (uint_32 timer, uint_32 frequency)
+{
+    Timer_A_Type _PTR_ module = PWM_MODULE[timer];
+    uint_32            counts, id, ex, best = 0, best_id = 0, best_ex = 0, duty, i;
+
+    if (frequency == 0)
+        return IO_ERR;
+
+    counts = pwm_smclk() / frequency;
+    for (id = 0; id < 4; id++)                                  // ID: 1, 2, 4, 8.
+        for (ex = 1; ex <= 8; ex++)                             // IDEX: 1..8.
+            if ((((counts >> id) / ex) <= 0x10000) && ((best == 0) || ((ex << id) < best)))
+            {
+                best    = ex << id;
+                best_id = id;
+                best_ex = ex;
+            }
+
+    if (best == 0)
+        return IO_ERR;                                          // Frecuencia demasiado baja.
+    counts = (counts >> best_id) / best_ex;
+    if (counts < 2)
+        return IO_ERR;                                          // Frecuencia demasiado alta.
+
+    module -> CTL    = TIMER_A_CTL_MC__STOP;
+    module -> EX0    = best_ex - 1;
+    module -> CTL    = TIMER_A_CTL_SSEL__SMCLK | (best_id << TIMER_A_CTL_ID_OFS) | TIMER_A_CTL_CLR;
+    module -> CCR[0] = counts - 1;
+
+    pwm_period[timer]    = counts;
+    pwm_divider[timer]   = best;
+    pwm_frequency[timer] = frequency;
+
+    for (i = 0; i < PWM_MAX_CCR; i++)                           // Mismo ciclo sobre el nuevo periodo.
+        if (pwm_channels[timer][i] != NULL)
+        {
+            duty = pwm_channels[timer][i] -> duty;
+            pwm_channels[timer][i] -> duty = PWM_DUTY_FULL + 1;
+            pwm_write_duty(pwm_channels[timer][i], duty);
+        }
+
+    module -> CTL |= TIMER_A_CTL_MC__UP;
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_open
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Reserva el canal, configura el Timer_A (el primer canal del módulo fija la
+*    frecuencia) y pasa el pin a su función de salida del comparador.
+*
+*END***********************************************************************************/
+
+_mqx_int pwm_open (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags)
+{
+    PWM_INIT_STRUCT_PTR init = (PWM_INIT_STRUCT_PTR) flags;
+    PWM_DEV_DATA_PTR    channel;
+    uint_32             addr;
+    uint_8              port, mask;
+
+    if ((init == NULL) || (init -> timer >= PWM_MAX_TIMERS) || (init -> ccr == 0) || (init -> ccr > PWM_MAX_CCR))
+        return IO_ERR;
+
+    if (NULL == (channel = (PWM_DEV_DATA_PTR) malloc(sizeof(PWM_DEV_DATA))))
+        return IO_ERR;
+
+    port = PWM_PIN[init -> timer][init -> ccr - 1][0];
+    mask = 1 << PWM_PIN[init -> timer][init -> ccr - 1][1];
+    addr = GPIO_PORT_ADDR[port];
+
+    channel -> module = PWM_MODULE[init -> timer];
+    channel -> timer  = init -> timer;
+    channel -> ccr    = init -> ccr;
+    channel -> duty   = PWM_DUTY_FULL + 1;                      // Fuerza la primera escritura.
+    channel -> port   = port;
+    channel -> mask   = mask;
+
+    Int_disable();
+
+    if ((pwm_period[init -> timer] == PWM_TIMER_RESERVED) ||        // Módulo de otro driver,
+        (pwm_channels[init -> timer][init -> ccr - 1] != NULL) ||   // comparador ocupado,
+        (gpio_global_pin_map.memory8[port] & mask) ||               // pin ocupado por GPIO,
+        ((pwm_period[init -> timer] != 0) && (pwm_frequency[init -> timer] != init -> frequency)) ||
+        ((pwm_period[init -> timer] == 0) && (pwm_timer_config(init -> timer, init -> frequency) != IO_OK)))
+    {                                                               // u otra frecuencia en el módulo.
+        Int_enable();
+        free(channel);
+        return IO_ERR;
+    }
+
+    pwm_channels[init -> timer][init -> ccr - 1] = channel;
+    gpio_global_pin_map.memory8[port] |= mask;
+
+    pwm_write_duty(channel, init -> duty);
+
+    HWREG8(addr + OFS_PADIR)  |=  mask;                         // Salida del comparador.
+    HWREG8(addr + OFS_PASEL1) &= ~mask;
+    HWREG8(addr + OFS_PASEL0) |=  mask;
+
+    fd_ptr -> DEV_DATA_PTR = (pointer) channel;
+
+    Int_enable();
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_close
+* Returned Value   : IO_OK
+* Comments         :
+*    Deja el pin como GPIO en bajo y libera el canal; con el último canal
+*    del módulo se detiene el Timer_A.
+*
+*END***********************************************************************************/
+
+_mqx_int pwm_close (FILE _PTR_ fd_ptr)
+{
+    PWM_DEV_DATA_PTR       channel;
+    FILE_f                 struct_file[1];
+    FILE_PTR_f             struct_file_ptr;
+    uint_32                i, addr;
+
+    Int_disable();
+
+    fread(struct_file, sizeof(struct_file), 1, fd_ptr);
+    rewind(fd_ptr);
+
+    struct_file_ptr = struct_file;
+    channel = (PWM_DEV_DATA_PTR) struct_file_ptr -> DEV_DATA_PTR;
+    addr = GPIO_PORT_ADDR[channel -> port];
+
+    HWREG8(addr + OFS_PAOUT)  &= ~channel -> mask;              // Pin de vuelta a GPIO, en bajo.
+    HWREG8(addr + OFS_PASEL0) &= ~channel -> mask;
+    gpio_global_pin_map.memory8[channel -> port] &= ~channel -> mask;
+
+    channel -> module -> CCTL[channel -> ccr] = TIMER_A_CCTLN_OUTMOD_0;
+    pwm_channels[channel -> timer][channel -> ccr - 1] = NULL;
+
+    for (i = 0; (i < PWM_MAX_CCR) && (pwm_channels[channel -> timer][i] == NULL); i++);
+    if (i == PWM_MAX_CCR)                                       // Último canal del módulo.
+    {
+        channel -> module -> CTL = TIMER_A_CTL_MC__STOP;
+        pwm_period[channel -> timer] = 0;
+    }
+
+    free(channel);
+    free(fd_ptr);
+
+    Int_enable();
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_read
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Entrega el ciclo de trabajo actual (uint_32, en por mil).
+*
+*END***********************************************************************************/
+
+_mqx_int pwm_read (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num)
+{
+    PWM_DEV_DATA_PTR channel = (PWM_DEV_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
+
+    if ((data_ptr == NULL) || (num < sizeof(uint_32)))
+        return IO_ERR;
+
+    *(uint_32_ptr) data_ptr = channel -> duty;
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : pwm_ioctl
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Ciclo de trabajo y frecuencia del canal.
+*
+*END***********************************************************************************/
+
+_mqx_int pwm_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
+{
+    PWM_DEV_DATA_PTR channel = (PWM_DEV_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
+
+    if (param_ptr == NULL)
+        return IO_ERR;
+
+    switch (cmd)
+    {
+        case IOCTL_PWM_SET_DUTY:
+            if (*(uint_32_ptr) param_ptr > PWM_DUTY_FULL)
+                return IO_ERR;
+            pwm_write_duty(channel, *(uint_32_ptr) param_ptr);
+            break;
+
+        case IOCTL_PWM_GET_DUTY:
+            *(uint_32_ptr) param_ptr = channel -> duty;
+            break;
+
+        // Cambia la frecuencia de todo el módulo (todos sus canales conservan su ciclo).
+        case IOCTL_PWM_SET_FREQUENCY:
+            return pwm_timer_config(channel -> timer, *(uint_32_ptr) param_ptr);
+
+        case IOCTL_PWM_GET_FREQUENCY:
+            *(uint_32_ptr) param_ptr = pwm_smclk() / (pwm_divider[channel -> timer] * pwm_period[channel -> timer]);
+            break;
+
+        default:
+            return IO_ERR;
+    }
+
+    return IO_OK;
+}
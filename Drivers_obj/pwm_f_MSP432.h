@@ -0,0 +1,72 @@
+ //FileName:        pwm_f_MSP432.h
+ //Dependencies:    None.
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Driver para PWM (Timer_A) por medio de archivos. Header File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#ifndef PWM_F_MSP432_H_
+#define PWM_F_MSP432_H_
+
+// Definiciones de límites de recursos.
+#define PWM_MAX_TIMERS          4           // TA0..TA3 (TA0 siempre apartado).
+#define PWM_MAX_CCR             4           // CCR1..CCR4 (CCR0 fija el periodo).
+#define PWM_DUTY_FULL           1000        // Ciclo de trabajo en por mil.
+#define PWM_TIMER_RESERVED      0xFFFFFFFF  // Periodo de un módulo apartado con pwm_timer_reserve.
+
+// Módulos y comparadores, para la estructura de inicialización.
+#define PWM_TA0                 0           // Apartado: tick del Clock de SYS/BIOS; pwm_open lo rechaza.
+#define PWM_TA1                 1
+#define PWM_TA2                 2
+#define PWM_TA3                 3
+
+#define PWM_CCR1                1
+#define PWM_CCR2                2
+#define PWM_CCR3                3
+#define PWM_CCR4                4
+
+// Posibles instrucciones del PWM en IOCTL.
+#define IOCTL_PWM_SET_DUTY          (0x30000000)    // uint_32_ptr, en por mil (0..1000).
+#define IOCTL_PWM_GET_DUTY          (0x30000001)    // uint_32_ptr.
+#define IOCTL_PWM_SET_FREQUENCY     (0x30000002)    // uint_32_ptr, en Hz; aplica a todo el Timer_A.
+#define IOCTL_PWM_GET_FREQUENCY     (0x30000003)    // uint_32_ptr, frecuencia real obtenida.
+
+// Estructura de inicialización de un canal: módulo Timer_A, comparador de salida,
+// frecuencia y ciclo inicial. Los canales de un mismo módulo comparten frecuencia.
+typedef struct pwm_init_struct
+{
+   uint_32   timer;                                     // PWM_TA1..PWM_TA3.
+   uint_32   ccr;                                       // PWM_CCR1..PWM_CCR4.
+   uint_32   frequency;                                 // En Hz.
+   uint_32   duty;                                      // Ciclo inicial en por mil.
+
+} PWM_INIT_STRUCT, _PTR_ PWM_INIT_STRUCT_PTR;
+
+// Estructura de cada canal abierto.
+typedef struct pwm_device_struct
+{
+   Timer_A_Type _PTR_    module;                        // Registros del Timer_A.
+   uint_32               timer;
+   uint_32               ccr;
+   uint_32               duty;                          // Último ciclo escrito, en por mil.
+   uint_8                port;                          // Pin de salida: puerto (0 -> P1) y máscara.
+   uint_8                mask;
+
+} PWM_DEV_DATA, _PTR_ PWM_DEV_DATA_PTR;
+
+// Funciones para abrir, cerrar, controlar y leer los canales PWM.
+extern _mqx_int pwm_open       (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags);
+extern _mqx_int pwm_close      (FILE _PTR_ fd_ptr);
+extern _mqx_int pwm_read       (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num);
+extern _mqx_int pwm_ioctl      (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr);
+
+// Frecuencia de SMCLK según la configuración actual de CS.
+extern uint_32  pwm_smclk      (void);
+
+// Aparta un Timer_A completo para otro driver (p. ej. los tiempos de Modbus).
+extern _mqx_int pwm_timer_reserve (uint_32 timer);
+
+#endif /* PWM_F_MSP432_H_ */
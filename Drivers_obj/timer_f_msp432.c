@@ -1,524 +1,950 @@
- //FileName:        timer_f_msp432.c
- //Dependencies:    system.h
- //Processor:       MSP432
- //Board:			MSP432P401R
- //Program version: CCS V8.3 TI
- //Company:         Texas Instruments
- //Description:     Definicin de funciones del mdulo timer32. Source File.
- //Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- //Updated:         12/2018
-
-#include "HVAC.h"    
-
-// Tiempo que escala en pasos de la variable step hasta llegar al periodo deseado de cada unidad.
-_mqx_uint  microsecs = 0;
-
-// Estructuras generales, son reservadas dinmicamente.
-TIMER_PTR timer = NULL;                                         // Timer general.
-TIMER_UNIT_DATA_PTR timer_units[MAX_TIMER_UNITS] = { 0 };       // Unidades.
-
-// Banderas al entrar a estados iniciales y bandera para funcionamiento de interrupciones.
-boolean timer_activated[2]              = {FALSE, FALSE};
-boolean bandera_stop                    = FALSE;
-
-// Arreglo con tiempos pausados (si los hay).
-uint_32 time_paused_left[MAX_TIMER_UNITS] = { 0 };
-
-// Arreglo con estados anteriores.
-uint_32 last_state[MAX_TIMER_UNITS] = { STOPPED };
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : Timer_Handler
-* Returned Value   : None.
-* Comments         :
-*    Funcin de interrupcin del mdulo timer32_2 para corrida de las unidades abiertas
-*    de los timers.
-*
-*END***********************************************************************************/
-
-void Timer_Handler(void)
-{
-    _mqx_int i;
-
-    Int_disable();                                              // Desactiva interrupciones.
-    TIMER32_2 -> INTCLR = 0;                                    // Borra bandera de timer32_2.
-
-    microsecs += timer -> step;                                 // Aumenta el tiempo tomado.
-    if (microsecs >= TIME_RESET)
-        microsecs = 0;
-
-
-    if(timer_activated[SOLO_TIMER] == TRUE)                     // Si este timer est activado:
-    {
-        for(i = 0; i < MAX_TIMER_UNITS; i++)                    // Evala cada una de las unidades.
-             {
-                 if(timer_units[i] == NULL)                     // No hay necesidad de entrar si no se ha reservado memoria.
-                     continue;
-
-                 // Si el tiempo se debe parar, debe venir de un estado de RUN o PAUSED o inmediatamente de un STOP.
-                 if(timer_units[i] -> state == STOPPED && (last_state[i] == RUN || last_state[i] == PAUSED
-                         || bandera_stop == FALSE))
-                 {
-                     // Vaca todos los recursos en cero's.
-                     timer -> time[SECONDS][i] = 0;
-                     timer -> time[MINUTES][i] = 0;
-                     timer -> time[HOURS][i]   = 0;
-                     timer -> time_left[i]   = SEC;
-
-                     // Coloca al timer en estado de STOPPED.
-                     last_state[i] = STOPPED;
-                     timer_units[i] -> state = STOPPED;
-                     timer_units[i] -> period_flag =   FALSE;
-                     bandera_stop = TRUE;
-
-                     return;
-                 }
-
-                 // Si el estado tiene que pausarse, debe venir del estado RUN.
-                 if(timer_units[i] -> state == PAUSED && last_state[i] == RUN)
-                 {
-                     time_paused_left[i] = timer -> time_left[i];   // Recuerda el tiempo restante al periodo.
-                     last_state[i] = PAUSED;                        // Pausa de la unidad.
-                     timer_units[i] -> state = PAUSED;
-
-                     return;
-                 }
-
-                 // En realidad solo hay 3 estados: RUN, PAUSED y STOPPED; RESUMED solo es un estado temporal,
-                 // que regresa a RUN.
-                 else if(timer_units[i] -> state == RESUMED)
-                 {
-                     if(last_state[i] == STOPPED)
-                     {
-                         timer_units[i] -> state = STOPPED;
-                         return;
-                     }
-
-                     else if(last_state[i] != RUN)
-                         timer -> time_left[i] = (time_paused_left[i] > 0)? time_paused_left[i]: SEC;
-
-                     time_paused_left[i] = 0;               // Limpia el valor pausado.
-                     timer_units[i] -> state = RUN;         // Pone al estado en corrida de nuevo.
-                     last_state[i] = RUN;                   // Lo mismo para el estado anterior.
-                 }
-
-                 // Estado de corrida principal.
-                 if(timer_units[i] -> state == RUN)
-                 {
-                       if(last_state[i] == STOPPED)
-                       {
-                             last_state[i] = RUN;           // Renueva el estado anterior como RUN.
-                             timer_units[i] -> state = RUN;
-                       }
-
-                       if(timer -> time_left[i] != 0)
-                       {
-                           bandera_stop = FALSE;
-
-                           // Disminuye la cuenta regresiva.
-                           timer -> time_left[i] -= timer -> step;
-                           if((timer -> time_left[i])/(timer -> step) == 0)                    // Al acabar esta cuenta, entra.
-                           {
-                               // Actualizacin y valores.
-                               last_state[i] = RUN;
-
-                               timer -> time_left[i] = timer -> time_full[i];                  // Se renueva contador (tiempo).
-                               timer -> time[SECONDS][i] += ((timer -> time_full[i]) / SEC);
-
-                               if(timer -> time[SECONDS][i] >= 60)                             // Actualiza segundos.
-                               {
-                                   timer -> time[SECONDS][i] = 0;
-                                   timer -> time[MINUTES][i] += 1;
-
-                                   if(timer -> time[MINUTES][i] >= 60)                         // Actualiza minutos.
-                                   {
-                                       timer -> time[MINUTES][i] = 0;
-                                       timer -> time[HOURS][i] += 1;
-
-                                       if(timer -> time[HOURS][i] >= 24)                       // Actualiza horas.
-                                           timer -> time[HOURS][i] = 0;
-                                   }
-                               }
-
-                               // Zona de banderas y toggles de periodo en caso de que estn permitidos.
-                               if(timer_units[i] -> flags[P_TOGGLE] == TRUE)
-                               {
-                                   if(timer_units[i] -> period_toggle == TRUE)
-                                        timer_units[i] -> period_toggle = FALSE;
-                                    else
-                                        timer_units[i] -> period_toggle = TRUE;
-                               }
-
-                               // Ha ocurrido un periodo.
-                               if(timer_units[i] -> flags[P_FLAG] == TRUE)
-                                   timer_units[i] -> period_flag = TRUE;
-
-                               // Si se llega a la cuenta mxima prescrita, reinicia el conteo y activa bandera.
-                               if (timer -> time[HOURS][i] >= (timer_units[i] -> max[HOURS]))
-                                   if(timer -> time[MINUTES][i] >= (timer_units[i] -> max[MINUTES]))
-                                       if(timer -> time[SECONDS][i] >= (timer_units[i] -> max[SECONDS]))
-                                       {
-                                           // Reinicio.
-                                           timer -> time[SECONDS][i] = 0;
-                                           timer -> time[MINUTES][i] = 0;
-                                           timer -> time[HOURS][i] = 0;
-
-                                           // Zona de banderas y acciones al terminar la cuenta.
-                                           if(timer_units[i] -> flags[P_END] == TRUE)
-                                           {
-                                               timer_units[i] -> period_end  = TRUE;
-                                               timer_units[i] -> period_flag = FALSE;
-                                           }
-
-                                           // Si tiene la etiqueta 'MAX AND STOPPED', entrar al if.
-                                           if(timer_units[i] -> flags[M_STOPPED] == TRUE)
-                                           {
-                                               timer_units[i] -> state = STOPPED;
-                                               last_state[i] =     STOPPED;
-                                           }
-
-                                       }    // Fin if(timer -> time[HOURS]...
-                           }    // Fin if(timer -> time_left/step ...
-                      }     // Fin if(timer -> time_left != 0 ...
-                 }  // Fin if (timer_units[i] -> state == RUN ...
-             }  // Fin for(i = 0 ...
-    }   // Fin if(timer_activated ...
-
-    // Renueva las interrupciones.
-    Int_enable();
-
-   return;
-}
-
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : clean timer
-* Returned Value   : None.
-* Comments         :
-*    Limpia todos los valores; se usa cuando reserva dinmicamente las estructuras
-*    principales del mdulo y unidades y tienen valores desconocidos (basura).
-*
-*END***********************************************************************************/
-
-void clean_timer (void)
-{
-    uint_32 i, j;
-
-    if(timer == NULL)
-        return;
-
-    // Limpieza en cero's.
-    for(i = 0; i < 3; i++)
-        for(j = 0; j < MAX_TIMER_UNITS; j++)
-        {
-            timer -> time[i][j] = 0;
-            if(i == 0)
-            {
-                timer -> time_full[j] = 0;  // Limpieza de tiempos menores al periodo.
-                timer -> time_left[j] = 0;
-            }
-        }
-    return;
-}
-
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : timer_open
-* Returned Value   : int de inicializacin correcta.
-* Comments         :
-*    Reserva memoria e inicializa los recursos de los drivers.
-*
-*END***********************************************************************************/
-
-_mqx_int timer_open  (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags)
-{
-    char_ptr file_name_ptr = fd_ptr->DEV_PTR->IDENTIFIER;
-    _mqx_int flag;
-
-    while (*file_name_ptr++ != 0)
-       open_name_ptr++;                                 // Mueve al nombre del archivo.
-    file_name_ptr = open_name_ptr;
-
-    // Inicializacin del mdulo principal "timer:".
-    if (*file_name_ptr == 0)
-    {
-        TIMER_INIT_STRUCT_PTR init_from = (TIMER_INIT_STRUCT_PTR) flags;
-
-        if (timer == NULL)
-        {
-           timer = (TIMER_PTR) malloc (sizeof(TIMER));  // Reserva memoria dinmica.
-           if (timer == NULL)
-              return IO_ERR;
-        }
-        else
-           return IO_ERR;
-
-        clean_timer();                                  // Limpieza general.
-
-        timer -> state_gral = init_from -> run_now;     // El estado depende de la configuracin recibida.
-        if((init_from -> step) > MINIMUM_LIMIT_STEP)    // Debe haber un mnimo ptimo para el step.
-            timer -> step = init_from -> step;
-
-        fd_ptr -> DEV_DATA_PTR = (pointer) init_from;   // La configuracin se guarda en el archivo FILE.
-
-        if(timer -> state_gral == RUN)
-            flag = timer_hw_init();                     // Inicializa el HW del timer.
-
-        return flag;
-    }
-
-    // Inicializacin de una unidad: "timer:n" para n < MAX_TIMER_UNITS.
-    else
-    {
-        TIMER_UNIT_INIT_STRUCT_PTR init_from = (TIMER_UNIT_INIT_STRUCT_PTR) flags;
-        _mqx_uint                   ch = 0;
-        _mqx_uint                   radix = 1;
-
-        if (init_from == NULL)
-           return IO_ERR;                                                      // No hay parmetros.
-
-       if (NULL == timer)                                                      // No se ha inicializado el mdulo principal.
-           return IO_ERR;
-
-          while ((*open_name_ptr >= '0') && (*open_name_ptr <= '9'))
-              open_name_ptr++;
-
-          if (*open_name_ptr != 0)
-             return IO_ERR;
-
-          open_name_ptr--;                                                     // Mueve al ltimo dgito de la cadena.
-
-          do
-          {
-             if (MAX_TIMER_UNITS <= (ch += radix * (*open_name_ptr - '0')))
-                return IO_ERR;                                                 // Nmero excedido.
-             radix *= 10;
-          }
-          while (open_name_ptr-- != file_name_ptr);
-
-          if(ch > MAX_TIMER_UNITS)
-              return IO_ERR;
-
-          if (timer_units[ch] == NULL)                                         // Reservacin dinmica de la unidad.
-          {
-              timer_units[ch] = (TIMER_UNIT_DATA_PTR) malloc (sizeof(TIMER_UNIT_DATA));
-             if (timer_units[ch] == NULL)
-                return IO_ERR;
-          }
-          else
-             return IO_ERR;                                                    // Unidad ya usada por un archivo.
-
-        // Con esto inicia la configuracin deseada.
-        timer_units[ch] -> num = ch;
-
-        // Banderas y toggles.
-        timer_units[ch] -> flags[M_STOPPED] = (init_from -> flags & (1 << M_STOPPED)) != 0;
-        timer_units[ch] -> flags[P_FLAG]    = (init_from -> flags & (1 << P_FLAG))    != 0;
-        timer_units[ch] -> flags[P_TOGGLE]  = (init_from -> flags & (1 << P_TOGGLE))  != 0;
-        timer_units[ch] -> flags[P_END]     = (init_from -> flags & (1 << P_END))     != 0;
-        timer_units[ch] -> period_flag   = FALSE;
-        timer_units[ch] -> period_end    = FALSE;
-        timer_units[ch] -> period_toggle = FALSE;
-
-        // Tiempo mximo.
-        timer_units[ch] -> max[SECONDS] = (init_from -> max[SECONDS]);
-        timer_units[ch] -> max[MINUTES] = (init_from -> max[MINUTES]);
-        timer_units[ch] -> max[HOURS]   = (init_from -> max[HOURS]);
-
-        // Periodo y estado.
-        timer_units[ch] -> scale = init_from -> time_period;
-        timer_units[ch] -> state = init_from -> state;
-
-        // Tiempo lleno y si est en run, tiempo por recorrer.
-        timer -> time_full[ch] = (init_from -> time_period)*SEC;
-        if(timer_units[ch] -> state == RUN)
-            timer -> time_left[ch] = (init_from -> time_period)*SEC;
-
-       // Pasa a formar parte del archivo.
-       fd_ptr -> DEV_DATA_PTR = (pointer) timer_units[ch];
-
-       return IO_OK;
-    }
-}
-
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : timer_hw_init
-* Returned Value   : int de inicializacin correcta.
-* Comments         :
-*    Presenta funciones interrupciones y arranca el timer a travs de los registros.
-*
-*END***********************************************************************************/
-
- _mqx_int timer_hw_init (void)
-{
-     static boolean bandera_interrupt_time = FALSE;
-
-     if(!bandera_interrupt_time)
-     {
-         Int_registerInterrupt(INT_T32_INT2, Timer_Handler);
-         Int_enableInterrupt(INT_T32_INT2);
-         bandera_interrupt_time = 1;
-     }
-
-     TIMER32_2 -> CONTROL |= TIMER32_CONTROL_ENABLE;
-     TIMER32_2 -> LOAD = ((__SYSTEM_CLOCK)/(SEC))*(STEP) - 1;                    // Valor a cargar.
-     TIMER32_2 -> CONTROL = 0xC2;                                                // 32 bit, peridicamente, con base de tiempo.
-     TIMER32_2 -> CONTROL |= TIMER32_CONTROL_PRESCALE_0;                         // No hay prescaler.
-     TIMER32_2 -> CONTROL |= TIMER32_CONTROL_IE;                                 // Habilita interrupcin.
-     timer_activated[SOLO_TIMER] = 1;
-
-     return IO_OK;
-}
-
-
- /*FUNCTION******************************************************************************
- *
- * Function Name    : timer_ioctl
- * Returned Value   : entero de control correcto.
- * Comments         :
- *    Controla las unidades cambindolos, o actualizando banderas o cadenas.
- *
- *END***********************************************************************************/
-
-_mqx_int timer_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
-{
-   //uint_32 num = (uint_32) param_ptr;                                              // Pensado para futuras definiciones.
-   TIMER_UNIT_DATA_PTR dev_data_ptr = (TIMER_UNIT_DATA_PTR) fd_ptr -> DEV_DATA_PTR;  // Recoge instruccin.
-
-   Int_disable();                                                                    // Inhabilita interrupciones.
-
-   if(param_ptr != NULL)                                                             // Si se recibe algo diferente de NULL.
-   {                                                                                 // Se desea modificar timer principal.
-       switch (cmd)                                                                  // Modifica timer principal.
-       {
-           case IOCTL_TIMER_RUN:    timer -> state_gral = RUN;      break;
-           case IOCTL_TIMER_RESUME: timer -> state_gral = RESUMED;  break;
-           case IOCTL_TIMER_PAUSE:  timer -> state_gral = PAUSED;   break;
-           case IOCTL_TIMER_STOP:   timer -> state_gral = STOPPED;  break;
-           default:                                                 break;
-       }
-   }
-
-   else if((dev_data_ptr -> num) < (MAX_TIMER_UNITS + 1))                             // Si null es recibido.
-   {
-       switch (cmd)                                                                   // Modifica unidad.
-       {
-           case IOCTL_TIMER_RUN:    timer_units[dev_data_ptr -> num] -> state = RUN;                break;
-           case IOCTL_TIMER_RESUME: timer_units[dev_data_ptr -> num] -> state = RESUMED;            break;
-           case IOCTL_TIMER_PAUSE:  timer_units[dev_data_ptr -> num] -> state = PAUSED;             break;
-           case IOCTL_TIMER_STOP:   timer_units[dev_data_ptr -> num] -> state = STOPPED;
-                                    timer_units[dev_data_ptr -> num] -> period_flag =   FALSE;
-                                    timer_units[dev_data_ptr -> num] -> period_toggle = FALSE;      break;
-           default:                                                                                 break;
-       }
-
-       fd_ptr -> DEV_DATA_PTR = (pointer) timer_units[dev_data_ptr -> num];          // Actualiza archivo.
-   }
-
-   Int_enable();                                                                    // Renueva interrupciones.
-   return IO_OK;
-}
-
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : timer_close
-* Returned Value   : entero de control correcto.
-* Comments         :
-*    Cierra los archivos correspondientes de memoria.
-*
-*END***********************************************************************************/
-
-_mqx_int timer_close (FILE _PTR_ fd_ptr)
-{
-    uint_32 i;
-
-    Int_disable();
-    if(timer_activated[SOLO_TIMER])
-    {
-        TIMER32_2 -> CONTROL &= ~TIMER32_CONTROL_IE;    // Apaga el timer32_2.
-        TIMER32_2 -> LOAD = 0XFFFFFFFF;
-        timer_activated[SOLO_TIMER] = FALSE;
-    }
-
-    if(timer != NULL)
-        free(timer);
-
-    for(i = 0; i < MAX_TIMER_UNITS; i++)                // Cierra las unidades abiertas.
-    {
-        if(timer_units[i] != NULL)
-            free(timer_units[i]);
-    }
-
-    free(fd_ptr);                                       // Cierra el archivo.
-
-    Int_enable();
-    return IO_OK;
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : timer_read
-* Returned Value   : entero de control correcto.
-* Comments         :
-*    Lectura de banderas, cadenas y tiempo de una unidad.
-*
-*END***********************************************************************************/
-
-_mqx_int timer_read  (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num)
-{
-    uint_32_ptr dir;
-    char_ptr    dir_string;
-    TIMER_UNIT_DATA_PTR dev_data_ptr = (TIMER_UNIT_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
-
-    // Dependiendo del formato, se leer un numrico o una cadena.
-
-    if(num < T_STRING)
-        dir =  (uint_32_ptr) data_ptr;
-    else if(num == T_STRING)
-        dir_string = (char_ptr) data_ptr;
-    else
-        return IO_ERR;
-
-    // Desactiva interrupciones.
-    Int_disable();
-
-    switch(num)
-    {
-        // Lectura de period_flag y limpieza de esta bandera.
-        case P_FLAG:        *dir = timer_units[dev_data_ptr -> num] -> period_flag;
-                            timer_units[dev_data_ptr -> num] -> period_flag = 0;            break;
-
-        // Lectura de period_toggle.
-        case P_TOGGLE:      *dir = timer_units[dev_data_ptr -> num] -> period_toggle;       break;
-
-        // Lectura de period_end (cuando se llegue al tiempo mximo).
-        case P_END:         *dir = timer_units[dev_data_ptr -> num] -> period_end;
-                            timer_units[dev_data_ptr -> num] -> period_end = 0;             break;
-
-        // Lectura de milisegundos (base 1000).
-        case T_MILLIS:      *dir = (timer -> time_left[dev_data_ptr -> num])/1000;          break;
-
-        // Lectura de un tiempo.
-        case T_SECONDS:     *dir = timer -> time[SECONDS][dev_data_ptr -> num];             break;
-        case T_MINUTES:     *dir = timer -> time[MINUTES][dev_data_ptr -> num];             break;
-        case T_HOURS:       *dir = timer -> time[HOURS]  [dev_data_ptr -> num];             break;
-
-        // Lectura del tiempo pero en formato de una cadena.
-        case T_STRING:      sprintf(dir_string, "%02d:%02d:%02d\n\r",
-                            timer -> time[HOURS][dev_data_ptr -> num],
-                            timer -> time[MINUTES][dev_data_ptr -> num],
-                            timer -> time[SECONDS][dev_data_ptr -> num]);                   break;
-        default:                                                                            break;
-    }
-
-    fd_ptr -> DEV_DATA_PTR = (pointer) timer_units[dev_data_ptr -> num];                    // Actualiza archivo.
-    Int_enable();                                                                           // Renueva interrupciones.
-
-    return IO_OK;
-}
+ //FileName:        timer_f_msp432.c
+ //Dependencies:    system.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Definición de funciones del módulo timer32. Source File.
+ //Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         12/2018
+
+#include "HVAC.h"
+
+// Estructura general, es reservada dinámicamente; las unidades cuelgan de ella.
+TIMER_PTR timer = NULL;                                         // Timer general, con la rueda de tiempos.
+
+// Banderas al entrar a estados iniciales y bandera para funcionamiento de interrupciones.
+boolean timer_activated[2]              = {FALSE, FALSE};
+
+// Funciones de otros drivers que reciben los ticks transcurridos.
+TIMER_HOOK timer_hooks[MAX_TIMER_HOOKS] = { 0 };
+
+// uS por tick del timer32_2: el step de "timer:" si está abierto, si no STEP.
+static uint_32 timer_tick = STEP;
+
+// Ciclos de la base de tiempo en el último tick contado; los ticks se alinean a él.
+static uint64_t timer_last = 0;
+
+// Interrupciones atendidas del timer32_2.
+volatile uint32_t timer_interrupts = 0;
+
+// Base de tiempo: vueltas completas del timer32_1 (los 32 bits altos de la cuenta).
+static volatile uint32_t timebase_epoch = 0;
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_wheel_insert
+* Returned Value   : None.
+* Comments         :
+*    Coloca una unidad en la rueda según los ticks que le faltan: en el nivel 0 si
+*    vence en menos de TIMER_WHEEL_SLOTS ticks, si no en el primer nivel cuya
+*    vuelta la alcanza. O(1).
+*
+*END***********************************************************************************/
+
+static void timer_wheel_insert (TIMER_UNIT_DATA_PTR unit)
+{
+    uint32_t delta = unit -> expires - timer -> now;
+    uint32_t level = 0;
+    TIMER_UNIT_DATA_PTR _PTR_ slot;
+
+    while((level < TIMER_WHEEL_LEVELS - 1) && ((delta >> (TIMER_WHEEL_BITS * (level + 1))) != 0))
+        level++;
+
+    slot = &timer -> wheel[level][(unit -> expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+
+    unit -> next  = *slot;                                      // Al frente de la ranura.
+    unit -> pprev = slot;
+    if(*slot != NULL)
+        (*slot) -> pprev = &unit -> next;
+    *slot = unit;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_wheel_remove
+* Returned Value   : None.
+* Comments         :
+*    Saca una unidad de su ranura (si está en la rueda). O(1).
+*
+*END***********************************************************************************/
+
+static void timer_wheel_remove (TIMER_UNIT_DATA_PTR unit)
+{
+    if(unit -> pprev == NULL)
+        return;
+
+    *unit -> pprev = unit -> next;
+    if(unit -> next != NULL)
+        unit -> next -> pprev = unit -> pprev;
+
+    unit -> next  = NULL;
+    unit -> pprev = NULL;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_wheel_cascade
+* Returned Value   : None.
+* Comments         :
+*    Vacía una ranura de un nivel superior y reparte sus unidades en los niveles
+*    de abajo, ahora que les faltan menos ticks.
+*
+*END***********************************************************************************/
+
+static void timer_wheel_cascade (uint32_t level, uint32_t index)
+{
+    TIMER_UNIT_DATA_PTR unit = timer -> wheel[level][index];
+    TIMER_UNIT_DATA_PTR next;
+
+    timer -> wheel[level][index] = NULL;
+
+    for(; unit != NULL; unit = next)
+    {
+        next = unit -> next;
+        timer_wheel_insert(unit);
+    }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_unit_expire
+* Returned Value   : None.
+* Comments         :
+*    Se cumplió un periodo de la unidad: actualiza su tiempo, banderas y toggle,
+*    revisa el tiempo máximo y, si sigue en corrida, la vuelve a programar.
+*    El siguiente vencimiento se cuenta desde el anterior y no desde el tick
+*    actual, con el resto en uS acumulado, así que no hay deriva.
+*
+*END***********************************************************************************/
+
+static void timer_unit_expire (TIMER_UNIT_DATA_PTR unit)
+{
+    uint_32 seconds, minutes;
+
+    // Actualización del tiempo contado; el periodo puede ser de más de un minuto.
+    seconds = unit -> time[SECONDS] + unit -> scale;
+    minutes = unit -> time[MINUTES] + seconds / 60;
+    unit -> time[SECONDS] = seconds % 60;
+    unit -> time[MINUTES] = minutes % 60;
+    unit -> time[HOURS]   = (unit -> time[HOURS] + minutes / 60) % 24;
+
+    // Zona de banderas y toggles de periodo en caso de que estén permitidos.
+    if(unit -> flags[P_TOGGLE] == TRUE)
+        unit -> period_toggle = !unit -> period_toggle;
+
+    // Ha ocurrido un periodo.
+    if(unit -> flags[P_FLAG] == TRUE)
+        unit -> period_flag = TRUE;
+
+    // Si se llega a la cuenta máxima prescrita, reinicia el conteo y activa bandera.
+    if((unit -> time[HOURS] * 3600 + unit -> time[MINUTES] * 60 + unit -> time[SECONDS]) >=
+       (unit -> max[HOURS]  * 3600 + unit -> max[MINUTES]  * 60 + unit -> max[SECONDS]))
+    {
+        // Reinicio.
+        unit -> time[SECONDS] = 0;
+        unit -> time[MINUTES] = 0;
+        unit -> time[HOURS]   = 0;
+
+        // Zona de banderas y acciones al terminar la cuenta.
+        if(unit -> flags[P_END] == TRUE)
+        {
+            unit -> period_end  = TRUE;
+            unit -> period_flag = FALSE;
+        }
+
+        // Si tiene la etiqueta 'MAX AND STOPPED', sale de la rueda.
+        if(unit -> flags[M_STOPPED] == TRUE)
+        {
+            unit -> state = STOPPED;
+            return;
+        }
+    }
+
+    // Siguiente vencimiento.
+    unit -> expires += unit -> period_ticks;
+    unit -> carry   += unit -> period_rem;
+    if(unit -> carry >= timer -> step)
+    {
+        unit -> carry -= timer -> step;
+        unit -> expires++;
+    }
+    timer_wheel_insert(unit);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_unit_run
+* Returned Value   : None.
+* Comments         :
+*    Pone una unidad en corrida. Desde PAUSED continúa con lo que le faltaba al
+*    periodo; desde STOPPED empieza un periodo completo, salvo con 'resume'
+*    (RESUME sobre una unidad detenida no hace nada).
+*
+*END***********************************************************************************/
+
+static void timer_unit_run (TIMER_UNIT_DATA_PTR unit, boolean resume)
+{
+    if(unit -> state == PAUSED)
+        unit -> expires = timer -> now + unit -> paused_left;
+    else if(unit -> state == STOPPED && !resume)
+    {
+        unit -> expires = timer -> now + unit -> period_ticks;
+        unit -> carry   = unit -> period_rem;                   // El resto del primer periodo ya cuenta.
+    }
+    else
+        return;                                                 // Ya está en corrida, o RESUME sobre STOPPED.
+
+    unit -> state = RUN;
+    timer_wheel_insert(unit);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_wheel_tick
+* Returned Value   : None.
+* Comments         :
+*    Avanza la rueda un tick: solo atiende las unidades que vencen en ese tick
+*    (más las que bajan de nivel cada TIMER_WHEEL_SLOTS ticks), sin importar
+*    cuántas haya abiertas.
+*
+*END***********************************************************************************/
+
+static void timer_wheel_tick (void)
+{
+    TIMER_UNIT_DATA_PTR unit, next;
+    uint32_t index, level;
+
+    timer -> now++;                                             // Tick que acaba de transcurrir.
+
+    // Al completar una vuelta de un nivel, baja la siguiente ranura del nivel de arriba.
+    index = timer -> now & TIMER_WHEEL_MASK;
+    for(level = 1; (index == 0) && (level < TIMER_WHEEL_LEVELS); level++)
+    {
+        index = (timer -> now >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+        timer_wheel_cascade(level, index);
+    }
+
+    // Todas las unidades de esta ranura vencen en este tick.
+    index = timer -> now & TIMER_WHEEL_MASK;
+    unit = timer -> wheel[0][index];
+    timer -> wheel[0][index] = NULL;
+
+    for(; unit != NULL; unit = next)
+    {
+        next = unit -> next;
+        unit -> next  = NULL;
+        unit -> pprev = NULL;
+        timer_unit_expire(unit);
+    }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_wheel_next
+* Returned Value   : Ticks (1..limit) a lo siguiente que pasa en la rueda.
+* Comments         :
+*    Recorre cada nivel en los ticks donde puede tener trabajo: los siguientes
+*    TIMER_WHEEL_SLOTS ticks para el nivel 0, los siguientes múltiplos de 64
+*    para el nivel 1, etc., y regresa el primero en que timer_wheel_tick
+*    atendería una ranura ocupada (vencimiento o bajada de nivel). Solo revisa
+*    si las ranuras están vacías, así que cuesta lo mismo con cualquier número
+*    de unidades: a lo más TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS ranuras.
+*    Si no hay nada antes, 'limit'.
+*
+*END***********************************************************************************/
+
+static uint32_t timer_wheel_next (uint32_t limit)
+{
+    uint32_t level, sub, shift, tick, delta, index, k;
+    boolean  busy;
+
+    for(level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = TIMER_WHEEL_BITS * level;
+        for(k = 1; k <= TIMER_WHEEL_SLOTS; k++)
+        {
+            tick  = ((timer -> now >> shift) + k) << shift;
+            delta = tick - timer -> now;
+            if(delta >= limit)
+                return limit;
+
+            // La ranura del nivel 0 y las que bajarían de nivel en este tick.
+            index = tick & TIMER_WHEEL_MASK;
+            busy  = (timer -> wheel[0][index] != NULL);
+            for(sub = 1; !busy && (index == 0) && (sub < TIMER_WHEEL_LEVELS); sub++)
+            {
+                index = (tick >> (TIMER_WHEEL_BITS * sub)) & TIMER_WHEEL_MASK;
+                busy  = (timer -> wheel[sub][index] != NULL);
+            }
+
+            if(busy)
+                return delta;
+        }
+    }
+
+    return limit;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_sync
+* Returned Value   : None.
+* Comments         :
+*    Cuenta los ticks completos que pasaron desde el último (con la base de
+*    tiempo) y los entrega: los ganchos reciben los uS de una vez y la rueda
+*    salta directo a los ticks donde tiene trabajo. Se llama con interrupciones
+*    desactivadas, antes de cambiar cualquier cuenta.
+*
+*END***********************************************************************************/
+
+void timer_sync (void)
+{
+    uint32_t cycles = TIMEBASE_TICKS_PER_US * timer_tick;      // Ciclos de MCLK por tick.
+    uint64_t elapsed;
+    uint32_t ticks, delta;
+    _mqx_int i;
+
+    if(!timer_activated[SOLO_TIMER])
+        return;
+
+    elapsed = (timer_timebase_ticks() - timer_last) / cycles;
+    if(elapsed == 0)
+        return;
+
+    ticks = (elapsed > TIMER_HOOK_IDLE / timer_tick)? TIMER_HOOK_IDLE / timer_tick : (uint32_t) elapsed;
+    timer_last += elapsed * cycles;
+
+    for(i = 0; i < MAX_TIMER_HOOKS; i++)                        // Funciones enganchadas al tick (antirrebote, etc.).
+        if(timer_hooks[i] != NULL)
+            timer_hooks[i](ticks * timer_tick);
+
+    // La rueda solo avanza con el archivo "timer:" abierto y en corrida.
+    if(timer != NULL && timer -> state_gral == RUN)
+        while(ticks > 0)
+        {
+            delta = timer_wheel_next(ticks);
+            timer -> now += delta - 1;                          // Los ticks sin trabajo se saltan.
+            timer_wheel_tick();
+            ticks -= delta;
+        }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_reschedule
+* Returned Value   : None.
+* Comments         :
+*    Programa el disparo del timer32_2 al tick más cercano que pidan los
+*    ganchos o la rueda, contado desde el último tick; a lo más una vuelta del
+*    timer32_2 (~89 s). Se llama con interrupciones desactivadas, después de
+*    timer_sync o de cambiar una cuenta.
+*
+*END***********************************************************************************/
+
+void timer_reschedule (void)
+{
+    uint32_t cycles = TIMEBASE_TICKS_PER_US * timer_tick;
+    uint32_t next = 0xFFFFFFFF / cycles - 1, ticks, us;
+    uint64_t deadline, now;
+    _mqx_int i;
+
+    if(!timer_activated[SOLO_TIMER])
+        return;
+
+    for(i = 0; i < MAX_TIMER_HOOKS; i++)                        // Lo que le falta a cada gancho.
+        if(timer_hooks[i] != NULL && (us = timer_hooks[i](0)) != TIMER_HOOK_IDLE)
+        {
+            ticks = us / timer_tick + (us % timer_tick != 0);  // Al tick que lo cubre.
+            if(ticks == 0)
+                ticks = 1;
+            if(ticks < next)
+                next = ticks;
+        }
+
+    if(timer != NULL && timer -> state_gral == RUN)
+        next = timer_wheel_next(next);                          // Una bajada de nivel también despierta.
+
+    deadline = timer_last + (uint64_t) next * cycles;
+    now = timer_timebase_ticks();
+
+    TIMER32_2 -> LOAD = (deadline > now + TIMER_MIN_LOAD)? (uint32_t) (deadline - now) : TIMER_MIN_LOAD;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : Timer_Handler
+* Returned Value   : None.
+* Comments         :
+*    Función de interrupción del módulo timer32_2. Solo entra cuando algo
+*    vence: entrega los ticks transcurridos a los ganchos y a la rueda, y
+*    programa el siguiente disparo. Los cambios de estado ya se aplicaron en
+*    timer_ioctl.
+*
+*END***********************************************************************************/
+
+void Timer_Handler(void)
+{
+    Int_disable();                                              // Desactiva interrupciones.
+    TIMER32_2 -> INTCLR = 0;                                    // Borra bandera de timer32_2.
+    timer_interrupts++;
+
+    timer_sync();
+    timer_reschedule();
+
+    // Renueva las interrupciones.
+    Int_enable();
+}
+
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : clean timer
+* Returned Value   : None.
+* Comments         :
+*    Limpia todos los valores; se usa cuando reserva dinámicamente las estructuras
+*    principales del módulo y tienen valores desconocidos (basura).
+*
+*END***********************************************************************************/
+
+void clean_timer (void)
+{
+    uint_32 i, j;
+
+    if(timer == NULL)
+        return;
+
+    // Limpieza en cero's.
+    for(i = 0; i < TIMER_WHEEL_LEVELS; i++)
+        for(j = 0; j < TIMER_WHEEL_SLOTS; j++)
+            timer -> wheel[i][j] = NULL;
+
+    timer -> now   = 0;
+    timer -> units = NULL;
+    timer -> step  = DEFAULT_STEP;
+    return;
+}
+
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_open
+* Returned Value   : int de inicialización correcta.
+* Comments         :
+*    Reserva memoria e inicializa los recursos de los drivers.
+*
+*END***********************************************************************************/
+
+_mqx_int timer_open  (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags)
+{
+    char_ptr file_name_ptr = fd_ptr->DEV_PTR->IDENTIFIER;
+
+    while (*file_name_ptr++ != 0)
+       open_name_ptr++;                                 // Mueve al nombre del archivo.
+    file_name_ptr = open_name_ptr;
+
+    // Inicialización del módulo principal "timer:".
+    if (*file_name_ptr == 0)
+    {
+        TIMER_INIT_STRUCT_PTR init_from = (TIMER_INIT_STRUCT_PTR) flags;
+
+        if (init_from == NULL || timer != NULL)
+           return IO_ERR;
+
+        timer = (TIMER_PTR) malloc (sizeof(TIMER));     // Reserva memoria dinámica.
+        if (timer == NULL)
+           return IO_ERR;
+
+        clean_timer();                                  // Limpieza general.
+
+        timer -> state_gral = init_from -> run_now;     // El estado depende de la configuración recibida.
+        if((init_from -> step) > MINIMUM_LIMIT_STEP)    // Debe haber un mínimo óptimo para el step.
+            timer -> step = init_from -> step;
+
+        fd_ptr -> DEV_DATA_PTR = (pointer) init_from;   // La configuración se guarda en el archivo FILE.
+
+        Int_disable();
+        timer_sync();                                   // Lo transcurrido se cuenta con el tick anterior.
+        timer_tick = timer -> step;                     // El HW toma el step de este archivo.
+        if(timer -> state_gral == RUN || timer_activated[SOLO_TIMER])
+            timer_hw_init();                            // Inicializa (o reprograma) el HW del timer.
+        Int_enable();
+
+        return IO_OK;
+    }
+
+    // Inicialización de una unidad: "timer:n" para n <= TIMER_MAX_UNIT.
+    else
+    {
+        TIMER_UNIT_INIT_STRUCT_PTR init_from = (TIMER_UNIT_INIT_STRUCT_PTR) flags;
+        TIMER_UNIT_DATA_PTR        unit;
+        uint64_t                   period;
+        _mqx_uint                  ch = 0;
+
+        if (init_from == NULL)
+           return IO_ERR;                                                      // No hay parámetros.
+
+        if (NULL == timer)                                                     // No se ha inicializado el módulo principal.
+           return IO_ERR;
+
+        do
+        {
+           if ((*open_name_ptr < '0') || (*open_name_ptr > '9'))
+              return IO_ERR;                                                   // No es número.
+           if (TIMER_MAX_UNIT < (ch = ch * 10 + (*open_name_ptr - '0')))
+              return IO_ERR;                                                   // Número excedido.
+        }
+        while (*++open_name_ptr != 0);
+
+        // Periodo en ticks: la parte entera y el resto en uS.
+        period = (uint64_t) init_from -> time_period * SEC;
+        if ((period / timer -> step == 0) || (period / timer -> step > 0xFFFFFFFF))
+           return IO_ERR;                                                      // Periodo menor a un tick o mayor a la rueda.
+
+        for (unit = timer -> units; unit != NULL; unit = unit -> all)
+           if (unit -> num == ch)
+              return IO_ERR;                                                   // Unidad ya usada por un archivo.
+
+        unit = (TIMER_UNIT_DATA_PTR) malloc (sizeof(TIMER_UNIT_DATA));         // Reservación dinámica de la unidad.
+        if (unit == NULL)
+           return IO_ERR;
+
+        // Con esto inicia la configuración deseada.
+        unit -> num = ch;
+
+        // Banderas y toggles.
+        unit -> flags[M_STOPPED] = (init_from -> flags & (1 << M_STOPPED)) != 0;
+        unit -> flags[P_FLAG]    = (init_from -> flags & (1 << P_FLAG))    != 0;
+        unit -> flags[P_TOGGLE]  = (init_from -> flags & (1 << P_TOGGLE))  != 0;
+        unit -> flags[P_END]     = (init_from -> flags & (1 << P_END))     != 0;
+        unit -> period_flag   = FALSE;
+        unit -> period_end    = FALSE;
+        unit -> period_toggle = FALSE;
+
+        // Tiempo máximo y tiempo contado.
+        unit -> max[SECONDS] = (init_from -> max[SECONDS]);
+        unit -> max[MINUTES] = (init_from -> max[MINUTES]);
+        unit -> max[HOURS]   = (init_from -> max[HOURS]);
+        unit -> time[SECONDS] = 0;
+        unit -> time[MINUTES] = 0;
+        unit -> time[HOURS]   = 0;
+
+        // Periodo.
+        unit -> scale        = init_from -> time_period;
+        unit -> period_ticks = period / timer -> step;
+        unit -> period_rem   = period % timer -> step;
+        unit -> carry        = unit -> period_rem;
+        unit -> paused_left  = unit -> period_ticks;                           // Un PAUSED inicial arranca con el periodo completo.
+        unit -> next         = NULL;
+        unit -> pprev        = NULL;
+
+        // Estado: se entra a la rueda solo si empieza en corrida.
+        Int_disable();
+        timer_sync();                                                          // La rueda al día antes de insertar.
+        unit -> state = (init_from -> state == PAUSED) ? PAUSED : STOPPED;
+        if (init_from -> state == RUN)
+           timer_unit_run(unit, FALSE);
+
+        unit -> all = timer -> units;                                          // Pasa a la lista de unidades abiertas.
+        timer -> units = unit;
+        timer_reschedule();
+        Int_enable();
+
+       // Pasa a formar parte del archivo.
+       fd_ptr -> DEV_DATA_PTR = (pointer) unit;
+
+       return IO_OK;
+    }
+}
+
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_hw_init
+* Returned Value   : int de inicialización correcta.
+* Comments         :
+*    Presenta funciones interrupciones y arranca el timer32_2 a través de los
+*    registros, de un disparo: ya no interrumpe cada tick, sino en el siguiente
+*    vencimiento. Los ticks de timer_tick uS se cuentan desde aquí con la base
+*    de tiempo.
+*
+*END***********************************************************************************/
+
+ _mqx_int timer_hw_init (void)
+{
+     static boolean bandera_interrupt_time = FALSE;
+
+     if(!bandera_interrupt_time)
+     {
+         timer_timebase_init();                                                  // Los ticks se miden con ella.
+         Int_registerInterrupt(INT_T32_INT2, Timer_Handler);
+         Int_enableInterrupt(INT_T32_INT2);
+         bandera_interrupt_time = 1;
+     }
+
+     if(!timer_activated[SOLO_TIMER])
+         timer_last = timer_timebase_ticks();                                    // El primer tick se cuenta desde ahora.
+
+     TIMER32_2 -> LOAD = 0xFFFFFFFF;
+     TIMER32_2 -> CONTROL = TIMER32_CONTROL_ENABLE | TIMER32_CONTROL_ONESHOT |   // 32 bit, de un disparo,
+                            TIMER32_CONTROL_SIZE | TIMER32_CONTROL_PRESCALE_0 |  // sin prescaler.
+                            TIMER32_CONTROL_IE;                                  // Habilita interrupción.
+     timer_activated[SOLO_TIMER] = 1;
+     timer_reschedule();                                                         // Carga el primer disparo.
+
+     return IO_OK;
+}
+
+
+ /*FUNCTION******************************************************************************
+ *
+ * Function Name    : timer_ioctl
+ * Returned Value   : entero de control correcto.
+ * Comments         :
+ *    Controla las unidades cambiándolos, o actualizando banderas o cadenas.
+ *    Los cambios se aplican aquí mismo (sacar o meter la unidad a la rueda),
+ *    la interrupción ya no los revisa.
+ *
+ *END***********************************************************************************/
+
+_mqx_int timer_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
+{
+   TIMER_UNIT_DATA_PTR unit = (TIMER_UNIT_DATA_PTR) fd_ptr -> DEV_DATA_PTR;          // Recoge instrucción.
+
+   if(timer == NULL)
+       return IO_ERR;
+
+   Int_disable();                                                                    // Inhabilita interrupciones.
+   timer_sync();                                                                     // La rueda al día antes del cambio.
+
+   if(param_ptr != NULL)                                                             // Si se recibe algo diferente de NULL.
+   {                                                                                 // Se desea modificar timer principal.
+       switch (cmd)                                                                  // Fuera de RUN la rueda no avanza.
+       {
+           case IOCTL_TIMER_RUN:
+           case IOCTL_TIMER_RESUME: timer -> state_gral = RUN;
+                                    if(!timer_activated[SOLO_TIMER])
+                                        timer_hw_init();
+                                    break;
+           case IOCTL_TIMER_PAUSE:  timer -> state_gral = PAUSED;   break;
+           case IOCTL_TIMER_STOP:   timer -> state_gral = STOPPED;  break;
+           default:                                                 break;
+       }
+   }
+
+   else                                                                              // Si null es recibido.
+   {
+       switch (cmd)                                                                  // Modifica unidad.
+       {
+           case IOCTL_TIMER_RUN:    timer_unit_run(unit, FALSE);                     break;
+           case IOCTL_TIMER_RESUME: timer_unit_run(unit, TRUE);                      break;
+           case IOCTL_TIMER_PAUSE:  if(unit -> state == RUN)
+                                    {
+                                        unit -> paused_left = unit -> expires - timer -> now;
+                                        timer_wheel_remove(unit);
+                                        unit -> state = PAUSED;
+                                    }
+                                    break;
+           case IOCTL_TIMER_STOP:   timer_wheel_remove(unit);
+                                    unit -> state = STOPPED;
+                                    unit -> time[SECONDS] = 0;
+                                    unit -> time[MINUTES] = 0;
+                                    unit -> time[HOURS]   = 0;
+                                    unit -> period_flag =   FALSE;
+                                    unit -> period_toggle = FALSE;
+                                    break;
+           default:                                                                  break;
+       }
+   }
+
+   timer_reschedule();                                                               // El siguiente disparo puede cambiar.
+   Int_enable();                                                                    // Renueva interrupciones.
+   return IO_OK;
+}
+
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_close
+* Returned Value   : entero de control correcto.
+* Comments         :
+*    Cierra los archivos correspondientes de memoria. Una unidad solo se libera
+*    a sí misma; el archivo principal libera todas y apaga el HW.
+*
+*END***********************************************************************************/
+
+_mqx_int timer_close (FILE _PTR_ fd_ptr)
+{
+    FILE_f                       struct_file[1];
+    TIMER_UNIT_DATA_PTR _PTR_    link = NULL;
+    TIMER_UNIT_DATA_PTR          unit;
+    uint_32                      i;
+
+    Int_disable();
+
+    fread(struct_file, sizeof(struct_file), 1, fd_ptr);
+    rewind(fd_ptr);
+
+    if(timer != NULL)                                   // ¿Es una unidad abierta?
+        for(link = &timer -> units; *link != NULL && *link != struct_file -> DEV_DATA_PTR; link = &(*link) -> all);
+
+    if(link != NULL && *link != NULL)
+    {
+        unit  = *link;
+        *link = unit -> all;                            // Sale de la lista y de la rueda.
+        timer_wheel_remove(unit);
+        free(unit);
+    }
+    else
+    {
+        timer_sync();                                   // Los ganchos reciben lo transcurrido con este tick.
+
+        for(i = 0; i < MAX_TIMER_HOOKS; i++)            // Si otro driver usa el tick, el HW sigue corriendo.
+            if(timer_hooks[i] != NULL)
+                break;
+
+        if(timer_activated[SOLO_TIMER] && i == MAX_TIMER_HOOKS)
+        {
+            TIMER32_2 -> CONTROL &= ~TIMER32_CONTROL_IE;    // Apaga el timer32_2.
+            TIMER32_2 -> LOAD = 0XFFFFFFFF;
+            timer_activated[SOLO_TIMER] = FALSE;
+        }
+
+        if(timer != NULL)
+        {
+            while(timer -> units != NULL)               // Cierra las unidades abiertas.
+            {
+                unit = timer -> units;
+                timer -> units = unit -> all;
+                free(unit);
+            }
+            free(timer);
+        }
+        timer = NULL;
+
+        if(timer_activated[SOLO_TIMER])                 // Los ganchos siguen con el tick por omisión.
+        {
+            timer_tick = STEP;
+            timer_hw_init();
+        }
+    }
+
+    free(fd_ptr);                                       // Cierra el archivo.
+
+    Int_enable();
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_read
+* Returned Value   : entero de control correcto.
+* Comments         :
+*    Lectura de banderas, cadenas y tiempo de una unidad.
+*
+*END***********************************************************************************/
+
+_mqx_int timer_read  (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num)
+{
+    uint_32_ptr dir;
+    char_ptr    dir_string;
+    uint32_t    ticks;
+    TIMER_UNIT_DATA_PTR unit = (TIMER_UNIT_DATA_PTR) fd_ptr -> DEV_DATA_PTR;
+
+    // Dependiendo del formato, se leerá un numérico o una cadena.
+
+    if(num < T_STRING)
+        dir =  (uint_32_ptr) data_ptr;
+    else if(num == T_STRING)
+        dir_string = (char_ptr) data_ptr;
+    else
+        return IO_ERR;
+
+    // Desactiva interrupciones; la rueda se pone al día para T_MILLIS.
+    Int_disable();
+    timer_sync();
+
+    switch(num)
+    {
+        // Lectura de period_flag y limpieza de esta bandera.
+        case P_FLAG:        *dir = unit -> period_flag;
+                            unit -> period_flag = 0;                                        break;
+
+        // Lectura de period_toggle.
+        case P_TOGGLE:      *dir = unit -> period_toggle;                                   break;
+
+        // Lectura de period_end (cuando se llegue al tiempo máximo).
+        case P_END:         *dir = unit -> period_end;
+                            unit -> period_end = 0;                                         break;
+
+        // Lectura de milisegundos que faltan al periodo.
+        case T_MILLIS:      ticks = (unit -> state == RUN)?    unit -> expires - timer -> now :
+                                    (unit -> state == PAUSED)? unit -> paused_left : 0;
+                            *dir = (uint64_t) ticks * timer -> step / 1000;                 break;
+
+        // Lectura de un tiempo.
+        case T_SECONDS:     *dir = unit -> time[SECONDS];                                   break;
+        case T_MINUTES:     *dir = unit -> time[MINUTES];                                   break;
+        case T_HOURS:       *dir = unit -> time[HOURS];                                     break;
+
+        // Lectura del tiempo pero en formato de una cadena.
+        case T_STRING:      sprintf(dir_string, "%02d:%02d:%02d\n\r",
+                            (int) unit -> time[HOURS],
+                            (int) unit -> time[MINUTES],
+                            (int) unit -> time[SECONDS]);                                   break;
+        default:                                                                            break;
+    }
+
+    Int_enable();                                                                           // Renueva interrupciones.
+
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_hook_add
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Engancha una función al tick del timer32_2 (en ticks de timer_tick uS, solo cuando
+*    vence algo). Si el timer no está corriendo, lo arranca; las unidades solo se
+*    evalúan si existe el archivo "timer:".
+*
+*END***********************************************************************************/
+
+_mqx_int timer_hook_add (TIMER_HOOK hook)
+{
+    uint_32 i;
+
+    Int_disable();
+    for(i = 0; i < MAX_TIMER_HOOKS; i++)
+        if(timer_hooks[i] == NULL || timer_hooks[i] == hook)
+        {
+            timer_sync();                               // Lo transcurrido no le toca al nuevo gancho.
+            timer_hooks[i] = hook;
+            if(!timer_activated[SOLO_TIMER])
+                timer_hw_init();
+            else
+                timer_reschedule();
+            Int_enable();
+            return IO_OK;
+        }
+    Int_enable();
+
+    return IO_ERR;                                      // No hay lugar.
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_hook_remove
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Retira una función del tick.
+*
+*END***********************************************************************************/
+
+_mqx_int timer_hook_remove (TIMER_HOOK hook)
+{
+    uint_32 i;
+
+    Int_disable();
+    for(i = 0; i < MAX_TIMER_HOOKS; i++)
+        if(timer_hooks[i] == hook)
+        {
+            timer_hooks[i] = NULL;
+            Int_enable();
+            return IO_OK;
+        }
+    Int_enable();
+
+    return IO_ERR;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_timebase_init
+* Returned Value   : None.
+* Comments         :
+*    Arranca el timer32_1 libre (32 bits, sin recarga ni prescaler) como base de
+*    tiempo monotónica de todo el sistema. Su interrupción solo cuenta las vueltas,
+*    una cada 2^32 ciclos (~89 s a 48 MHz). Se llama una vez, con el reloj ya
+*    configurado.
+*
+*END***********************************************************************************/
+
+void timer_timebase_init (void)
+{
+    static boolean bandera_interrupt_timebase = FALSE;
+
+    if(bandera_interrupt_timebase)
+        return;
+
+    Int_registerInterrupt(INT_T32_INT1, Timebase_Handler);
+    Int_enableInterrupt(INT_T32_INT1);
+    bandera_interrupt_timebase = TRUE;
+
+    timebase_epoch = 0;
+    TIMER32_1 -> LOAD = 0xFFFFFFFF;                                             // Cuenta desde el máximo.
+    TIMER32_1 -> INTCLR = 0;
+    TIMER32_1 -> CONTROL = TIMER32_CONTROL_ENABLE | TIMER32_CONTROL_SIZE |     // Libre: sin MODE ni ONESHOT.
+                           TIMER32_CONTROL_PRESCALE_0 | TIMER32_CONTROL_IE;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : Timebase_Handler
+* Returned Value   : None.
+* Comments         :
+*    Desborde del timer32_1: una vuelta más de la base de tiempo. No apaga
+*    interrupciones; las lecturas se protegen solas.
+*
+*END***********************************************************************************/
+
+void Timebase_Handler (void)
+{
+    TIMER32_1 -> INTCLR = 0;
+    timebase_epoch++;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_timebase_ticks
+* Returned Value   : Ciclos de MCLK desde timer_timebase_init (64 bits).
+* Comments         :
+*    Lectura sin candados: se repite si el desborde entró a la mitad. Si el
+*    contador ya dio la vuelta pero su interrupción no ha entrado (interrupciones
+*    apagadas), la vuelta pendiente se cuenta aquí. Se puede llamar desde
+*    cualquier hilo o interrupción.
+*
+*END***********************************************************************************/
+
+uint64_t timer_timebase_ticks (void)
+{
+    uint32_t epoch, count, pending;
+
+    do
+    {
+        epoch   = timebase_epoch;
+        count   = TIMER32_1 -> VALUE;
+        pending = TIMER32_1 -> RIS & TIMER32_RIS_RAW_IFG;
+    }
+    while(epoch != timebase_epoch);
+
+    if(pending && (count & 0x80000000))                 // Recién recargado: la vuelta aún no se cuenta.
+        epoch++;
+
+    return ((uint64_t) epoch << 32) | (uint32_t) ~count;     // Cuenta hacia abajo desde 0xFFFFFFFF.
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : timer_timebase_us
+* Returned Value   : uS desde timer_timebase_init (64 bits).
+* Comments         :
+*    Base de tiempo común para bitácora, reportes, eventos y muestras.
+*
+*END***********************************************************************************/
+
+uint64_t timer_timebase_us (void)
+{
+    return timer_timebase_ticks() / TIMEBASE_TICKS_PER_US;
+}
@@ -1,132 +1,186 @@
- //FileName:        timer_f_msp432.h
- //Dependencies:    None
- //Processor:       MSP432
- //Board:			MSP432P401R
- //Program version: CCS V8.3 TI
- //Company:         Texas Instruments
- //Description:     Descripcin general de constantes, macros y configuraciones del mdulo TIMER32. Header File.
- //Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- //Updated:         12/2018
-
-
-#ifndef TIMER_F_MSP432_H_
-#define TIMER_F_MSP432_H_
-
-// Definiciones de indexes para los arreglos que albergan el tiempo.
-#define SECONDS                 2
-#define MINUTES                 1
-#define HOURS                   0
-
-// Definiciones del uso del timer.
-#define ADC_T                   0
-#define SOLO_TIMER              1
-
-// Definiciones de lmites de recursos.
-#define MAX_TIMER_UNITS         8
-#define MINIMUM_LIMIT_STEP      999
-#define STR_TIMER_LENGTH        12
-#define DEFAULT_STEP            1000
-
-// Definiciones de estados.
-#define RUN                     0
-#define PAUSED                  1
-#define STOPPED                 2
-#define RESUMED                 3
-
-// Definiciones de configuraciones para estructura unit_init.
-#define MAX_AND_STOPPED         0x00000001
-#define PERIOD_FLAG             0x00000002
-#define PERIOD_TOGGLE           0x00000004
-#define PERIOD_END              0x00000008
-#define ALL                     MAX_AND_STOPPED | PERIOD_FLAG | PERIOD_TOGGLE | PERIOD_END
-
-// Definiciones de banderas en formato numrico simple.
-#define M_STOPPED               0
-#define P_FLAG                  1
-#define P_TOGGLE                2
-#define P_END                   3
-#define T_MILLIS                4
-#define T_SECONDS               5
-#define T_MINUTES               6
-#define T_HOURS                 7
-#define T_STRING                8
-
-#define MAX_TIMER_FLAGS         4
-
-// Posibles instrucciones del timer/cronmetro en IOCTL.
-#define IOCTL_TIMER_GENERAL   0x7000FFFF
-#define IOCTL_TIMER_RUN       0x70000000
-#define IOCTL_TIMER_STOP      0x70000001
-#define IOCTL_TIMER_RESUME    0x70000002
-#define IOCTL_TIMER_PAUSE     0x70000003
-
-// Estructura de inicializacin de timer principal:
-// Contiene el estado actual del timer general, as como el step de resta sucesiva.
-typedef struct _timer_struct
-{
-   uint_32   run_now;
-   uint_32   step;
-
-} TIMER_INIT_STRUCT, _PTR_ TIMER_INIT_STRUCT_PTR;
-
-// Estructura de inicializacin de una unidad: Necesita el estado inicial, el periodo de esta unidad,
-// el lmite mximo de tiempo, as como las banderas de inicializacin.
-typedef struct _timer_init_struct
-{
-   uint_32   state;                                     // Estado inicial de la unidad.
-   uint_32   time_period;                               // Periodo de actualizacin.
-   uint_32   max[3];                                    // Mximo tiempo de cronometraje; puede o no reiniciar el tiempo.
-
-   uint_32   flags;                                     // Las banderas pueden incluir: tener bandera cada periodo,
-                                                        // un toggle, y/o una bandera de finalizacin, asi como decidir
-                                                        // si tras cumplirse el tiempo mximo se debe reiniciar.
-
-} TIMER_UNIT_INIT_STRUCT, _PTR_ TIMER_UNIT_INIT_STRUCT_PTR;
-
-// Estructura principal de timer: Contiene el estado general y el step, as como todos los tiempos
-// de todas las unidades 'vivas' contando el tiempo en segundos, y los periodos de reinicio y resta de tiempo.
-typedef struct _timer_file
-{
-   uint_32               state_gral;                   // El estado puede ser run, paused o stopped.
-   uint_32               step;                         // Paso sobre el cual se van realizando las restas sucesivas.
-
-   uint_32               time_full[MAX_TIMER_UNITS];   // Arreglo de resultados de todos los canales.
-   uint_32               time_left[MAX_TIMER_UNITS];   // Tiempo restante para que se cumpla el periodo.
-
-   uint_32               time[3][MAX_TIMER_UNITS];     // Tiempo actual de cada unidad.
-
-} TIMER, _PTR_ TIMER_PTR;
-
-// Estructura de cada unidad: alberga principalmente la configuracin, como el estado, periodo y tiempo mximo
-// respectivo a esta y solo esta unidad, sino tambin las configuraciones y banderas y toggles que se activan.
-typedef struct _timer_unit_file
-{
-   uint_32               num;                           // Nmero de la unidad; proporciona fcil identificacin.
-   uint_32               state;                         // Estado puede ser run, paused o stopped.
-   uint_32               scale;                         // Equivalente a time_period.
-
-   uint_32               max[3];                        // Valor mximo a la cual llega la unidad de cronmetro.
-
-   boolean               period_flag;                   // Bandera que anuncia que se ha cumplido un periodo.
-   boolean               period_toggle;                 // Toggle en base a periodo.
-   boolean               period_end;                    // Bandera que anuncia que se ha cumplido el tiempo mximo.
-
-   boolean               flags[MAX_TIMER_FLAGS];        // Banderas respectivas de la unidad cronmetro.
-
-} TIMER_UNIT_DATA, _PTR_ TIMER_UNIT_DATA_PTR;
-
-// Funcin para limpiar (poner en cero's) en un inicio los valores de la estructura.
-extern  void clean_timer (void);
-// Funcin para inicializar en HW el timer.
-extern  _mqx_int timer_hw_init (void);
-
-// Funciones para abrir, cerrar, controlar y leer los objetos del timer.
-extern _mqx_int timer_open       (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags);
-extern _mqx_int timer_close      (FILE _PTR_ fd_ptr);
-extern _mqx_int timer_read       (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num);
-extern _mqx_int timer_ioctl      (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr);
-
-// Interrupcin. Para timer32_2 (mdulo 2).
-extern void Timer_Handler(void);
-
-#endif /* TIMER_F_MSP432_H_ */
+ //FileName:        timer_f_msp432.h
+ //Dependencies:    None
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Descripción general de constantes, macros y configuraciones del módulo TIMER32. Header File.
+ //Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         12/2018
+
+
+#ifndef TIMER_F_MSP432_H_
+#define TIMER_F_MSP432_H_
+
+// Definiciones de indexes para los arreglos que albergan el tiempo.
+#define SECONDS                 2
+#define MINUTES                 1
+#define HOURS                   0
+
+// Definiciones del uso del timer.
+#define ADC_T                   0
+#define SOLO_TIMER              1
+
+// Definiciones de límites de recursos.
+#define TIMER_MAX_UNIT          0xFFFF      // Mayor número de unidad ("timer:65535"); el límite real es la memoria.
+#define MINIMUM_LIMIT_STEP      999
+#define STR_TIMER_LENGTH        12
+#define DEFAULT_STEP            1000
+#define MAX_TIMER_HOOKS         4
+
+// Base de tiempo: el timer32_1 cuenta ciclos de MCLK hacia abajo, sin prescaler.
+#define TIMEBASE_TICKS_PER_US   ((__SYSTEM_CLOCK) / (SEC))
+
+// Tick sin interrupción periódica: el timer32_2 es de un disparo y se programa al
+// siguiente vencimiento (ganchos o rueda); al despertar se cuentan los ticks pasados.
+#define TIMER_HOOK_IDLE         0xFFFFFFFF  // El gancho no tiene nada pendiente.
+#define TIMER_HOOK_NEXT         1           // El gancho pide el siguiente tick.
+#define TIMER_MIN_LOAD          TIMEBASE_TICKS_PER_US   // Carga mínima del disparo (1 uS).
+
+// Rueda de tiempos jerárquica: TIMER_WHEEL_LEVELS niveles de 2^TIMER_WHEEL_BITS ranuras.
+// Cada ranura de un nivel abarca todo el nivel anterior (1, 64, 4096... ticks), así que
+// cubren cualquier retardo de 32 bits. Cada tick solo atiende una ranura del nivel 0, y
+// los ticks sin trabajo se saltan; las unidades bajan de nivel a lo más
+// TIMER_WHEEL_LEVELS - 1 veces por periodo.
+#define TIMER_WHEEL_BITS        6
+#define TIMER_WHEEL_SLOTS       (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK        (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS      6
+
+// Definiciones de estados.
+#define RUN                     0
+#define PAUSED                  1
+#define STOPPED                 2
+#define RESUMED                 3
+
+// Definiciones de configuraciones para estructura unit_init.
+#define MAX_AND_STOPPED         0x00000001
+#define PERIOD_FLAG             0x00000002
+#define PERIOD_TOGGLE           0x00000004
+#define PERIOD_END              0x00000008
+#define ALL                     MAX_AND_STOPPED | PERIOD_FLAG | PERIOD_TOGGLE | PERIOD_END
+
+// Definiciones de banderas en formato numérico simple.
+#define M_STOPPED               0
+#define P_FLAG                  1
+#define P_TOGGLE                2
+#define P_END                   3
+#define T_MILLIS                4
+#define T_SECONDS               5
+#define T_MINUTES               6
+#define T_HOURS                 7
+#define T_STRING                8
+
+#define MAX_TIMER_FLAGS         4
+
+// Posibles instrucciones del timer/cronómetro en IOCTL.
+#define IOCTL_TIMER_GENERAL   0x7000FFFF
+#define IOCTL_TIMER_RUN       0x70000000
+#define IOCTL_TIMER_STOP      0x70000001
+#define IOCTL_TIMER_RESUME    0x70000002
+#define IOCTL_TIMER_PAUSE     0x70000003
+
+// Estructura de inicialización de timer principal:
+// Contiene el estado actual del timer general, así como el step de resta sucesiva.
+typedef struct _timer_struct
+{
+   uint_32   run_now;
+   uint_32   step;
+
+} TIMER_INIT_STRUCT, _PTR_ TIMER_INIT_STRUCT_PTR;
+
+// Estructura de inicialización de una unidad: Necesita el estado inicial, el periodo de esta unidad,
+// el límite máximo de tiempo, así como las banderas de inicialización.
+typedef struct _timer_init_struct
+{
+   uint_32   state;                                     // Estado inicial de la unidad.
+   uint_32   time_period;                               // Periodo de actualización.
+   uint_32   max[3];                                    // Máximo tiempo de cronometraje; puede o no reiniciar el tiempo.
+
+   uint_32   flags;                                     // Las banderas pueden incluir: tener bandera cada periodo,
+                                                        // un toggle, y/o una bandera de finalización, asi como decidir
+                                                        // si tras cumplirse el tiempo máximo se debe reiniciar.
+
+} TIMER_UNIT_INIT_STRUCT, _PTR_ TIMER_UNIT_INIT_STRUCT_PTR;
+
+// Estructura de cada unidad: alberga principalmente la configuración, como el estado, periodo y tiempo máximo
+// respectivo a esta y solo esta unidad, sino también las configuraciones y banderas y toggles que se activan;
+// además, su tiempo contado y su lugar en la rueda.
+typedef struct _timer_unit_file
+{
+   uint_32               num;                           // Número de la unidad; proporciona fácil identificación.
+   uint_32               state;                         // Estado puede ser run, paused o stopped.
+   uint_32               scale;                         // Equivalente a time_period (segundos).
+
+   uint_32               max[3];                        // Valor máximo a la cual llega la unidad de cronómetro.
+   uint_32               time[3];                       // Tiempo actual de la unidad.
+
+   boolean               period_flag;                   // Bandera que anuncia que se ha cumplido un periodo.
+   boolean               period_toggle;                 // Toggle en base a periodo.
+   boolean               period_end;                    // Bandera que anuncia que se ha cumplido el tiempo máximo.
+
+   boolean               flags[MAX_TIMER_FLAGS];        // Banderas respectivas de la unidad cronómetro.
+
+   uint32_t              period_ticks;                  // Periodo en ticks completos...
+   uint32_t              period_rem;                    // ...más un resto en uS que se acumula en 'carry',
+   uint32_t              carry;                         // así el periodo promedio es exacto.
+   uint32_t              expires;                       // Tick en que vence (en corrida).
+   uint32_t              paused_left;                   // Ticks que faltaban al pausarse.
+
+   struct _timer_unit_file _PTR_  next;                 // Siguiente en la misma ranura.
+   struct _timer_unit_file _PTR_ _PTR_ pprev;           // Campo que apunta a esta unidad (NULL: fuera de la rueda).
+   struct _timer_unit_file _PTR_  all;                  // Siguiente unidad abierta.
+
+} TIMER_UNIT_DATA, _PTR_ TIMER_UNIT_DATA_PTR;
+
+// Estructura principal de timer: Contiene el estado general y el step, la rueda de tiempos
+// con las unidades en corrida y la lista de todas las unidades abiertas.
+typedef struct _timer_file
+{
+   uint_32               state_gral;                   // El estado puede ser run, paused o stopped.
+   uint_32               step;                         // uS por tick; la rueda avanza una ranura por tick.
+
+   uint32_t              now;                          // Último tick atendido (da la vuelta en 32 bits).
+   TIMER_UNIT_DATA_PTR   wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+   TIMER_UNIT_DATA_PTR   units;                        // Unidades abiertas.
+
+} TIMER, _PTR_ TIMER_PTR;
+
+// Función que otro driver engancha al tick del timer32_2. Recibe los uS que pasaron
+// (múltiplo del tick; 0 solo pregunta) y regresa los uS a su siguiente vencimiento,
+// o TIMER_HOOK_IDLE.
+typedef uint_32 (*TIMER_HOOK)(uint_32 elapsed);
+
+// Función para limpiar (poner en cero's) en un inicio los valores de la estructura.
+extern  void clean_timer (void);
+// Función para inicializar en HW el timer.
+extern  _mqx_int timer_hw_init (void);
+
+// Funciones para abrir, cerrar, controlar y leer los objetos del timer.
+extern _mqx_int timer_open       (FILE_PTR_f fd_ptr, char_ptr open_name_ptr, char_ptr flags);
+extern _mqx_int timer_close      (FILE _PTR_ fd_ptr);
+extern _mqx_int timer_read       (FILE_PTR_f fd_ptr, char_ptr data_ptr, _mqx_int num);
+extern _mqx_int timer_ioctl      (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr);
+
+// Registro de funciones en el tick; arranca el HW si hace falta, aun sin archivo "timer:".
+extern _mqx_int timer_hook_add    (TIMER_HOOK hook);
+extern _mqx_int timer_hook_remove (TIMER_HOOK hook);
+
+// Para los drivers que cambian sus cuentas fuera del tick, con interrupciones desactivadas:
+// timer_sync antes (descuenta lo transcurrido) y timer_reschedule después.
+extern void     timer_sync        (void);
+extern void     timer_reschedule  (void);
+
+// Interrupciones atendidas del timer32_2 (estadística).
+extern volatile uint32_t timer_interrupts;
+
+// Base de tiempo del sistema: timer32_1 libre, extendido a 64 bits; lectura sin bloquear interrupciones.
+extern void     timer_timebase_init  (void);
+extern uint64_t timer_timebase_ticks (void);           // Ciclos de MCLK desde timer_timebase_init.
+extern uint64_t timer_timebase_us    (void);           // uS desde timer_timebase_init.
+
+// Interrupciones. Para timer32_2 (módulo 2) y para el desborde de la base de tiempo (módulo 1).
+extern void Timer_Handler(void);
+extern void Timebase_Handler(void);
+
+#endif /* TIMER_F_MSP432_H_ */
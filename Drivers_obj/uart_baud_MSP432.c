@@ -0,0 +1,72 @@
+ //FileName:        uart_baud_MSP432.c
+ //Dependencies:    uart_baud_MSP432.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Divisores del generador de baud rate del eUSCI_A (sin acceso al HW). Source File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#include <stdio.h>
+#include "types.h"
+#include "Files.h"
+#include "uart_baud_MSP432.h"
+
+/* UCBRSx según la parte fraccionaria de BRCLK / baud rate, en diezmilésimas
+ * (Technical Reference Manual, tabla 24-4): se toma la última entrada que no
+ * la rebase. */
+static const struct { uint_16 fraction; uint_8 brs; } UART_BRS_TABLE[] =
+{
+    {    0, 0x00 }, {  529, 0x01 }, {  715, 0x02 }, {  835, 0x04 }, { 1001, 0x08 },
+    { 1252, 0x10 }, { 1430, 0x20 }, { 1670, 0x11 }, { 2147, 0x21 }, { 2224, 0x22 },
+    { 2503, 0x44 }, { 3000, 0x25 }, { 3335, 0x49 }, { 3575, 0x4A }, { 3753, 0x52 },
+    { 4003, 0x92 }, { 4286, 0x53 }, { 4378, 0x55 }, { 5002, 0xAA }, { 5715, 0x6B },
+    { 6003, 0xAD }, { 6254, 0xB5 }, { 6432, 0xB6 }, { 6667, 0xD6 }, { 7001, 0xB7 },
+    { 7147, 0xBB }, { 7503, 0xDD }, { 7861, 0xED }, { 8004, 0xEE }, { 8333, 0xBF },
+    { 8464, 0xDF }, { 8572, 0xEF }, { 8751, 0xF7 }, { 9004, 0xFB }, { 9170, 0xFD },
+    { 9288, 0xFE }
+};
+
+
+/***************************************************************************
+ * Function: uart_baud_divisors
+ * Preconditions: None.
+ * Overview: Algoritmo del eUSCI (Technical Reference Manual 24.3.10):
+ *           N = BRCLK / baud. Con sobremuestreo, UCBRx = N / 16 y UCBRFx es
+ *           la parte fraccionaria de N / 16 en dieciseisavos; sin él, UCBRx = N.
+ *           UCBRSx sale de la tabla con la parte fraccionaria de N. Solo usa
+ *           enteros, y no toca el HW para poder probarse en la PC.
+ * Input:  Frecuencia de BRCLK, baud rate, si se pide sobremuestreo y
+ *         estructura donde se dejan los divisores.
+ * Output: IO_OK, o IO_ERR si N es menor a 3 o UCBRx no cabe en 16 bits.
+ *****************************************************************************/
+_mqx_int uart_baud_divisors(uint_32 brclk, uint_32 baud, boolean oversampling, UART_BAUD_DIVISORS_PTR div)
+{
+    uint_32 n, fraction, i;
+
+    if((baud == 0) || (brclk / baud < UART_BRCLK_MIN_RATIO))
+        return IO_ERR;
+
+    n        = brclk / baud;
+    fraction = (uint_32) (((uint_64) (brclk % baud) * 10000) / baud);
+
+    div -> os16 = oversampling && (n >= UART_OS16_MIN_RATIO);
+    if(div -> os16)
+    {
+        div -> brw = n / 16;
+        div -> brf = n % 16;                                            // INT(frac(N / 16) * 16).
+    }
+    else
+    {
+        if(n > 0xFFFF)
+            return IO_ERR;
+        div -> brw = n;
+        div -> brf = 0;
+    }
+
+    for(i = 0; (i + 1 < sizeof(UART_BRS_TABLE) / sizeof(UART_BRS_TABLE[0])) && (UART_BRS_TABLE[i + 1].fraction <= fraction); i++);
+    div -> brs = UART_BRS_TABLE[i].brs;
+
+    return IO_OK;
+}
@@ -0,0 +1,31 @@
+ //FileName:        uart_baud_MSP432.h
+ //Dependencies:    types.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Divisores del generador de baud rate del eUSCI_A (sin acceso al HW). Header File.
+ //Authors:         MarcoCaldM, sobre los drivers de José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         10/2026
+
+#ifndef UART_BAUD_MSP432_H_
+#define UART_BAUD_MSP432_H_
+
+/* Límites del baud rate: BRCLK debe ser al menos 3 veces el baud rate. */
+#define UART_BRCLK_MIN_RATIO   3
+#define UART_OS16_MIN_RATIO    16       // Desde aquí se puede usar sobremuestreo.
+
+/* Divisores del generador de baud rate (UCBRx, UCBRFx, UCBRSx y UCOS16). */
+typedef struct uart_baud_divisors
+{
+  uint_16  brw;
+  uint_8   brf;
+  uint_8   brs;
+  boolean  os16;
+
+} UART_BAUD_DIVISORS, _PTR_ UART_BAUD_DIVISORS_PTR;
+
+/* Calcula los divisores para un baud rate con el algoritmo del eUSCI; no toca el HW. */
+extern _mqx_int uart_baud_divisors(uint_32 brclk, uint_32 baud, boolean oversampling, UART_BAUD_DIVISORS_PTR div);
+
+#endif
@@ -1,405 +1,1009 @@
- //FileName:        uart_f_MSP432.c
- //Dependencies:    system.h
- //Processor:       MSP432
- //Board:			MSP432P401R
- //Program version: CCS V8.3 TI
- //Company:         Texas Instruments
- //Description:     Driver para UART por medio de archivos. Source File.
- //Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- //Updated:         12/2018
-
-#include "HVAC.h"
-
-/* Estructura general del dispositivo. */
-UART_DEVICE_STRUCT_PTR uart = NULL;
-boolean RX_interruption = FALSE;
-
-const uint32_t BRX[]  = {78, 19, 6};                    // Constantes para la determinacin del Baud Rate.
-const uint32_t BRFX[] = {2,  8,  8};                    // (Technical Reference Manual - Pag 918).
-const uint32_t BRS[]  = {0x0000, 0x0065, 0x0020};       // Definido para 12 MHz (BRCLK). CAMBIE SEGUN DISEO.
-
-/* Definicin de los puertos. */
-static const uint32_t GPIO_PORT_TO_BASE[] =
-{   0x00,
-    0x40004C00,
-    0x40004C01,
-    0x40004C20,
-    0x40004C21,
-    0x40004C40,
-    0x40004C41,
-    0x40004C60,
-    0x40004C61,
-    0x40004C80,
-    0x40004C81,
-    0x40004D20
-};
-
-
-/*FUNCTION****************************************************************
-*
-* Function Name    : uart_open
-* Returned Value   : IO_OK or IO_ERR
-* Comments         : Reservacin de memoria, llenado de datos,
-*                    llama funcin de configuracin de HW.
-*END**********************************************************************/
-
-_mqx_int uart_open (FILE_PTR_f fd_ptr, char _PTR_ open_name_ptr, char _PTR_ flags)
-{
-   UART_INIT_STRUCT_PTR uart_init_ptr = (UART_INIT_STRUCT_PTR) flags;
-   _mqx_uint            result = IO_OK;
-   static bool                 flag = 0;
-
-   // Llenado en la estructura UART (solo lo importante).
-   if(flag == 0)
-   {
-       uart = (UART_DEVICE_STRUCT_PTR) malloc(sizeof(UART_DEVICE_STRUCT));
-       flag = 1;
-   }
-
-   switch(uart_init_ptr -> baud_rate)
-   {
-       case BR_9600:   uart -> baud_rate = 9600;   break;
-       case BR_38400:  uart -> baud_rate = 38400;  break;
-       case BR_115200: uart -> baud_rate = 115200; break;
-       default: return(IO_ERR);
-   }
-
-   uart -> selected_port = uart_init_ptr -> selected_port;
-   uart -> pins[0] = uart_init_ptr -> pins[0];
-   uart -> pins[1] = uart_init_ptr -> pins[1];
-   uart -> clk = uart_init_ptr -> clk;
-
-   /* Llamada a la funcin que configura. */
-   result = uart_hw_init(uart_init_ptr, open_name_ptr);
-
-   return(result);
-}
-
-
-/*FUNCTION****************************************************************
-*
-* Function Name    : uart_hw_init
-* Returned Value   : IO_OK or IO_ERR
-* Comments         : Configuracin de HW.
-*
-*END*********************************************************************/
-
-uint_32 uart_hw_init (UART_INIT_STRUCT_PTR init_ptr, char _PTR_ open_name_ptr)
-{
-    /* Se apaga el mdulo. */
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 , EUSCI_A_CTLW0_SWRST_OFS) = 1;
-
-    /* Forma genrica para limpiar interrupciones, sleep, y otros registros inicialmente. */
-    EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 = (EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0 & ~( UCRXEIE | UCBRKIE | UCDORM | UCTXADDR | UCTXBRK)) | EUSCI_A_CTLW0_MODE_0;
-
-    UART_mode(ASYNCHRONOUS);                                             /* Mdo Asncrono habilitado (UART). */
-    UART_set_location_pin(init_ptr->selected_port, init_ptr->pins[0]);   /* Seleccin de pines. */
-    UART_set_location_pin(init_ptr->selected_port, init_ptr->pins[1]);   /* Seleccin de pines. */
-    UART_clck_source(init_ptr -> clk);                                   /* Seleccin de la fuente de reloj. (Bit SMCLK) */
-    UART_set_transmision_dir(init_ptr -> direction);                     /* Seleccin de MSB o LSB en orden de transmisin (0 para LSB, 1 para MSB). */
-    UART_set_stop_bits(init_ptr -> stop_bits);                           /* Nmero de bits de paro; UCSPB = 0(1 stop bit) OR 1(2 stop bits). */
-    UART_set_parity(init_ptr -> parity);                                 /* Paridad entre la comunicacin. */
-
-    UART_set_baud_rate((uint8_t) init_ptr -> baud_rate);                 /* Configuraciones posibles: 9600, 38400, 115200. */
-    UART_data_bits(init_ptr -> data_bits);                               /* Seleccin de caracter 8 bits. */
-    UART_set_oversampling(init_ptr -> oversampling);                     /* Sobremuestreo (Oversampling) */
-
-    UART_E_char_IE(init_ptr -> interruption_E);                          /* Interrupcin habilitada por caracteres errneos. */
-    UART_B_char_IE(init_ptr -> interruption_B);                          /* Interrupcin habilitada por caracteres break.    */
-
-    /* Se enciende el mdulo. */
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 , EUSCI_A_CTLW0_SWRST_OFS) = 0;
-
-   return(IO_OK);
-}
-
-
-/*FUNCTION****************************************************************
-*
-* Function Name    : uart_close
-* Returned Value   : IO_OK
-* Comments         : Cierre del archivo y de la estructura general.
-*
-*END**********************************************************************/
-
-_mqx_int uart_close (FILE _PTR_ fd_ptr)
-{
-   if(uart != NULL)
-   free(uart);
-   free(fd_ptr);
-
-   return(IO_OK);
-}
-
-
-/*FUNCTION***************************************************************************
-*
-* Function Name    : uart_read
-* Returned Value   : IO_OK
-* Comments         : No hay ninguna funcin definida para lectura, pero debe existir.
-*
-*END*********************************************************************************/
-
-_mqx_int uart_read (FILE_PTR_f fd_ptr, char _PTR_ data_ptr, _mqx_int num)
-{
-   // No hay ninguna definicin de esta funcin.
-   return IO_OK;
-}
-
-
-/*FUNCTION*******************************************************************
-* Function Name    : uart_ioctl
-* Returned Value   : IO_OK
-* Comments         : En la revisin solo se tiene un comando para habilitar
-*                    la interrupcin ante la recepcin de un caracter.
-*END************************************************************************/
-
-_mqx_int uart_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
-{
-   switch(cmd)
-   {
-       case IO_IOCTL_SERIAL_IRQ_FUNCTION:
-           Int_registerInterrupt(INT_EUSCIA0, (void(*)(void)) param_ptr);
-           Int_enableInterrupt(INT_EUSCIA0);
-           EUSCI_A0 -> IE = EUSCI_A_IE_RXIE;
-           RX_interruption = TRUE;
-           break;
-
-       default: return IO_ERR;
-   }
-
-   return IO_OK;
-}
-
-/////////////////////////////////
-// Funciones de configuracin. //
-/////////////////////////////////
-
-/*FUNCTION*********************************************************************
-*
-* Function Name    : UART_set_location_pins
-* Returned Value   : IO_OK or IO_ERR
-* Comments         : Configuracin de pin. Funciona bien con los pines default.
-*
-*END***************************************************************************/
-
-void UART_set_location_pins(uint32_t selected_port,uint32_t selected_pins)
-{
-    HWREG16(selected_port + OFS_PADIR) &= ~(selected_pins);
-    HWREG16(selected_port + OFS_PASEL0) |= (selected_pins);
-    HWREG16(selected_port + OFS_PASEL1) &= ~(selected_pins);
-}
-
-/****************************************************************************
- * Function: UART_data_bits
- * Preconditions: None.
- * Overview: Establece el envo para 7 u 8 bits.
- * Input:  Nmero de bits (0 - 8 bits, 1 - 7 bits).
- * Output: None.
- *****************************************************************************/
-
-void UART_data_bits(bool data_bits)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0, UC7BIT) = data_bits;
-}
-
-
-/****************************************************************************
- * Function: UART_clck_source
- * Preconditions: None.
- * Overview: Establece de donde se toma el reloj del puerto.
- * Input:  Enum con la seleccin del reloj.
- * Output: None.
- *****************************************************************************/
-void UART_clck_source(Clk_source source)
-{
-    switch(source)
-    {
-        case U_CLK:  EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 = (EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 & ~UCSSEL_3) | EUSCI_A_CTLW0_SSEL__UCLK;  break;
-        case A_CLK:  EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 = (EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 & ~UCSSEL_3) | EUSCI_A_CTLW0_SSEL__ACLK;  break;
-        case SM_CLK: EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 = (EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0 & ~UCSSEL_3) | EUSCI_A_CTLW0_SSEL__SMCLK; break;
-        default: break;
-    }
-}
-
-
-/*****************************************************************************
- * Function: UART_mode
- * Preconditions: None.
- * Overview: Establece de donde se toma el reloj del puerto.
- * Input:  Bool que indique modo sncrono (1) o asncrono (0).
- * Output: None.
- *****************************************************************************/
-void UART_mode(bool synchronization)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0, EUSCI_A_CTLW0_SYNC) = synchronization;
-}
-
-
-/*****************************************************************************
- * Function: UART_B_char_IE
- * Preconditions: None.
- * Overview: Pone en alto la interrupcin por carcteres 'break'.
- * Input:  Bool que indique si la interrupcin se habilita (1) o no (0).
- * Output: None.
- *****************************************************************************/
-void UART_B_char_IE(bool interruption)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0, EUSCI_A_CTLW0_BRKIE_OFS) = interruption;
-}
-
-/*****************************************************************************
- * Function: UART_E_char_IE
- * Preconditions: None.
- * Overview: Pone en alto la interrupcin por caracteres errneos.
- * Input:  Bool que indique si la interrupcin se habilita (1) o no (0).
- * Output: None.
- *****************************************************************************/
-void UART_E_char_IE(bool interruption)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0) -> CTLW0, EUSCI_A_CTLW0_RXEIE_OFS) = interruption;
-}
-
-/*****************************************************************************
- * Function: UART_set_oversampling
- * Preconditions: None.
- * Overview: Establece si se debe contemplar sobremuestreo.
- * Input:  Bool que indique si se contempla sobremuestreo.
- * Output: None.
- *****************************************************************************/
-void UART_set_oversampling(bool oversampling)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0) -> MCTLW, EUSCI_A_MCTLW_OS16_OFS) = oversampling;
-}
-
-
-/****************************************************************************
- * Function: UART_set_parity
- * Preconditions: None.
- * Overview: Establece la paridad (ninguna, impar, par).
- * Input:  Bool que indique el estado deseado.
- * Output: None.
- *****************************************************************************/
-void UART_set_parity(char parity)
-{
-    if(parity > 0)
-    {
-        BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0, UCPEN_OFS) = 1;
-        BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0, UCPAR_OFS) = parity-1;
-    }
-    else
-        BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0, UCPEN_OFS) = 0;
-}
-
-
-/****************************************************************************
- * Function: UART_set_stop_bits
- * Preconditions: None.
- * Overview: Establece el nmero de bits de paro en la comunicacin.
- * Input:  Bool que indique el nmero de bits de paro,
- *         (1 bit si est en 0, 2 bits si est en 1).
- * Output: None.
- *****************************************************************************/
-void UART_set_stop_bits(bool stop_bits)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0, UCSPB_OFS) = stop_bits;
-}
-
-
-/****************************************************************************
- * Function: UART_set_transmision_dir
- * Preconditions: None.
- * Overview: Establece si se debe contemplar sobremuestreo.
- * Input:  Bool que indique si se debe imprimir primero LSB (0) o MSB (1).
- * Output: None.
- *****************************************************************************/
-void UART_set_transmision_dir(bool direction)
-{
-    BITBAND_PERI(EUSCI_A_CMSIS(EUSCI_A0)-> CTLW0, UCMSB_OFS) = direction;
-}
-
-
-/****************************************************************************
- * Function: UART_set_location_pin
- * Preconditions: None.
- * Overview: Establece los pines sobre los cuales se transmitir y recibir.
- * Input:  Puerto (int), seguido de los pines en una sola variable.
- * Output: None.
- *****************************************************************************/
-void UART_set_location_pin(uint32_t selected_port, uint32_t selected_pins)
-{
-    if(selected_port %2 != 0)  // Si el puerto es impar.
-    {
-        HWREG16(GPIO_PORT_TO_BASE[selected_port] + OFS_PADIR) &= ~ (1 << (selected_pins+1));
-        HWREG16(GPIO_PORT_TO_BASE[selected_port] + OFS_PASEL0) |=  (1 << (selected_pins+1));
-        HWREG16(GPIO_PORT_TO_BASE[selected_port] + OFS_PASEL1) &= ~(1 << (selected_pins+1));
-    }
-
-    else
-    {
-        HWREG16((DIO_PORT_Odd_Interruptable_Type*)GPIO_PORT_TO_BASE[selected_port+1] + OFS_PADIR) &= ~ (1 << (selected_pins+1));
-        HWREG16((DIO_PORT_Odd_Interruptable_Type*)GPIO_PORT_TO_BASE[selected_port+1] + OFS_PASEL0) |=  (1 << (selected_pins+1));
-        HWREG16((DIO_PORT_Odd_Interruptable_Type*)GPIO_PORT_TO_BASE[selected_port+1] + OFS_PASEL1) &= ~(1 << (selected_pins+1));
-    }
-}
-
-
-/***************************************************************************
- * Function: UART_set_baud_rate
- * Preconditions: None.
- * Overview: Establece un baud rate de las opciones disponibles.
- * Input:  Valor entero con las opciones diferentes (que estn en un enum).
- *         Estn contemplados para 12 MHz.
- * Output: None.
- *****************************************************************************/
-void UART_set_baud_rate(uint8_t standard)
-{
-    if(standard < MAX_BAUD_RATE_CHANNELS)
-    {
-       EUSCI_A_CMSIS(EUSCI_A0)-> BRW = BRX[standard];
-       EUSCI_A_CMSIS(EUSCI_A0)-> MCTLW = ((BRS[standard] << 8)  + (BRFX[standard] << 4) +  EUSCI_A_MCTLW_OS16);
-    }
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : print
-* Returned Value   : None.
-* Comments         :
-*    Esta funcin ayuda a recordar que es necesario parar interrupciones al imprimir
-*    una cadena, para un funcionamiento ptimo.
-*
-*END***********************************************************************************/
-
-void print(char* message)
-{
-    Int_disable();
-    printf("%s", message);  // Impresin de la cadena entrante.
-    Int_enable();
-}
-
-// FUNCIONES ESPECIALES A REDEFINIR.
-// Funciones redefinidas para poder usar printf.
-
-int fputc(int _c, register FILE* _fp)
-{
-  while(!(UCA0IFG & UCTXIFG));
-  UCA0TXBUF = (unsigned char) _c;
-
-  return((unsigned char)_c);
-}
-
-int fputs(const char* _ptr, register FILE* _fp)
-{
-  unsigned int i, longitud;
-
-  longitud = strlen(_ptr);
-
-  for(i = 0; i < longitud; i++)
-  {
-      while(!(UCA0IFG & UCTXIFG));
-      UCA0TXBUF = (unsigned char) _ptr[i];
-  }
-
-  return longitud;
-}
+ //FileName:        uart_f_MSP432.c
+ //Dependencies:    system.h
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Driver para UART por medio de archivos. Source File.
+ //Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         12/2018
+
+#include "HVAC.h"
+
+extern GPIO_PIN_MAP gpio_global_pin_map;                       // Los pines del puerto no se pueden abrir como GPIO.
+
+
+/* Puertos: registros, estado y colas de cada EUSCI_An. Las colas son estáticas para
+ * que print() pueda encolar en la consola aun antes de abrirla. */
+EUSCI_A_Type _PTR_ const UART_MODULE [UART_MAX_PORTS] = { EUSCI_A0, EUSCI_A1, EUSCI_A2, EUSCI_A3 };
+#define UART_DEVICE_INIT(n, m)  { .module = (m), .num = (n), .tx_policy = UART_TX_BLOCK }
+static UART_DEVICE_STRUCT uart_devices [UART_MAX_PORTS] =
+{
+    UART_DEVICE_INIT(0, EUSCI_A0), UART_DEVICE_INIT(1, EUSCI_A1), UART_DEVICE_INIT(2, EUSCI_A2), UART_DEVICE_INIT(3, EUSCI_A3)
+};
+uint_32 uart_rx_ports = 0;                              // Bit n: EUSCI_An con RXIE.
+
+#define UART_CONSOLE_DEV        (&uart_devices[UART_CONSOLE])
+#define UART_IRQ(dev)           (INT_EUSCIA0 + (dev) -> num)
+
+/* Pines TX/RX de cada módulo (función primaria): puerto (0 -> P1) y máscara. */
+static const struct { uint_8 port; uint_8 mask; } UART_PINS [UART_MAX_PORTS] =
+{
+    { 0, 0x0C },                                        // A0: P1.2 RX, P1.3 TX.
+    { 1, 0x0C },                                        // A1: P2.2 RX, P2.3 TX.
+    { 2, 0x0C },                                        // A2: P3.2 RX, P3.3 TX.
+    { 8, 0xC0 }                                         // A3: P9.6 RX, P9.7 TX.
+};
+
+/* Bloques por µDMA: el TX de EUSCI_An es la fuente 1 del canal 2n. Los canales de A0..A2
+ * tienen su propia interrupción (DMA_INT1..3); el de A3 llega por DMA_INT0, que es común. */
+#define UART_DMA_CHANNEL(dev)   ((dev) -> num * 2)
+#define UART_DMA_SRC_TX         1
+#define UART_DMA_MAX_XFER       1024                    // Transferencias por ciclo del µDMA.
+
+static const uint_32 UART_DMA_IRQ [UART_MAX_PORTS] = { INT_DMA_INT1, INT_DMA_INT2, INT_DMA_INT3, INT_DMA_INT0 };
+
+// Palabra de control: destino fijo (TXBUF), origen avanza de a byte, arbitraje cada byte, modo básico.
+#define UART_DMA_DST_INC_NONE   (3u << 30)
+#define UART_DMA_SRC_INC_8      (0u << 26)
+#define UART_DMA_SIZE_8         (0u << 24)
+#define UART_DMA_ARB_1          (0u << 14)
+#define UART_DMA_MODE_BASIC     (1u)
+
+typedef struct
+{
+    volatile const void _PTR_   src_end;
+    volatile void _PTR_         dst_end;
+    volatile uint32_t           control;
+    uint32_t                    spare;
+
+} UART_DMA_ENTRY;
+
+// Tabla de control del µDMA (8 canales, primaria y alterna); CTLBASE exige alineación de 256.
+#if defined(__IAR_SYSTEMS_ICC__)
+#pragma data_alignment=256
+static UART_DMA_ENTRY uart_dma_table[16];
+#elif defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(uart_dma_table, 256)
+static UART_DMA_ENTRY uart_dma_table[16];
+#else
+static UART_DMA_ENTRY uart_dma_table[16] __attribute__((aligned(256)));
+#endif
+
+static void uart_tx_put (UART_DEVICE_STRUCT_PTR dev, uint_8 c);
+static void uart_dma_wake (UART_DEVICE_STRUCT_PTR dev);
+
+
+/* Definición de los puertos. */
+static const uint32_t GPIO_PORT_TO_BASE[] =
+{   0x00,
+    0x40004C00,
+    0x40004C01,
+    0x40004C20,
+    0x40004C21,
+    0x40004C40,
+    0x40004C41,
+    0x40004C60,
+    0x40004C61,
+    0x40004C80,
+    0x40004C81,
+    0x40004D20
+};
+
+
+/*FUNCTION****************************************************************
+*
+* Function Name    : uart_open
+* Returned Value   : IO_OK or IO_ERR
+* Comments         : Elige el puerto por el nombre ("uart:" o "uart:0"
+*                    para A0, "uart:1".."uart:3"), reserva sus pines,
+*                    llena los datos y llama a la configuración de HW.
+*                    Un puerto solo se puede abrir una vez.
+*END**********************************************************************/
+
+_mqx_int uart_open (FILE_PTR_f fd_ptr, char _PTR_ open_name_ptr, char _PTR_ flags)
+{
+   UART_INIT_STRUCT_PTR   uart_init_ptr = (UART_INIT_STRUCT_PTR) flags;
+   UART_DEVICE_STRUCT_PTR dev;
+   uint_32                num = UART_CONSOLE;
+   _mqx_uint              result = IO_OK;
+   static boolean         dma_ready = FALSE;
+
+   while (*open_name_ptr && *open_name_ptr++ != ':');             // Mueve al número del puerto.
+   if (*open_name_ptr)
+   {
+       if ((open_name_ptr[1] != '\0') || (*open_name_ptr < '0') || (*open_name_ptr >= '0' + UART_MAX_PORTS))
+           return(IO_ERR);
+       num = *open_name_ptr - '0';
+   }
+
+   if (uart_init_ptr -> baud_rate == 0)
+       return(IO_ERR);
+
+   dev = &uart_devices[num];
+
+   Int_disable();
+   if (dev -> open || (gpio_global_pin_map.memory8[UART_PINS[num].port] & UART_PINS[num].mask))
+   {
+       Int_enable();                                               // Puerto abierto o pines ocupados.
+       return(IO_ERR);
+   }
+   gpio_global_pin_map.memory8[UART_PINS[num].port] |= UART_PINS[num].mask;
+   dev -> open = TRUE;
+   Int_enable();
+
+   // Llenado en la estructura UART (solo lo importante).
+   dev -> baud_rate = uart_init_ptr -> baud_rate;
+   dev -> selected_port = uart_init_ptr -> selected_port;
+   dev -> pins[0] = uart_init_ptr -> pins[0];
+   dev -> pins[1] = uart_init_ptr -> pins[1];
+   dev -> clk = uart_init_ptr -> clk;
+
+   /* µDMA: una sola vez, la tabla de control es de todos los canales. */
+   if (!dma_ready)
+   {
+       DMA_Control -> CFG     = DMA_CFG_MASTEN;
+       DMA_Control -> CTLBASE = (uint32_t) uart_dma_table;
+       dma_ready = TRUE;
+   }
+
+   /* Llamada a la función que configura. */
+   result = uart_hw_init(dev, uart_init_ptr);
+   if (result != IO_OK)
+   {
+       Int_disable();
+       gpio_global_pin_map.memory8[UART_PINS[num].port] &= ~UART_PINS[num].mask;
+       dev -> open = FALSE;
+       Int_enable();
+       return(result);
+   }
+
+   fd_ptr -> DEV_DATA_PTR = (pointer) dev;
+   return(IO_OK);
+}
+
+
+/*FUNCTION****************************************************************
+*
+* Function Name    : uart_hw_init
+* Returned Value   : IO_OK or IO_ERR
+* Comments         : Configuración de HW del puerto 'dev'.
+*
+*END*********************************************************************/
+
+uint_32 uart_hw_init (UART_DEVICE_STRUCT_PTR dev, UART_INIT_STRUCT_PTR init_ptr)
+{
+    EUSCI_A_Type _PTR_ module = dev -> module;
+    uint_32            channel = UART_DMA_CHANNEL(dev);
+    static boolean     sync_ready[UART_MAX_PORTS] = { FALSE };
+
+    /* Candado y semáforo una sola vez por puerto: se conservan entre aperturas
+       (las colas pueden traer datos de antes y un hilo puede estar esperando). */
+    if (!sync_ready[dev -> num])
+    {
+        pthread_mutex_init(&dev -> print_lock, NULL);
+        sem_init(&dev -> rx_lines, 0, 0);
+        sem_init(&dev -> dma_idle, 0, 0);
+        sync_ready[dev -> num] = TRUE;
+    }
+
+    /* Se apaga el módulo. */
+    BITBAND_PERI(module -> CTLW0 , EUSCI_A_CTLW0_SWRST_OFS) = 1;
+
+    /* Forma genérica para limpiar interrupciones, sleep, y otros registros inicialmente. */
+    module -> CTLW0 = (module -> CTLW0 & ~( UCRXEIE | UCBRKIE | UCDORM | UCTXADDR | UCTXBRK)) | EUSCI_A_CTLW0_MODE_0;
+
+    UART_mode(module, ASYNCHRONOUS);                                     /* Módo Asíncrono habilitado (UART). */
+    GPIO_PORT_REG(UART_PINS[dev -> num].port, OFS_PASEL1) &= ~UART_PINS[dev -> num].mask;   /* Pines en función primaria. */
+    GPIO_PORT_REG(UART_PINS[dev -> num].port, OFS_PASEL0) |=  UART_PINS[dev -> num].mask;
+    UART_clck_source(module, init_ptr -> clk);                           /* Selección de la fuente de reloj. (Bit SMCLK) */
+    UART_set_transmision_dir(module, init_ptr -> direction);             /* Selección de MSB o LSB en orden de transmisión (0 para LSB, 1 para MSB). */
+    UART_set_stop_bits(module, init_ptr -> stop_bits);                   /* Número de bits de paro; UCSPB = 0(1 stop bit) OR 1(2 stop bits). */
+    UART_set_parity(module, init_ptr -> parity);                         /* Paridad entre la comunicación. */
+
+    UART_data_bits(module, init_ptr -> data_bits);                       /* Selección de caracter 8 bits. */
+
+    /* Divisores según el reloj real; el sobremuestreo solo se usa si BRCLK lo permite. */
+    if(UART_set_baud_rate(module, UART_brclk(init_ptr -> clk), init_ptr -> baud_rate, init_ptr -> oversampling) != IO_OK)
+        return IO_ERR;                                                   /* Baud rate imposible con este reloj; el módulo queda en reset. */
+
+    UART_E_char_IE(module, init_ptr -> interruption_E);                  /* Interrupción habilitada por caracteres erróneos. */
+    UART_B_char_IE(module, init_ptr -> interruption_B);                  /* Interrupción habilitada por caracteres break.    */
+
+    /* Se enciende el módulo. */
+    BITBAND_PERI(module -> CTLW0 , EUSCI_A_CTLW0_SWRST_OFS) = 0;
+
+    /* µDMA: canal 2n con EUSCI_An TX; el fin de cada tramo llega por la interrupción del puerto. */
+    DMA_Channel -> CH_SRCCFG[channel] = UART_DMA_SRC_TX;
+    DMA_Control -> ALTCLR       = 1 << channel;
+    DMA_Control -> USEBURSTCLR  = 1 << channel;
+    DMA_Control -> REQMASKCLR   = 1 << channel;
+    switch (dev -> num)
+    {
+        case 0: DMA_Channel -> INT1_SRCCFG = DMA_INT1_SRCCFG_EN | channel; break;
+        case 1: DMA_Channel -> INT2_SRCCFG = DMA_INT2_SRCCFG_EN | channel; break;
+        case 2: DMA_Channel -> INT3_SRCCFG = DMA_INT3_SRCCFG_EN | channel; break;
+        default: break;                                                  // DMA_INT0: todos los demás canales.
+    }
+    Int_registerHwi(UART_DMA_IRQ[dev -> num], uart_dma_isr, (UArg) dev);   // Hwi: puede postear semáforos.
+    Int_enableInterrupt(UART_DMA_IRQ[dev -> num]);
+
+    /* La ISR del puerto vacía su cola; si ya hay algo encolado, arranca sola (TXIFG en alto). */
+    Int_registerHwi(UART_IRQ(dev), uart_isr, (UArg) dev);
+    Int_enableInterrupt(UART_IRQ(dev));
+    dev -> ready = TRUE;
+    if (dev -> tx_head != dev -> tx_tail)
+        module -> IE |= EUSCI_A_IE_TXIE;
+
+    module -> IE |= EUSCI_A_IE_RXIE;                                     /* Recepción siempre a la cola. */
+    uart_rx_ports |= 1 << dev -> num;
+
+   return(IO_OK);
+}
+
+
+/*FUNCTION****************************************************************
+*
+* Function Name    : uart_close
+* Returned Value   : IO_OK
+* Comments         : Apaga el puerto (lo pendiente en las colas se pierde),
+*                    libera sus pines y el archivo.
+*
+*END**********************************************************************/
+
+_mqx_int uart_close (FILE _PTR_ fd_ptr)
+{
+   UART_DEVICE_STRUCT_PTR dev;
+   FILE_f                 struct_file[1];
+   FILE_PTR_f             struct_file_ptr;
+
+   Int_disable();
+
+   fread(struct_file, sizeof(struct_file), 1, fd_ptr);
+   rewind(fd_ptr);
+
+   struct_file_ptr = struct_file;
+   dev = (UART_DEVICE_STRUCT_PTR) struct_file_ptr -> DEV_DATA_PTR;
+
+   if (dev != NULL)
+   {
+       Int_disableInterrupt(UART_IRQ(dev));
+       Int_disableInterrupt(UART_DMA_IRQ[dev -> num]);
+       DMA_Control -> ENACLR = 1 << UART_DMA_CHANNEL(dev);
+       BITBAND_PERI(dev -> module -> CTLW0 , EUSCI_A_CTLW0_SWRST_OFS) = 1;    // También limpia IE.
+       uart_rx_ports &= ~(1 << dev -> num);
+
+       dev -> tx_tail  = dev -> tx_head;
+       dev -> dma_head = dev -> dma_tail = NULL;
+       dev -> dma_busy = FALSE;
+       uart_dma_wake(dev);                                       // Los que esperaban TXBUF ya no lo tendrán.
+       dev -> rx_func  = NULL;
+       dev -> ready    = FALSE;
+
+       GPIO_PORT_REG(UART_PINS[dev -> num].port, OFS_PASEL0) &= ~UART_PINS[dev -> num].mask;
+       gpio_global_pin_map.memory8[UART_PINS[dev -> num].port] &= ~UART_PINS[dev -> num].mask;
+       dev -> open = FALSE;
+   }
+
+   Int_enable();
+   free(fd_ptr);
+
+   return(IO_OK);
+}
+
+
+/*FUNCTION***************************************************************************
+*
+* Function Name    : uart_read
+* Returned Value   : IO_OK or IO_ERR
+* Comments         : Duerme hasta que haya una línea completa ('\r' o '\n') y la
+*                    copia sin el fin de línea, terminada en '\0'. Lo que no quepa
+*                    en 'num' bytes se descarta. Las líneas vacías (como el '\n'
+*                    de un "\r\n") no se entregan.
+*
+*END*********************************************************************************/
+
+_mqx_int uart_read (FILE_PTR_f fd_ptr, char _PTR_ data_ptr, _mqx_int num)
+{
+   UART_DEVICE_STRUCT_PTR dev = (UART_DEVICE_STRUCT_PTR) fd_ptr -> DEV_DATA_PTR;
+   _mqx_int n;
+   uint_8   c;
+
+   if ((data_ptr == NULL) || (num <= 0) || (dev -> rx_func != NULL))
+       return IO_ERR;
+
+   do
+   {
+       sem_wait(&dev -> rx_lines);                              // Sin líneas el hilo no ocupa CPU.
+
+       n = 0;
+       for (c = dev -> rx_buffer[dev -> rx_tail++ & (UART_RX_BUFFER_SIZE - 1)]; (c != '\r') && (c != '\n');
+            c = dev -> rx_buffer[dev -> rx_tail++ & (UART_RX_BUFFER_SIZE - 1)])
+           if (n < num - 1)
+               data_ptr[n++] = c;
+   } while (n == 0);
+
+   data_ptr[n] = '\0';
+   return IO_OK;
+}
+
+
+/* Excluye solo a la ISR del puerto (NVIC) mientras se mueven índices o listas de transmisión. */
+static void uart_tx_lock (UART_DEVICE_STRUCT_PTR dev)
+{
+    if (dev -> ready)
+        Int_disableInterrupt(UART_IRQ(dev));
+}
+
+/* Con el µDMA libre, TXIE deja que la ISR siga con la cola o el siguiente bloque. */
+static void uart_tx_unlock (UART_DEVICE_STRUCT_PTR dev)
+{
+    if (!dev -> dma_busy)
+        dev -> module -> IE |= EUSCI_A_IE_TXIE;
+    if (dev -> ready)
+        Int_enableInterrupt(UART_IRQ(dev));
+}
+
+/* Interrupción del µDMA del puerto habilitada en el NVIC (sin ella nadie termina un bloque). */
+static boolean uart_dma_irq_enabled (UART_DEVICE_STRUCT_PTR dev)
+{
+    uint_32 irq = UART_DMA_IRQ[dev -> num] - 16;
+
+    return (HWREG32(NVIC_EN0_R + 4 * (irq / 32)) >> (irq & 31)) & 1;
+}
+
+/* Despierta a los hilos que esperan a que el µDMA suelte TXBUF (UART_TX_BLOCK). */
+static void uart_dma_wake (UART_DEVICE_STRUCT_PTR dev)
+{
+    while (dev -> tx_waiters)
+    {
+        dev -> tx_waiters--;
+        sem_post(&dev -> dma_idle);
+    }
+}
+
+/* Programa el siguiente tramo (hasta UART_DMA_MAX_XFER bytes) del bloque 'd'. */
+static void uart_dma_chunk (UART_DEVICE_STRUCT_PTR dev, UART_DMA_DESCRIPTOR_PTR d)
+{
+    uint_32 channel = UART_DMA_CHANNEL(dev);
+    uint_32 n = d -> length - d -> sent;
+
+    if (n > UART_DMA_MAX_XFER)
+        n = UART_DMA_MAX_XFER;
+
+    uart_dma_table[channel].src_end = d -> data + d -> sent + n - 1;
+    uart_dma_table[channel].dst_end = &dev -> module -> TXBUF;
+    uart_dma_table[channel].control = UART_DMA_DST_INC_NONE | UART_DMA_SRC_INC_8 | UART_DMA_SIZE_8 |
+                                      UART_DMA_ARB_1 | ((n - 1) << 4) | UART_DMA_MODE_BASIC;
+    d -> sent += n;
+
+    DMA_Control -> ENASET = 1 << channel;
+    if (dev -> module -> IFG & EUSCI_A_IFG_TXIFG)               // El disparo es por flanco de TXIFG:
+        DMA_Control -> SWREQ = 1 << channel;                    // el primer byte se pide a mano.
+}
+
+/*FUNCTION*******************************************************************
+* Function Name    : uart_ioctl
+* Returned Value   : IO_OK or IO_ERR
+* Comments         : Función de recepción propia (sustituye a la cola y a
+*                    uart_read), política y estado de las colas, y escritura
+*                    en el puerto del archivo.
+*END************************************************************************/
+
+_mqx_int uart_ioctl (FILE_PTR_f fd_ptr, _mqx_uint cmd, pointer param_ptr)
+{
+   UART_DEVICE_STRUCT_PTR dev = (UART_DEVICE_STRUCT_PTR) fd_ptr -> DEV_DATA_PTR;
+
+   switch(cmd)
+   {
+       case IO_IOCTL_SERIAL_IRQ_FUNCTION:
+           dev -> rx_func = (void(*)(void)) param_ptr;
+           dev -> module -> IE |= EUSCI_A_IE_RXIE;
+           uart_rx_ports |= 1 << dev -> num;
+           break;
+
+       case IO_IOCTL_SERIAL_TX_POLICY:
+           if ((param_ptr == NULL) || (*(uint_32_ptr) param_ptr > UART_TX_OVERWRITE))
+               return IO_ERR;
+           dev -> tx_policy = *(uint_32_ptr) param_ptr;
+           break;
+
+       case IO_IOCTL_SERIAL_TX_STATUS:
+           if (param_ptr == NULL)
+               return IO_ERR;
+           ((UART_TX_STATUS_PTR) param_ptr) -> pending = dev -> tx_head - dev -> tx_tail;
+           ((UART_TX_STATUS_PTR) param_ptr) -> dropped = dev -> tx_dropped;
+           break;
+
+       case IO_IOCTL_SERIAL_RX_STATUS:
+           if (param_ptr == NULL)
+               return IO_ERR;
+           ((UART_RX_STATUS_PTR) param_ptr) -> pending = dev -> rx_head - dev -> rx_tail;
+           ((UART_RX_STATUS_PTR) param_ptr) -> dropped = dev -> rx_dropped;
+           break;
+
+       case IO_IOCTL_SERIAL_WRITE:
+       {
+           UART_WRITE_STRUCT_PTR w = (UART_WRITE_STRUCT_PTR) param_ptr;
+           uint_32               i;
+
+           if ((w == NULL) || ((w -> data == NULL) && (w -> length != 0)))
+               return IO_ERR;
+
+           // ioctl() llega con las interrupciones apagadas: aquí no se espera. Si otro
+           // hilo escribe, IO_ERR; lo que no cabe en la cola se descarta y se cuenta.
+           if (pthread_mutex_trylock(&dev -> print_lock) != 0)
+               return IO_ERR;
+           for (i = 0; i < w -> length; i++)
+           {
+               uart_tx_lock(dev);
+               if (dev -> tx_head - dev -> tx_tail == UART_TX_BUFFER_SIZE)
+               {
+                   dev -> tx_dropped += w -> length - i;
+                   uart_tx_unlock(dev);
+                   break;
+               }
+               dev -> tx_buffer[dev -> tx_head++ & (UART_TX_BUFFER_SIZE - 1)] = w -> data[i];
+               uart_tx_unlock(dev);
+           }
+           pthread_mutex_unlock(&dev -> print_lock);
+       }
+       break;
+
+       case IO_IOCTL_SERIAL_DMA_WRITE:
+       {
+           UART_DMA_DESCRIPTOR_PTR d = (UART_DMA_DESCRIPTOR_PTR) param_ptr;
+
+           if ((d == NULL) || (d -> data == NULL) || (d -> length == 0))
+               return IO_ERR;
+
+           d -> next   = NULL;
+           d -> sent   = 0;
+           d -> status = UART_DMA_QUEUED;
+
+           Int_disableInterrupt(UART_DMA_IRQ[dev -> num]);
+           uart_tx_lock(dev);
+           if (dev -> dma_tail == NULL)
+               dev -> dma_head = d;
+           else
+               dev -> dma_tail -> next = d;
+           dev -> dma_tail = d;
+           uart_tx_unlock(dev);                                 // Con el DMA libre, la ISR lo arranca.
+           Int_enableInterrupt(UART_DMA_IRQ[dev -> num]);
+       }
+       break;
+
+       default: return IO_ERR;
+   }
+
+   return IO_OK;
+}
+
+/////////////////////////////////
+// Funciones de configuración. //
+/////////////////////////////////
+
+/*FUNCTION*********************************************************************
+*
+* Function Name    : UART_set_location_pins
+* Returned Value   : IO_OK or IO_ERR
+* Comments         : Configuración de pin. Funciona bien con los pines default.
+*
+*END***************************************************************************/
+
+void UART_set_location_pins(uint32_t selected_port,uint32_t selected_pins)
+{
+    HWREG16(selected_port + OFS_PADIR) &= ~(selected_pins);
+    HWREG16(selected_port + OFS_PASEL0) |= (selected_pins);
+    HWREG16(selected_port + OFS_PASEL1) &= ~(selected_pins);
+}
+
+/****************************************************************************
+ * Function: UART_data_bits
+ * Preconditions: None.
+ * Overview: Establece el envío para 7 u 8 bits.
+ * Input:  Registros del puerto; número de bits (0 - 8 bits, 1 - 7 bits).
+ * Output: None.
+ *****************************************************************************/
+
+void UART_data_bits(EUSCI_A_Type _PTR_ module, bool data_bits)
+{
+    BITBAND_PERI(module-> CTLW0, UC7BIT) = data_bits;
+}
+
+
+/****************************************************************************
+ * Function: UART_clck_source
+ * Preconditions: None.
+ * Overview: Establece de donde se toma el reloj del puerto.
+ * Input:  Registros del puerto; enum con la selección del reloj.
+ * Output: None.
+ *****************************************************************************/
+void UART_clck_source(EUSCI_A_Type _PTR_ module, Clk_source source)
+{
+    switch(source)
+    {
+        case U_CLK:  module -> CTLW0 = (module -> CTLW0 & ~UCSSEL_3) | EUSCI_A_CTLW0_SSEL__UCLK;  break;
+        case A_CLK:  module -> CTLW0 = (module -> CTLW0 & ~UCSSEL_3) | EUSCI_A_CTLW0_SSEL__ACLK;  break;
+        case SM_CLK: module -> CTLW0 = (module -> CTLW0 & ~UCSSEL_3) | EUSCI_A_CTLW0_SSEL__SMCLK; break;
+        default: break;
+    }
+}
+
+
+/*****************************************************************************
+ * Function: UART_mode
+ * Preconditions: None.
+ * Overview: Establece de donde se toma el reloj del puerto.
+ * Input:  Registros del puerto; bool que indique modo síncrono (1) o asíncrono (0).
+ * Output: None.
+ *****************************************************************************/
+void UART_mode(EUSCI_A_Type _PTR_ module, bool synchronization)
+{
+    BITBAND_PERI(module -> CTLW0, EUSCI_A_CTLW0_SYNC) = synchronization;
+}
+
+
+/*****************************************************************************
+ * Function: UART_B_char_IE
+ * Preconditions: None.
+ * Overview: Pone en alto la interrupción por carácteres 'break'.
+ * Input:  Registros del puerto; bool que indique si la interrupción se habilita (1) o no (0).
+ * Output: None.
+ *****************************************************************************/
+void UART_B_char_IE(EUSCI_A_Type _PTR_ module, bool interruption)
+{
+    BITBAND_PERI(module -> CTLW0, EUSCI_A_CTLW0_BRKIE_OFS) = interruption;
+}
+
+/*****************************************************************************
+ * Function: UART_E_char_IE
+ * Preconditions: None.
+ * Overview: Pone en alto la interrupción por caracteres erróneos.
+ * Input:  Registros del puerto; bool que indique si la interrupción se habilita (1) o no (0).
+ * Output: None.
+ *****************************************************************************/
+void UART_E_char_IE(EUSCI_A_Type _PTR_ module, bool interruption)
+{
+    BITBAND_PERI(module -> CTLW0, EUSCI_A_CTLW0_RXEIE_OFS) = interruption;
+}
+
+/*****************************************************************************
+ * Function: UART_set_oversampling
+ * Preconditions: None.
+ * Overview: Establece si se debe contemplar sobremuestreo.
+ * Input:  Registros del puerto; bool que indique si se contempla sobremuestreo.
+ * Output: None.
+ *****************************************************************************/
+void UART_set_oversampling(EUSCI_A_Type _PTR_ module, bool oversampling)
+{
+    BITBAND_PERI(module -> MCTLW, EUSCI_A_MCTLW_OS16_OFS) = oversampling;
+}
+
+
+/****************************************************************************
+ * Function: UART_set_parity
+ * Preconditions: None.
+ * Overview: Establece la paridad (ninguna, impar, par).
+ * Input:  Registros del puerto; bool que indique el estado deseado.
+ * Output: None.
+ *****************************************************************************/
+void UART_set_parity(EUSCI_A_Type _PTR_ module, char parity)
+{
+    if(parity > 0)
+    {
+        BITBAND_PERI(module-> CTLW0, UCPEN_OFS) = 1;
+        BITBAND_PERI(module-> CTLW0, UCPAR_OFS) = parity-1;
+    }
+    else
+        BITBAND_PERI(module-> CTLW0, UCPEN_OFS) = 0;
+}
+
+
+/****************************************************************************
+ * Function: UART_set_stop_bits
+ * Preconditions: None.
+ * Overview: Establece el número de bits de paro en la comunicación.
+ * Input:  Registros del puerto; bool que indique el número de bits de paro,
+ *         (1 bit si está en 0, 2 bits si está en 1).
+ * Output: None.
+ *****************************************************************************/
+void UART_set_stop_bits(EUSCI_A_Type _PTR_ module, bool stop_bits)
+{
+    BITBAND_PERI(module-> CTLW0, UCSPB_OFS) = stop_bits;
+}
+
+
+/****************************************************************************
+ * Function: UART_set_transmision_dir
+ * Preconditions: None.
+ * Overview: Establece si se debe contemplar sobremuestreo.
+ * Input:  Registros del puerto; bool que indique si se debe imprimir primero LSB (0) o MSB (1).
+ * Output: None.
+ *****************************************************************************/
+void UART_set_transmision_dir(EUSCI_A_Type _PTR_ module, bool direction)
+{
+    BITBAND_PERI(module-> CTLW0, UCMSB_OFS) = direction;
+}
+
+
+/****************************************************************************
+ * Function: UART_set_location_pin
+ * Preconditions: None.
+ * Overview: Establece los pines sobre los cuales se transmitirá y recibirá.
+ * Input:  Puerto (int), seguido de los pines en una sola variable.
+ * Output: None.
+ *****************************************************************************/
+void UART_set_location_pin(uint32_t selected_port, uint32_t selected_pins)
+{
+    if(selected_port %2 != 0)  // Si el puerto es impar.
+    {
+        HWREG16(GPIO_PORT_TO_BASE[selected_port] + OFS_PADIR) &= ~ (1 << (selected_pins+1));
+        HWREG16(GPIO_PORT_TO_BASE[selected_port] + OFS_PASEL0) |=  (1 << (selected_pins+1));
+        HWREG16(GPIO_PORT_TO_BASE[selected_port] + OFS_PASEL1) &= ~(1 << (selected_pins+1));
+    }
+
+    else
+    {
+        HWREG16((DIO_PORT_Odd_Interruptable_Type*)GPIO_PORT_TO_BASE[selected_port+1] + OFS_PADIR) &= ~ (1 << (selected_pins+1));
+        HWREG16((DIO_PORT_Odd_Interruptable_Type*)GPIO_PORT_TO_BASE[selected_port+1] + OFS_PASEL0) |=  (1 << (selected_pins+1));
+        HWREG16((DIO_PORT_Odd_Interruptable_Type*)GPIO_PORT_TO_BASE[selected_port+1] + OFS_PASEL1) &= ~(1 << (selected_pins+1));
+    }
+}
+
+
+/***************************************************************************
+ * Function: UART_brclk
+ * Preconditions: SystemInit ya configuró CS.
+ * Overview: Frecuencia de la fuente de reloj del eUSCI según CS.
+ * Input:  Fuente de reloj (U_CLK, A_CLK o SM_CLK).
+ * Output: Frecuencia en Hz; 0 para UCLK (externo, no se conoce).
+ *****************************************************************************/
+uint_32 UART_brclk(Clk_source source)
+{
+    uint_32 aclk;
+
+    switch(source)
+    {
+        case SM_CLK:
+            return pwm_smclk();
+        case A_CLK:
+            if((CS -> CTL1 & CS_CTL1_SELA_MASK) == CS_CTL1_SELA__VLOCLK)
+                aclk = 9400;
+            else if(((CS -> CTL1 & CS_CTL1_SELA_MASK) == CS_CTL1_SELA__REFOCLK) && (CS -> CLKEN & CS_CLKEN_REFOFSEL))
+                aclk = 128000;
+            else
+                aclk = 32768;                                           // LFXT o REFO a 32 kHz.
+            return aclk >> ((CS -> CTL1 & CS_CTL1_DIVA_MASK) >> CS_CTL1_DIVA_OFS);
+        default:
+            return 0;
+    }
+}
+
+
+
+/***************************************************************************
+ * Function: UART_set_baud_rate
+ * Preconditions: Módulo en reset (SWRST).
+ * Overview: Calcula y escribe los divisores de un baud rate cualquiera.
+ * Input:  Registros del puerto, frecuencia de BRCLK, baud rate y si se
+ *         pide sobremuestreo.
+ * Output: IO_OK o IO_ERR (baud rate imposible con ese reloj).
+ *****************************************************************************/
+_mqx_int UART_set_baud_rate(EUSCI_A_Type _PTR_ module, uint_32 brclk, uint_32 baud, boolean oversampling)
+{
+    UART_BAUD_DIVISORS div;
+
+    if(uart_baud_divisors(brclk, baud, oversampling, &div) != IO_OK)
+        return IO_ERR;
+
+    module-> BRW   = div.brw;
+    module-> MCTLW = (div.brs << 8) + (div.brf << 4) + (div.os16 ? EUSCI_A_MCTLW_OS16 : 0);
+    return IO_OK;
+}
+
+/* Guarda un caracter recibido. Con la cola llena se descarta, salvo un fin de línea:
+ * ese reemplaza al último caracter para que la línea (truncada) se pueda leer. */
+static void uart_rx_put (UART_DEVICE_STRUCT_PTR dev, uint_8 c)
+{
+    boolean fin = (c == '\r') || (c == '\n');
+    uint_8  previo;
+
+    if (dev -> rx_head - dev -> rx_tail == UART_RX_BUFFER_SIZE)
+    {
+        dev -> rx_dropped++;
+        previo = dev -> rx_buffer[(dev -> rx_head - 1) & (UART_RX_BUFFER_SIZE - 1)];
+        if (!fin || (previo == '\r') || (previo == '\n'))
+            return;
+        dev -> rx_head--;
+    }
+
+    dev -> rx_buffer[dev -> rx_head++ & (UART_RX_BUFFER_SIZE - 1)] = c;
+    if (fin)
+        sem_post(&dev -> rx_lines);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : uart_isr
+* Returned Value   : None.
+* Comments         :
+*    Hwi de EUSCI_An (el argumento es su UART_DEVICE_STRUCT_PTR), así que puede
+*    postear rx_lines. Con TXIFG envía el siguiente caracter de la cola
+*    (escribir TXBUF limpia la bandera). Si la cola se vació apaga TXIE y, si
+*    hay un bloque esperando, se lo entrega al µDMA; los caracteres que lleguen
+*    mientras tanto esperan al fin del bloque. Con RXIFG guarda el caracter en
+*    la cola de recepción, o llama a la función del usuario (que debe leer RXBUF).
+*
+*END***********************************************************************************/
+
+void uart_isr (UArg arg)
+{
+    UART_DEVICE_STRUCT_PTR dev = (UART_DEVICE_STRUCT_PTR) arg;
+    EUSCI_A_Type _PTR_     module = dev -> module;
+
+    if ((module -> IE & EUSCI_A_IE_TXIE) && (module -> IFG & EUSCI_A_IFG_TXIFG))
+    {
+        if (dev -> tx_head != dev -> tx_tail)
+            module -> TXBUF = dev -> tx_buffer[dev -> tx_tail++ & (UART_TX_BUFFER_SIZE - 1)];
+        else
+        {
+            module -> IE &= ~EUSCI_A_IE_TXIE;
+            if ((dev -> dma_head != NULL) && !dev -> dma_busy)
+            {
+                dev -> dma_busy = TRUE;
+                dev -> dma_head -> status = UART_DMA_ACTIVE;
+                uart_dma_chunk(dev, dev -> dma_head);
+            }
+        }
+    }
+
+    if ((module -> IE & EUSCI_A_IE_RXIE) && (module -> IFG & EUSCI_A_IFG_RXIFG))
+    {
+        if (dev -> rx_func != NULL)
+            dev -> rx_func();
+        else
+            uart_rx_put(dev, (uint_8) module -> RXBUF);                 // Leer RXBUF limpia la bandera.
+    }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : uart_dma_isr
+* Returned Value   : None.
+* Comments         :
+*    Hwi del µDMA de un puerto (el argumento es su UART_DEVICE_STRUCT_PTR).
+*    Fin de un tramo del µDMA del puerto (el último byte ya está en TXBUF, así
+*    que el buffer del usuario ya se puede reusar). Programa el siguiente tramo
+*    o cierra el bloque: lo marca terminado, avisa por callback y/o semáforo
+*    y devuelve TXBUF a uart_isr. DMA_INT0 es común a los canales sin
+*    interrupción propia, así que ahí se revisa la bandera del canal.
+*
+*END***********************************************************************************/
+
+void uart_dma_isr (UArg arg)
+{
+    UART_DEVICE_STRUCT_PTR  dev = (UART_DEVICE_STRUCT_PTR) arg;
+    UART_DMA_DESCRIPTOR_PTR d = dev -> dma_head;
+    uint_32                 channel = 1 << UART_DMA_CHANNEL(dev);
+
+    if ((UART_DMA_IRQ[dev -> num] == INT_DMA_INT0) && !(DMA_Channel -> INT0_SRCFLG & channel))
+        return;
+    DMA_Channel -> INT0_CLRFLG = channel;
+
+    if ((d == NULL) || !dev -> dma_busy)
+        return;
+
+    if (d -> sent < d -> length)
+    {
+        uart_dma_chunk(dev, d);
+        return;
+    }
+
+    dev -> dma_head = d -> next;
+    if (dev -> dma_head == NULL)
+        dev -> dma_tail = NULL;
+    dev -> dma_busy = FALSE;
+    uart_dma_wake(dev);                                                 // TXBUF libre para UART_TX_BLOCK.
+
+    d -> status = UART_DMA_DONE;
+    if (d -> callback != NULL)
+        d -> callback(d);
+    if (d -> done != NULL)
+        sem_post(d -> done);
+
+    dev -> module -> IE |= EUSCI_A_IE_TXIE;                             // Sigue la cola o el siguiente bloque.
+}
+
+/* Encola un caracter según la política, excluyendo solo a la ISR del puerto mientras mueve los índices. */
+static void uart_tx_put (UART_DEVICE_STRUCT_PTR dev, uint_8 c)
+{
+    boolean wait;
+
+    uart_tx_lock(dev);
+
+    if (dev -> tx_head - dev -> tx_tail == UART_TX_BUFFER_SIZE)         // Llena.
+    {
+        if (dev -> tx_policy == UART_TX_DROP)
+        {
+            dev -> tx_dropped++;
+            uart_tx_unlock(dev);
+            return;
+        }
+
+        if (dev -> tx_policy == UART_TX_OVERWRITE)
+            dev -> tx_dropped++;
+        else                                                            // UART_TX_BLOCK: se envía el más viejo a mano
+        {                                                               // cuando el µDMA suelta TXBUF.
+            while (dev -> dma_busy)
+            {
+                if ((__get_IPSR() != 0) || !uart_dma_irq_enabled(dev))
+                {
+                    dev -> tx_dropped++;                                // Nadie avisaría el fin del bloque:
+                    uart_tx_unlock(dev);                                // se comporta como UART_TX_DROP.
+                    return;
+                }
+
+                Int_disableInterrupt(UART_DMA_IRQ[dev -> num]);         // Revisar y apuntarse sin perder el aviso.
+                wait = dev -> dma_busy;
+                if (wait)
+                    dev -> tx_waiters++;
+                Int_enableInterrupt(UART_DMA_IRQ[dev -> num]);
+
+                uart_tx_unlock(dev);
+                if (wait)
+                    sem_wait(&dev -> dma_idle);                         // El hilo duerme hasta el fin del bloque.
+                uart_tx_lock(dev);
+            }
+
+            if (dev -> tx_head - dev -> tx_tail < UART_TX_BUFFER_SIZE)  // La ISR ya hizo lugar mientras dormía.
+            {
+                dev -> tx_buffer[dev -> tx_head++ & (UART_TX_BUFFER_SIZE - 1)] = c;
+                uart_tx_unlock(dev);
+                return;
+            }
+            while (!(dev -> module -> IFG & EUSCI_A_IFG_TXIFG));
+            dev -> module -> TXBUF = dev -> tx_buffer[dev -> tx_tail & (UART_TX_BUFFER_SIZE - 1)];
+        }
+        dev -> tx_tail++;
+    }
+
+    dev -> tx_buffer[dev -> tx_head++ & (UART_TX_BUFFER_SIZE - 1)] = c;
+    uart_tx_unlock(dev);                                                // Si el transmisor está libre, la ISR entra ya.
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : print
+* Returned Value   : None.
+* Comments         :
+*    Encola el mensaje completo en la consola (UART_CONSOLE) y regresa; la ISR
+*    lo envía. Ya no se apagan las interrupciones: el candado solo evita que
+*    los mensajes de dos hilos se mezclen. Los demás puertos se escriben con
+*    IO_IOCTL_SERIAL_WRITE o IO_IOCTL_SERIAL_DMA_WRITE.
+*
+*END***********************************************************************************/
+
+void print(char* message)
+{
+    pthread_mutex_lock(&UART_CONSOLE_DEV -> print_lock);
+    fputs(message, stdout);
+    pthread_mutex_unlock(&UART_CONSOLE_DEV -> print_lock);
+}
+
+/* Igual que print(), para datos binarios (pueden traer '\0'). */
+void print_raw(const uint_8 _PTR_ data, uint_32 length)
+{
+    uint_32 i;
+
+    pthread_mutex_lock(&UART_CONSOLE_DEV -> print_lock);
+    for (i = 0; i < length; i++)
+        uart_tx_put(UART_CONSOLE_DEV, data[i]);
+    pthread_mutex_unlock(&UART_CONSOLE_DEV -> print_lock);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : uart_write
+* Returned Value   : IO_OK or IO_ERR
+* Comments         :
+*    Encola bytes en cualquier puerto abierto con su política (UART_TX_BLOCK
+*    puede esperar). No pasa por ioctl(), así que no apaga las interrupciones
+*    de los demás drivers mientras espera; solo se llama desde hilos.
+*
+*END***********************************************************************************/
+
+_mqx_int uart_write(uint_32 port, const uint_8 _PTR_ data, uint_32 length)
+{
+    UART_DEVICE_STRUCT_PTR dev;
+    uint_32                i;
+
+    if ((port >= UART_MAX_PORTS) || ((data == NULL) && (length != 0)))
+        return IO_ERR;
+
+    dev = &uart_devices[port];
+    if (!dev -> open)
+        return IO_ERR;
+
+    pthread_mutex_lock(&dev -> print_lock);
+    for (i = 0; i < length; i++)
+        uart_tx_put(dev, data[i]);
+    pthread_mutex_unlock(&dev -> print_lock);
+
+    return IO_OK;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : print_begin / print_end / print_str / print_fixed
+* Returned Value   : None.
+* Comments         :
+*    Arman un mensaje directo en la cola, sin sprintf ni buffer intermedio.
+*    print_begin toma el candado de print() y print_end lo suelta; entre ambos,
+*    print_str encola una cadena y print_fixed un entero con 'decimals'
+*    decimales implícitos (2345 con 2 -> "23.45"), sin punto flotante.
+*
+*END***********************************************************************************/
+
+void print_begin(void)
+{
+    pthread_mutex_lock(&UART_CONSOLE_DEV -> print_lock);
+}
+
+void print_end(void)
+{
+    pthread_mutex_unlock(&UART_CONSOLE_DEV -> print_lock);
+}
+
+void print_str(const char* message)
+{
+    while (*message)
+        uart_tx_put(UART_CONSOLE_DEV, (uint_8) *message++);
+}
+
+void print_fixed(int_32 value, uint_32 decimals)
+{
+    char    digits[12];                                 // 10 dígitos de un uint_32, más el cero de relleno.
+    uint_32 magnitude = (value < 0) ? -(uint_32) value : (uint_32) value;
+    uint_32 n = 0;
+
+    if (decimals > 9)
+        decimals = 9;
+
+    do                                                  // Al revés, del menos significativo.
+    {
+        digits[n++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while ((magnitude != 0) || (n <= decimals));      // Al menos un dígito entero.
+
+    if (value < 0)
+        uart_tx_put(UART_CONSOLE_DEV, '-');
+    while (n--)
+    {
+        uart_tx_put(UART_CONSOLE_DEV, (uint_8) digits[n]);
+        if ((n == decimals) && (decimals != 0))
+            uart_tx_put(UART_CONSOLE_DEV, '.');
+    }
+}
+
+// FUNCIONES ESPECIALES A REDEFINIR.
+// Funciones redefinidas para poder usar printf: solo encolan.
+
+int fputc(int _c, register FILE* _fp)
+{
+  uart_tx_put(UART_CONSOLE_DEV, (uint_8) _c);
+
+  return((unsigned char)_c);
+}
+
+int fputs(const char* _ptr, register FILE* _fp)
+{
+  unsigned int i, longitud;
+
+  longitud = strlen(_ptr);
+
+  for(i = 0; i < longitud; i++)
+      uart_tx_put(UART_CONSOLE_DEV, (uint_8) _ptr[i]);
+
+  return longitud;
+}
@@ -1,188 +1,310 @@
- //FileName:        uart_f_MSP432.h
- //Dependencies:    None.
- //Processor:       MSP432
- //Board:			MSP432P401R
- //Program version: CCS V8.3 TI
- //Company:         Texas Instruments
- //Description:     Driver para UART por medio de archivos. Header File.
- //Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- //Updated:         12/2018
-
-#ifndef UART_F_MSP432_H_
-#define UART_F_MSP432_H_
-
-// DEFINICIN DE CONSTANTES ESPECIFICAS.
-
-/* Uso de pines UART 1.1 y 1.2. */
-#define PINES_UART_DEFAULT ( 0x0001 << 2 | 0x0001 << 3)
-#define PORT_UART_DEFAULT  ( 0x40004C00 )
-
-/* Macros para la re-definicin de funciones del sistema. */
-#define EUSCI_A_CMSIS(x) ((EUSCI_A_Type *) x)
-#define EUSCI_B_CMSIS(x) ((EUSCI_B_Type *) x)
-
-/* Fuente de reloj. */
-#define UCLK    0
-#define ACLK    1
-#define SMCLK   2
-
-/* Modo de comunicacin. */
-#define EIGHT_BITS    0
-#define SEVEN_BITS    1
-
-/* Direccin de transmisin. */
-#define LSB_FIRST 0
-#define MSB_FIRST 1
-
-/* Numero de bits de paro. */
-#define ONE_STOP_BIT 0
-#define TWO_STOP_BIT 1
-
-/* Oversampling. */
-#define NO_OVERSAMPLE 0
-#define OVERSAMPLE   1
-
-/* Activa o no interrupciones. */
-#define NO_INTERRUPTION 0
-#define INTERRUPTION    1
-
-/* Modo de comunicacin. */
-#define ASYNCHRONOUS     0
-#define SYNCHRONOUS      1
-
-/* Modo de comunicacin. */
-#define EIGHT_BITS    0
-#define SEVEN_BITS    1
-
-/* Numero de bits de paro. */
-#define ONE_STOP_BIT 0
-#define TWO_STOP_BIT 1
-
-/* Oversampling. */
-#define NO_OVERAMPLE 0
-#define OVERSAMPLE   1
-
-/* Activa o no interrupciones. */
-#define NO_INTERRUPTION 0
-#define INTERRUPTION    1
-
-/* Modo de comunicacin. */
-#define ASYNCHRONOUS     0
-#define SYNCHRONOUS      1
-
-/* Baud Rate's en el arreglo. */
-#define MAX_BAUD_RATE_CHANNELS 3
-
-/* Comando(s) IOCTL. */
-#define IO_IOCTL_SERIAL_IRQ_FUNCTION     0x20000001
-
-/* Defincin predeterminada. */
-#define MAIN_UART                   (uint32_t)(EUSCI_A0)
-
- // Enum que relaciona la fuente de reloj como opciones.
-typedef enum
-{
-   U_CLK = 0,
-   A_CLK,
-   SM_CLK
-}  Clk_source;
-
-// Enum que relaciona 3 opciones distinas de baud rate.
-typedef enum
-{
-   BR_9600 = 0,
-   BR_38400,
-   BR_115200
-}  Baud_Rate;
-
-// Enum que relaciona tipos de paridad.
-typedef enum
-{
-   NO_PARITY = 0,
-   ODD,
-   EVEN
-} Parity;
-
-/*
- *  Estructura uart_init_struct que contendr todas las definiciones
- *  de la configuracin de la comunicacin serial (inicializacin).
- */
-
-typedef struct uart_init_struct
-{
-  _mqx_int selected_port;
-  _mqx_int pins[2];
-  Clk_source clk;
-  Baud_Rate baud_rate;
-
-  _mqx_int parity;
-  boolean  data_bits;
-  boolean  oversampling;
-  boolean  stop_bits;
-  boolean  direction;
-
-  boolean  interruption_B;
-  boolean  interruption_E;
-
-} UART_INIT_STRUCT, _PTR_ UART_INIT_STRUCT_PTR;
-
-/*
- *  Estructura uart_init_struct que contendr lo ms importante
- *  en la configuracin del dispositivo.
- */
-
-typedef struct uart_struct
-{
-  _mqx_int selected_port;
-  _mqx_int pins[2];
-  Clk_source clk;
-  _mqx_int baud_rate;
-
-} UART_DEVICE_STRUCT, _PTR_ UART_DEVICE_STRUCT_PTR;
-
-// FUNCIONES PRINCIPALES.
-
-extern _mqx_int uart_open  (FILE_PTR_f, char_ptr, char_ptr);
-extern _mqx_int uart_close (FILE _PTR_);
-extern _mqx_int uart_read  (FILE_PTR_f, char_ptr, _mqx_int);
-extern _mqx_int uart_ioctl (FILE_PTR_f, _mqx_uint, pointer);
-
-
-// FUNCION(ES) DE CONFIGURACIN.
-extern uint_32 uart_hw_init (UART_INIT_STRUCT_PTR init_ptr, char _PTR_ open_name_ptr);
-
-// FUNCIONES ESPECFICAS.
-
-/* Establece el nmero de bits de datos. */
-extern void UART_data_bits(bool data_bits);
-/* Establece de donde se toma el reloj del puerto. */
-extern void UART_clck_source(Clk_source source);
-/* Establece de donde se toma el reloj del puerto. */
-extern void UART_mode(bool synchronization);
-/* Pone en alto la interrupcin por carcteres 'break'. */
-extern void UART_B_char_IE(bool interruption);
-/* Pone en alto la interrupcin por carcteres errneos. */
-extern void UART_E_char_IE(bool interruption);
-/* Establece si se debe contemplar sobremuestreo. */
-extern void UART_set_oversampling(bool oversampling);
-/* Establece si hay paridad o no. */
-extern void UART_set_parity(char parity);
-/* Establece el nmero de bits de paro en la comunicacin. */
-extern void UART_set_stop_bits(bool stop_bits);
-/* Establece la direccin de la transmisin (puede ser primero MSB, o LSB) */
-extern void UART_set_transmision_dir(bool direction);
-/* Establece los pines sobre los cuales se transmitir y recibir el UART. */
-extern void UART_set_location_pin(uint32_t selected_port,uint32_t selected_pins);
-/* Establece un baud rate de las opciones disponibles. */
-extern void UART_set_baud_rate(uint8_t standard);
-/* Forma ptima de imprimir apagando interrupciones. */
-extern void print(char* message);
-
-// Hay que redefinir estas funciones.
-int fputc(int _c, register FILE* _fp);
-int fputs(const char* _ptr, register FILE* _fp);
-
-
-// NOTA IMPORTANTE: EVITE (DESHABILITE) INTERRUPCIONES AL USAR DIRECTAMENTE "PRINTF".
-
-#endif
+ //FileName:        uart_f_MSP432.h
+ //Dependencies:    None.
+ //Processor:       MSP432
+ //Board:			MSP432P401R
+ //Program version: CCS V8.3 TI
+ //Company:         Texas Instruments
+ //Description:     Driver para UART por medio de archivos. Header File.
+ //Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ //Updated:         12/2018
+
+#ifndef UART_F_MSP432_H_
+#define UART_F_MSP432_H_
+
+// DEFINICIÓN DE CONSTANTES ESPECIFICAS.
+
+/* Uso de pines UART 1.1 y 1.2. */
+#define PINES_UART_DEFAULT ( 0x0001 << 2 | 0x0001 << 3)
+#define PORT_UART_DEFAULT  ( 0x40004C00 )
+
+/* Macros para la re-definición de funciones del sistema. */
+#define EUSCI_A_CMSIS(x) ((EUSCI_A_Type *) x)
+#define EUSCI_B_CMSIS(x) ((EUSCI_B_Type *) x)
+
+/* Fuente de reloj. */
+#define UCLK    0
+#define ACLK    1
+#define SMCLK   2
+
+/* Modo de comunicación. */
+#define EIGHT_BITS    0
+#define SEVEN_BITS    1
+
+/* Dirección de transmisión. */
+#define LSB_FIRST 0
+#define MSB_FIRST 1
+
+/* Numero de bits de paro. */
+#define ONE_STOP_BIT 0
+#define TWO_STOP_BIT 1
+
+/* Oversampling. */
+#define NO_OVERSAMPLE 0
+#define OVERSAMPLE   1
+
+/* Activa o no interrupciones. */
+#define NO_INTERRUPTION 0
+#define INTERRUPTION    1
+
+/* Modo de comunicación. */
+#define ASYNCHRONOUS     0
+#define SYNCHRONOUS      1
+
+/* Modo de comunicación. */
+#define EIGHT_BITS    0
+#define SEVEN_BITS    1
+
+/* Numero de bits de paro. */
+#define ONE_STOP_BIT 0
+#define TWO_STOP_BIT 1
+
+/* Oversampling. */
+#define NO_OVERAMPLE 0
+#define OVERSAMPLE   1
+
+/* Activa o no interrupciones. */
+#define NO_INTERRUPTION 0
+#define INTERRUPTION    1
+
+/* Modo de comunicación. */
+#define ASYNCHRONOUS     0
+#define SYNCHRONOUS      1
+
+/* Comando(s) IOCTL. */
+#define IO_IOCTL_SERIAL_IRQ_FUNCTION     0x20000001
+#define IO_IOCTL_SERIAL_TX_POLICY        0x20000002     // uint_32_ptr con UART_TX_DROP, UART_TX_BLOCK o UART_TX_OVERWRITE.
+#define IO_IOCTL_SERIAL_TX_STATUS        0x20000003     // UART_TX_STATUS_PTR.
+#define IO_IOCTL_SERIAL_DMA_WRITE        0x20000004     // UART_DMA_DESCRIPTOR_PTR; encola un bloque para el µDMA.
+#define IO_IOCTL_SERIAL_RX_STATUS        0x20000005     // UART_RX_STATUS_PTR.
+#define IO_IOCTL_SERIAL_WRITE            0x20000006     // UART_WRITE_STRUCT_PTR; encola sin esperar (para esperar, uart_write).
+
+/* Puertos: "uart:" o "uart:0" es EUSCI_A0, "uart:1".."uart:3" son EUSCI_A1..A3. */
+#define UART_MAX_PORTS          4
+#define UART_CONSOLE            0       // Puerto de print(), printf() y compañía.
+
+/* Cola de transmisión (potencia de 2). */
+#define UART_TX_BUFFER_SIZE     256
+
+/* Cola de recepción (potencia de 2); fread_f() entrega una línea a la vez. */
+#define UART_RX_BUFFER_SIZE     128
+
+/* Qué hacer si la cola de transmisión está llena. */
+#define UART_TX_DROP            0       // Descarta el caracter nuevo.
+#define UART_TX_BLOCK           1       // Espera a que salga el más viejo (predeterminado).
+#define UART_TX_OVERWRITE       2       // Descarta el caracter más viejo.
+
+/* Definción predeterminada. */
+#define MAIN_UART                   (uint32_t)(EUSCI_A0)
+
+ // Enum que relaciona la fuente de reloj como opciones.
+typedef enum
+{
+   U_CLK = 0,
+   A_CLK,
+   SM_CLK
+}  Clk_source;
+
+// Baud rates comunes. El valor es el baud rate mismo: también se acepta cualquier
+// otro valor, y los divisores se calculan con el reloj que tenga BRCLK.
+typedef enum
+{
+   BR_9600   = 9600,
+   BR_38400  = 38400,
+   BR_115200 = 115200,
+   BR_230400 = 230400,
+   BR_460800 = 460800,
+   BR_921600 = 921600
+}  Baud_Rate;
+
+// Enum que relaciona tipos de paridad.
+typedef enum
+{
+   NO_PARITY = 0,
+   ODD,
+   EVEN
+} Parity;
+
+/*
+ *  Estructura uart_init_struct que contendrá todas las definiciones
+ *  de la configuración de la comunicación serial (inicialización).
+ *  Los pines los fija el módulo (P1.2/3, P2.2/3, P3.2/3 y P9.6/7 para
+ *  A0..A3); selected_port y pins solo se guardan.
+ */
+
+typedef struct uart_init_struct
+{
+  _mqx_int selected_port;
+  _mqx_int pins[2];
+  Clk_source clk;
+  Baud_Rate baud_rate;
+
+  _mqx_int parity;
+  boolean  data_bits;
+  boolean  oversampling;
+  boolean  stop_bits;
+  boolean  direction;
+
+  boolean  interruption_B;
+  boolean  interruption_E;
+
+} UART_INIT_STRUCT, _PTR_ UART_INIT_STRUCT_PTR;
+
+/* Estado de la cola de transmisión. */
+typedef struct uart_tx_status
+{
+  uint_32  pending;             // Caracteres por enviar.
+  uint_32  dropped;             // Caracteres descartados por cola llena (DROP u OVERWRITE).
+
+} UART_TX_STATUS, _PTR_ UART_TX_STATUS_PTR;
+
+/* Estado de la cola de recepción. */
+typedef struct uart_rx_status
+{
+  uint_32  pending;             // Caracteres sin leer.
+  uint_32  dropped;             // Caracteres descartados por cola llena.
+
+} UART_RX_STATUS, _PTR_ UART_RX_STATUS_PTR;
+
+/*
+ *  Bloque para transmitir por µDMA (canales 0, 2, 4 y 6 para A0..A3 TX). El driver no
+ *  copia nada: el descriptor y 'data' son del usuario y no deben tocarse
+ *  hasta que 'status' sea UART_DMA_DONE. Al terminar se llama 'callback'
+ *  (desde la interrupción del DMA) y/o se publica 'done'; ambos opcionales.
+ */
+
+#define UART_DMA_QUEUED     0
+#define UART_DMA_ACTIVE     1
+#define UART_DMA_DONE       2
+
+typedef struct uart_dma_descriptor
+{
+  const uint_8 _PTR_                    data;
+  uint_32                               length;
+  void (*callback) (struct uart_dma_descriptor _PTR_);
+  sem_t _PTR_                           done;
+
+  // Uso del driver.
+  struct uart_dma_descriptor _PTR_      next;
+  uint_32                               sent;           // Bytes ya entregados al DMA.
+  volatile uint_32                      status;
+
+} UART_DMA_DESCRIPTOR, _PTR_ UART_DMA_DESCRIPTOR_PTR;
+
+/* Bytes para IO_IOCTL_SERIAL_WRITE (se copian a la cola; lo que no cabe se descarta). */
+typedef struct uart_write_struct
+{
+  const uint_8 _PTR_  data;
+  uint_32             length;
+
+} UART_WRITE_STRUCT, _PTR_ UART_WRITE_STRUCT_PTR;
+
+/*
+ *  Estructura de cada puerto abierto: configuración, colas de transmisión y
+ *  recepción, bloques del µDMA y candado de mensajes. Cada puerto tiene su
+ *  propia interrupción y su propio canal de µDMA, así que ninguno espera a otro.
+ */
+
+typedef struct uart_struct
+{
+  _mqx_int selected_port;
+  _mqx_int pins[2];
+  Clk_source clk;
+  _mqx_int baud_rate;
+
+  // Uso del driver.
+  EUSCI_A_Type _PTR_               module;
+  uint_32                          num;             // 0..3 (EUSCI_A0..A3).
+  boolean                          open;
+  boolean                          ready;           // Ya está registrada su interrupción.
+
+  // Cola de transmisión: índices libres; solo quien escribe mueve 'tx_head' y solo la
+  // ISR mueve 'tx_tail' (salvo con UART_TX_OVERWRITE, que lo hace con la ISR excluida).
+  uint_8                           tx_buffer [UART_TX_BUFFER_SIZE];
+  volatile uint_32                 tx_head;
+  volatile uint_32                 tx_tail;
+  uint_32                          tx_policy;
+  uint_32                          tx_dropped;
+
+  // Bloques por µDMA; el primero es el que está en curso.
+  UART_DMA_DESCRIPTOR_PTR          dma_head;
+  UART_DMA_DESCRIPTOR_PTR          dma_tail;
+  volatile boolean                 dma_busy;        // El µDMA es dueño de TXBUF.
+  uint_32                          tx_waiters;      // Hilos con UART_TX_BLOCK esperando a que lo suelte.
+  sem_t                            dma_idle;        // Se postea una vez por cada uno al terminar el bloque.
+
+  // Cola de recepción: la llena la ISR y la vacía uart_read, una línea a la vez.
+  uint_8                           rx_buffer [UART_RX_BUFFER_SIZE];
+  volatile uint_32                 rx_head;
+  volatile uint_32                 rx_tail;
+  uint_32                          rx_dropped;
+  sem_t                            rx_lines;        // Cuenta fines de línea en la cola.
+  void                             (*rx_func)(void);   // Función del usuario (sustituye a la cola).
+
+  pthread_mutex_t                  print_lock;      // Un mensaje a la vez.
+
+} UART_DEVICE_STRUCT, _PTR_ UART_DEVICE_STRUCT_PTR;
+
+/* Registros de cada puerto, y puertos con RXIE encendido (los apaga Int_disable). */
+extern EUSCI_A_Type _PTR_ const UART_MODULE [UART_MAX_PORTS];
+extern uint_32                  uart_rx_ports;
+
+// FUNCIONES PRINCIPALES.
+
+extern _mqx_int uart_open  (FILE_PTR_f, char_ptr, char_ptr);
+extern _mqx_int uart_close (FILE _PTR_);
+extern _mqx_int uart_read  (FILE_PTR_f, char_ptr, _mqx_int);
+extern _mqx_int uart_ioctl (FILE_PTR_f, _mqx_uint, pointer);
+
+
+// FUNCION(ES) DE CONFIGURACIÓN.
+extern uint_32 uart_hw_init (UART_DEVICE_STRUCT_PTR dev, UART_INIT_STRUCT_PTR init_ptr);
+
+// FUNCIONES ESPECÍFICAS.
+
+/* Establece el número de bits de datos. */
+extern void UART_data_bits(EUSCI_A_Type _PTR_ module, bool data_bits);
+/* Establece de donde se toma el reloj del puerto. */
+extern void UART_clck_source(EUSCI_A_Type _PTR_ module, Clk_source source);
+/* Establece de donde se toma el reloj del puerto. */
+extern void UART_mode(EUSCI_A_Type _PTR_ module, bool synchronization);
+/* Pone en alto la interrupción por carácteres 'break'. */
+extern void UART_B_char_IE(EUSCI_A_Type _PTR_ module, bool interruption);
+/* Pone en alto la interrupción por carácteres erróneos. */
+extern void UART_E_char_IE(EUSCI_A_Type _PTR_ module, bool interruption);
+/* Establece si se debe contemplar sobremuestreo. */
+extern void UART_set_oversampling(EUSCI_A_Type _PTR_ module, bool oversampling);
+/* Establece si hay paridad o no. */
+extern void UART_set_parity(EUSCI_A_Type _PTR_ module, char parity);
+/* Establece el número de bits de paro en la comunicación. */
+extern void UART_set_stop_bits(EUSCI_A_Type _PTR_ module, bool stop_bits);
+/* Establece la dirección de la transmisión (puede ser primero MSB, o LSB) */
+extern void UART_set_transmision_dir(EUSCI_A_Type _PTR_ module, bool direction);
+/* Establece los pines sobre los cuales se transmitirá y recibirá el UART. */
+extern void UART_set_location_pin(uint32_t selected_port,uint32_t selected_pins);
+/* Frecuencia de BRCLK según la fuente de reloj (0 si no se conoce, como UCLK). */
+extern uint_32 UART_brclk(Clk_source source);
+/* Establece un baud rate cualquiera a partir de la frecuencia de BRCLK. */
+extern _mqx_int UART_set_baud_rate(EUSCI_A_Type _PTR_ module, uint_32 brclk, uint_32 baud, boolean oversampling);
+/* Imprime un mensaje completo (sin mezclarse con otros hilos) a través de la cola de UART_CONSOLE. */
+extern void print(char* message);
+extern void print_raw(const uint_8 _PTR_ data, uint_32 length);
+/* Encola bytes en un puerto abierto (0..3) con su política, sin pasar por ioctl(). */
+extern _mqx_int uart_write(uint_32 port, const uint_8 _PTR_ data, uint_32 length);
+/* Mensaje armado por partes directo en la cola (sin sprintf ni punto flotante). */
+extern void print_begin(void);
+extern void print_end(void);
+extern void print_str(const char* message);
+extern void print_fixed(int_32 value, uint_32 decimals);
+/* Interrupciones de un puerto (EUSCI_An y su canal de µDMA); uart_hw_init las registra
+   como Hwi con el UART_DEVICE_STRUCT_PTR del puerto como argumento. */
+extern void uart_isr(UArg arg);
+extern void uart_dma_isr(UArg arg);
+
+// Hay que redefinir estas funciones.
+int fputc(int _c, register FILE* _fp);
+int fputs(const char* _ptr, register FILE* _fp);
+
+
+// NOTA: fputc/fputs solo encolan; desde varios hilos use print() para no mezclar mensajes.
+
+#endif
@@ -1,111 +1,180 @@
- // FileName:        HVAC.h
- // Dependencies:    None
- // Processor:       MSP432
- // Board:           MSP432P401R
- // Program version: CCS V8.3 TI
- // Company:         Texas Instruments
- // Description:     Incluye librer�as, define ciertas macros, as� como llevar un control de versiones.
- // Authors:         Jos� Luis Chac�n M. y Jes�s Alejandro Navarro Acosta.
- // Updated:         11/2018
-
-#ifndef _hvac_h_
-#define _hvac_h_
-
-#pragma once
-
-#define __MSP432P401R__
-#define  __SYSTEM_CLOCK    48000000 // Frecuencias funcionales recomendadas: 12, 24 y 48 Mhz.
-
-/* Archivos de cabecera importantes. */
-#include <unistd.h>
-#include <stdint.h>
-#include <stddef.h>
-#include <stdbool.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-/* Archivos de cabecera POSIX. */
-#include <pthread.h>
-#include <semaphore.h>
-#include <ti/posix/tirtos/_pthread.h>
-#include <ti/sysbios/knl/Task.h>
-
-/* Archivos de cabecera RTOS. */
-#include <ti/sysbios/BIOS.h>
-#include <ti/sysbios/knl/Event.h>
-
-/* Archivos de cabecera de drivers de Objetos. */
-#include "Drivers_obj/BSP.h"
-
-// Definiciones del estado 'normal' de los botones externos a la tarjeta (solo hay dos botones).
-#define GND 0
-#define VCC 1
-#define NORMAL_STATE_EXTRA_BUTTONS GND  // Aqui se coloca GND o VCC.
-
-// Definiciones del sistema.
-#define MAX_MSG_SIZE 64
-#define MAX_ADC_VALUE 16383
-#define MAIN_UART (uint32_t)(EUSCI_A0)
-
-// Definiciones del RTOS.
-#define THREADSTACKSIZE1 1500
-#define THREADSTACKSIZE2 1500
-#define THREADSTACKSIZE3 1500
-
-// Definici�n de delay para threads de entradas y salidas.
-#define DELAY 4000
-
-/* Enumeradores para la descripci�n del sistema. */
-
-enum FAN        // Para el fan (abanico).
-{
-    On,
-    Auto,
-};
-
-enum SYSTEM     // Para el sistema cuando FAN est� en auto (cool, off y heat, o no considerar ninguno y usar fan only).
-{
-    Cool,
-    Off,
-    Heat,
-    FanOnly,
-};
-
-struct EstadoEntradas       // Estructura que incluye el estado de las entradas.
-{
-    uint8_t  SystemState;
-    uint8_t     FanState;
-} EstadoEntradas;
-
-/* Funciones. */
-
-/* Funci�n de interrupci�n para botones de setpoint. */
-extern void INT_SWI(void);
-
-/* Funciones de inicializaci�n. */
-extern boolean HVAC_InicialiceIO   (void);
-extern boolean HVAC_InicialiceADC  (void);
-extern boolean HVAC_InicialiceUART (void);
-
-/* Funciones principales. */
-extern void HVAC_ActualizarEntradas(void);
-extern void HVAC_ActualizarSalidas(void);
-extern void HVAC_Heartbeat(void);
-extern void HVAC_PrintState(void);
-
-/* Funciones para los estados Heat y Cool. */
-extern void HVAC_Heat(void);
-extern void HVAC_Cool(void);
-
-/* Funciones para incrementar o disminuir setpoint. */
-extern void HVAC_SetPointUp(void);
-extern void HVAC_SetPointDown(void);
-
-/* Funci�n especial que imprime el mensaje asegurando que no habr� interrupciones y por ende,
- * un funcionamiento no �ptimo.                                                             */
-extern void print(char* message);
-
-pthread_t           entradas_thread, salidas_thread, heartbeat_thread;
-
-#endif
+ // FileName:        HVAC.h
+ // Dependencies:    None
+ // Processor:       MSP432
+ // Board:           MSP432P401R
+ // Program version: CCS V8.3 TI
+ // Company:         Texas Instruments
+ // Description:     Incluye librer�as, define ciertas macros, as� como llevar un control de versiones.
+ // Authors:         Jos� Luis Chac�n M. y Jes�s Alejandro Navarro Acosta.
+ // Updated:         11/2018
+
+#ifndef _hvac_h_
+#define _hvac_h_
+
+#pragma once
+
+#define __MSP432P401R__
+#define  __SYSTEM_CLOCK    48000000 // Frecuencias funcionales recomendadas: 12, 24 y 48 Mhz.
+
+/* Archivos de cabecera importantes. */
+#include <unistd.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <ctype.h>
+
+/* Archivos de cabecera POSIX. */
+#include <pthread.h>
+#include <semaphore.h>
+#include <ti/posix/tirtos/_pthread.h>
+#include <ti/sysbios/knl/Task.h>
+
+/* Archivos de cabecera RTOS. */
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/family/arm/m3/Hwi.h>
+
+/* Archivos de cabecera de drivers de Objetos. */
+#include "Drivers_obj/BSP.h"
+
+// Definiciones del estado 'normal' de los botones externos a la tarjeta (solo hay dos botones).
+#define GND 0
+#define VCC 1
+#define NORMAL_STATE_EXTRA_BUTTONS GND  // Aqui se coloca GND o VCC.
+
+// Definiciones del sistema.
+#define MAX_MSG_SIZE 64
+#define MAX_ADC_VALUE 16383
+#define MAIN_UART (uint32_t)(EUSCI_A0)
+
+// Definiciones del RTOS.
+#define THREADSTACKSIZE1 1500
+#define THREADSTACKSIZE2 1500
+#define THREADSTACKSIZE3 1500
+#define THREADSTACKSIZE4 1500
+#define THREADSTACKSIZE5 1500
+
+// Interprete de comandos por UART.
+#define MAX_CMD_SIZE 32         // Caracteres por linea de comando.
+#define SETPOINT_MIN 10.0       // Limites del valor deseado por comando.
+#define SETPOINT_MAX 35.0
+
+// Esclavo Modbus RTU (puerto y Timer_A en BSP.h; mapa de registros en HVAC_Modbus.c).
+#define MODBUS_ADDRESS 1
+
+// Formato de los reportes periodicos (se cambia con el comando FORMAT).
+#define REPORT_TEXT             0
+#define REPORT_BINARY           1
+#define TELEMETRY_TYPE_STATE    0x01
+#define TELEMETRY_FRAME_SIZE    14      // Con CRC; ver HVAC_Telemetry.c.
+
+// Reportes periodicos: solo con cambios significativos, a lo mas uno cada
+// REPORT_MIN_INTERVAL_MS y, sin cambios, uno cada REPORT_HEARTBEAT_MS.
+#define REPORT_MIN_INTERVAL_MS  250
+#define REPORT_HEARTBEAT_MS     5000
+#define REPORT_TEMP_DELTA       10      // Centesimas de grado (0.1 C).
+#define REPORT_DUTY_DELTA       50      // Por mil de la velocidad del abanico.
+#define REPORT_OUTPUTS_MASK     0x0B    // Fan, heat y cool: el LED de heartbeat cambia siempre.
+
+// Bitacora tokenizada: el formato queda en .log_fmt (no se carga al MSP432) y solo
+// viaja su identificador, la marca de tiempo y los argumentos. Tools/log_decoder.py
+// toma los formatos del .out y arma el texto en la PC.
+#define TELEMETRY_TYPE_LOG      0x02
+#define LOG_FMT_BASE            0x90000000      // Igual que .log_fmt en MSP_EXP432P401R_TIRTOS.cmd.
+#define LOG_MAX_ARGS            4               // Palabras de 32 bits por mensaje.
+
+#define HVAC_LOG(fmt, ...)                                                              \
+    do {                                                                                \
+        static const char __attribute__((section(".log_fmt"))) log_fmt_[] = fmt;        \
+        const uint32_t log_args_[] = { 0, ##__VA_ARGS__ };                              \
+        HVAC_Log(log_fmt_, sizeof(log_args_) / sizeof(log_args_[0]) - 1, &log_args_[1]); \
+    } while(0)
+
+// Los float se pasan por su patron de bits; el decodificador los lee con %f.
+#define LOG_FLOAT(x)            HVAC_LogFloat(x)
+
+// Definici�n de delay para threads de entradas y salidas.
+#define DELAY 4000
+
+// Velocidad del abanico: por mil de PWM por grado de diferencia (4 grados o mas, velocidad maxima).
+#define FAN_PWM_GAIN 250
+
+/* Enumeradores para la descripci�n del sistema. */
+
+enum FAN        // Para el fan (abanico).
+{
+    On,
+    Auto,
+};
+
+enum SYSTEM     // Para el sistema cuando FAN est� en auto (cool, off y heat, o no considerar ninguno y usar fan only).
+{
+    Cool,
+    Off,
+    Heat,
+    FanOnly,
+};
+
+struct EstadoEntradas       // Estructura que incluye el estado de las entradas.
+{
+    uint8_t  SystemState;
+    uint8_t     FanState;
+} EstadoEntradas;
+
+/* Funciones. */
+
+/* Funciones de inicializaci�n. */
+extern boolean HVAC_InicialiceIO   (void);
+extern boolean HVAC_InicialiceADC  (void);
+extern boolean HVAC_InicialiceUART (void);
+extern boolean HVAC_InicialiceModbus (void);
+
+/* Funciones principales. */
+extern void HVAC_ActualizarEntradas(void);
+extern void HVAC_ActualizarSalidas(void);
+extern void HVAC_Heartbeat(void);
+extern void HVAC_PrintState(void);
+extern void HVAC_EnviaEstado(void);
+extern int32_t HVAC_Centesimas(float grados);
+extern void HVAC_SetMode(uint8_t fan_sel, uint8_t sys_sel);
+
+/* Interprete de comandos por UART. */
+extern void HVAC_Comandos(void);
+extern void HVAC_EnviaEstadisticas(void);
+
+/* Esclavo Modbus RTU. */
+extern MODBUS_SLAVE modbus_esclavo;
+extern volatile uint32_t modbus_errores_trama;
+extern void HVAC_Modbus(void);
+
+/* Telemetria binaria. */
+extern uint8_t  formato_reporte;
+extern void     HVAC_EnviaTelemetria(void);
+extern uint16_t HVAC_Crc16(const uint8_t *data, uint32_t length);
+extern uint32_t HVAC_Cobs(const uint8_t *in, uint32_t length, uint8_t *out);
+
+/* Bitacora tokenizada (usar HVAC_LOG). */
+extern void     HVAC_Log(const char *fmt, uint32_t nargs, const uint32_t *args);
+extern uint32_t HVAC_LogFloat(float x);
+extern void     HVAC_LogFlush(void);
+
+/* Funciones para los estados Heat y Cool. */
+extern void HVAC_Heat(void);
+extern void HVAC_Cool(void);
+extern void HVAC_Fan(uint_32 duty);
+
+/* Funciones para incrementar o disminuir setpoint. */
+extern void HVAC_SetPointUp(void);
+extern void HVAC_SetPointDown(void);
+
+/* Imprime un mensaje completo por la cola de transmision del UART, sin esperar a que salga. */
+extern void print(char* message);
+
+pthread_t           entradas_thread, salidas_thread, heartbeat_thread, comandos_thread, modbus_thread;
+
+#endif
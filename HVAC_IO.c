@@ -1,529 +1,750 @@
- // FileName:        HVAC_IO.c
- // Dependencies:    HVAC.h
- // Processor:       MSP432
- // Board:           MSP432P401R
- // Program version: CCS V8.3 TI
- // Company:         Texas Instruments
- // Description:     Funciones de control de HW a trav�s de estados y objetos.
- // Authors:         Jos� Luis Chac�n M. y Jes�s Alejandro Navarro Acosta.
- // Updated:         11/2018
-
-#include "HVAC.h"
-
-/* Definici�n de botones. */
-#define TEMP_PLUS   BSP_BUTTON1     /* Botones de suma y resta al valor deseado, funcionan con interrupciones. */
-#define TEMP_MINUS  BSP_BUTTON2
-
-#define FAN_ON      BSP_BUTTON3     /* Botones para identificaci�n del estado del sistema. */
-#define FAN_AUTO    BSP_BUTTON4
-#define SYSTEM_COOL BSP_BUTTON5
-#define SYSTEM_OFF  BSP_BUTTON6
-#define SYSTEM_HEAT BSP_BUTTON7
-
-/* Definici�n de leds. */
-#define FAN_LED     BSP_LED1        /* Leds para denotar el estado de las salidas. */
-#define HEAT_LED    BSP_LED2
-#define HBeat_LED   BSP_LED3
-#define COOL_LED    BSP_LED4
-
-/* Variables sobre las cuales se maneja el sistema. */
-
-float TemperaturaActual = 20;  // Temperatura.
-float SetPoint = 25.0;         // V. Deseado.
-
-char state[MAX_MSG_SIZE];      // Cadena a imprimir.
-
-bool toggle = 0;               // Toggle para el heartbeat.
-_mqx_int delay;                // Delay aplicado al heartbeat.
-bool event = FALSE;
-
-bool FAN_LED_State = 0;                                     // Estado led_FAN.
-const char* SysSTR[] = {"Cool","Off","Heat","Only Fan"};    // Control de los estados.
-
-/* Archivos sobre los cuales se escribe toda la informaci�n */
-FILE _PTR_ input_port = NULL, _PTR_ output_port = NULL;                  // Entradas y salidas.
-FILE _PTR_ fd_adc = NULL, _PTR_ fd_ch_T = NULL, _PTR_ fd_ch_H = NULL;    // ADC: ch_T -> Temperature, ch_H -> Pot.
-FILE _PTR_ fd_uart = NULL;                                               // Comunicaci�n serial as�ncrona.
-
-// Estructuras iniciales.
-
-const ADC_INIT_STRUCT adc_init =
-{
-    ADC_RESOLUTION_DEFAULT,                                                     // Resoluci�n.
-    ADC_CLKDiv8                                                                 // Divisi�n de reloj.
-};
-
-const ADC_INIT_CHANNEL_STRUCT adc_ch_param =
-{
-    TEMPERATURE_ANALOG_PIN,                                                      // Fuente de lectura, 'ANx'.
-    ADC_CHANNEL_MEASURE_LOOP | ADC_CHANNEL_START_NOW | ADC_INTERNAL_TEMPERATURE, // Banderas de inicializaci�n (temperatura)
-    50000,                                                                       // Periodo en uS, base 1000.
-    ADC_TRIGGER_1                                                                // Trigger l�gico que puede activar este canal.
-};
-
-const ADC_INIT_CHANNEL_STRUCT adc_ch_param2 =
-{
-    AN1,                                                                         // Fuente de lectura, 'ANx'.
-    ADC_CHANNEL_MEASURE_LOOP,                                                    // Banderas de inicializaci�n (pot).
-    50000,                                                                       // Periodo en uS, base 1000.
-    ADC_TRIGGER_2                                                                // Trigger l�gico que puede activar este canal.
-};
-
-static uint_32 data[] =                                                          // Formato de las entradas.
-{                                                                                // Se prefiri� un solo formato.
-     TEMP_PLUS,
-     TEMP_MINUS,
-     FAN_ON,
-     FAN_AUTO,
-     SYSTEM_COOL,
-     SYSTEM_OFF,
-     SYSTEM_HEAT,
-
-     GPIO_LIST_END
-};
-
-static const uint_32 fan[] =                                                    // Formato de los leds, uno por uno.
-{
-     FAN_LED,
-     GPIO_LIST_END
-};
-
-static const uint_32 heat[] =                                                   // Formato de los leds, uno por uno.
-{
-     HEAT_LED,
-     GPIO_LIST_END
-};
-
-const uint_32 hbeat[] =                                                         // Formato de los leds, uno por uno.
-{
-     HBeat_LED,
-     GPIO_LIST_END
-};
-
-static const uint_32 cool[] =                                                   // Formato de los leds, uno por uno.
-{
-     COOL_LED,
-     GPIO_LIST_END
-};
-
-
-/**********************************************************************************
- * Function: INT_SWI
- * Preconditions: Interrupci�n habilitada, registrada e inicializaci�n de m�dulos.
- * Overview: Funci�n que es llamada cuando se genera
- *           la interrupci�n del bot�n SW1 o SW2.
- * Input: None.
- * Output: None.
- **********************************************************************************/
-void INT_SWI(void)
-{
-    Int_clear_gpio_flags(input_port);
-
-    ioctl(input_port, GPIO_IOCTL_READ, &data);
-
-    if((data[0] & GPIO_PIN_STATUS) == 0)        // Lectura de los pines, �ndice cero es TEMP_PLUS.
-        HVAC_SetPointUp();
-
-    else if((data[1] & GPIO_PIN_STATUS) == 0)   // Lectura de los pines, �ndice uno es TEMP_MINUS.
-        HVAC_SetPointDown();
-
-    return;
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_InicialiceIO
-* Returned Value   : boolean; inicializaci�n correcta.
-* Comments         :
-*    Abre los archivos e inicializa las configuraciones deseadas de entrada y salida GPIO.
-*
-*END***********************************************************************************/
-boolean HVAC_InicialiceIO(void)
-{
-    // Estructuras iniciales de entradas y salidas.
-    const uint_32 output_set[] =
-    {
-         FAN_LED   | GPIO_PIN_STATUS_0,
-         HEAT_LED  | GPIO_PIN_STATUS_0,
-         HBeat_LED | GPIO_PIN_STATUS_0,
-         COOL_LED  | GPIO_PIN_STATUS_0,
-         GPIO_LIST_END
-    };
-
-    const uint_32 input_set[] =
-    {
-        TEMP_PLUS,
-        TEMP_MINUS,
-        FAN_ON,
-        FAN_AUTO,
-        SYSTEM_COOL,
-        SYSTEM_OFF,
-        SYSTEM_HEAT,
-
-        GPIO_LIST_END
-    };
-
-    // Iniciando GPIO.
-    ////////////////////////////////////////////////////////////////////
-
-    output_port =  fopen_f("gpio:write", (char_ptr) &output_set);
-    input_port =   fopen_f("gpio:read", (char_ptr) &input_set);
-
-    if (output_port) { ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, NULL); }   // Inicialmente salidas apagadas.
-    ioctl (input_port, GPIO_IOCTL_SET_IRQ_FUNCTION, INT_SWI);               // Declarando interrupci�n.
-
-    return (input_port != NULL) && (output_port != NULL);
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_InicialiceADC
-* Returned Value   : boolean; inicializaci�n correcta.
-* Comments         :
-*    Abre los archivos e inicializa las configuraciones deseadas para
-*    el m�dulo general ADC y dos de sus canales; uno para la temperatura, otro para
-*    el heartbeat.
-*
-*END***********************************************************************************/
-
-boolean HVAC_InicialiceADC (void)
-{
-    // Iniciando ADC y canales.
-    ////////////////////////////////////////////////////////////////////
-
-    fd_adc   = fopen_f("adc:",  (const char*) &adc_init);               // M�dulo.
-    fd_ch_T =  fopen_f("adc:1", (const char*) &adc_ch_param);           // Canal uno, arranca al instante.
-    fd_ch_H =  fopen_f("adc:2", (const char*) &adc_ch_param2);          // Canal dos.
-
-    return (fd_adc != NULL) && (fd_ch_T != NULL) && (fd_ch_H != NULL);  // Valida que se crearon los archivos.
-}
-
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_InicialiceUART
-* Returned Value   : boolean; inicializaci�n correcta.
-* Comments         :
-*    Abre los archivos e inicializa las configuraciones deseadas para
-*    configurar el modulo UART (comunicaci�n as�ncrona).
-*
-*END***********************************************************************************/
-boolean HVAC_InicialiceUART (void)
-{
-    // Estructura inicial de comunicaci�n serie.
-    const UART_INIT_STRUCT uart_init =
-    {
-        /* Selected port */        1,
-        /* Selected pins */        {1,2},
-        /* Clk source */           SM_CLK,
-        /* Baud rate */            BR_115200,
-
-        /* Usa paridad */          NO_PARITY,
-        /* Bits protocolo  */      EIGHT_BITS,
-        /* Sobremuestreo */        OVERSAMPLE,
-        /* Bits de stop */         ONE_STOP_BIT,
-        /* Direccion TX */         LSB_FIRST,
-
-        /* Int char's \b */        NO_INTERRUPTION,
-        /* Int char's err�neos */  NO_INTERRUPTION
-    };
-
-    // Inicializaci�n de archivo.
-    fd_uart = fopen_f("uart:", (const char*) &uart_init);
-
-    return (fd_uart != NULL); // Valida que se crearon los archivos.
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_ActualizarEntradas
-* Returned Value   : None.
-* Comments         :
-*    Actualiza los variables indicadores de las entradas sobre las cuales surgir�n
-*    las salidas.
-*
-*END***********************************************************************************/
-void HVAC_ActualizarEntradas(void)
-{
-    static bool ultimos_estados[] = {FALSE, FALSE, FALSE, FALSE, FALSE};        //PARA CONTROL DE EVENTOS
-
-    ioctl(fd_ch_T, IOCTL_ADC_READ_TEMPERATURE, (pointer) &TemperaturaActual);   // Actualiza valor de temperatura.
-    ioctl(input_port, GPIO_IOCTL_READ, &data);
-
-    if((data[2] & GPIO_PIN_STATUS) != NORMAL_STATE_EXTRA_BUTTONS)        // Cambia el valor de las entradas FAN.
-    {
-        EstadoEntradas.FanState = On;
-        EstadoEntradas.SystemState = FanOnly;
-        //******************************************************
-        Task_setPri(((pthread_Obj*)salidas_thread)->task, 1);
-        Task_setPri(((pthread_Obj*)heartbeat_thread)->task, 1);
-        //******************************************************
-        if(ultimos_estados[0] == FALSE)                 //SI ULTIMO ESTADO FANSTATE NO ES ON
-            event = TRUE;                               //BANDERA OCURRIO EVENTO
-
-        ultimos_estados[0] = TRUE;                      //FANSTATE ON
-        ultimos_estados[1] = FALSE;                     //FANSTATE AUTO
-    }
-
-    else if((data[3] & GPIO_PIN_STATUS) != NORMAL_STATE_EXTRA_BUTTONS)   // Cambia el valor de las entradas SYSTEM.
-    {
-        EstadoEntradas.FanState = Auto;                //PON fanstate en AUTO
-        if(ultimos_estados[1] == FALSE)                //SI ULTIMO ESTADO FANSTATE NO ES AUTO
-            event = TRUE;                              //BANDERA OCURRIO EVENTO
-
-       ultimos_estados[0] = FALSE;                     //FANSTATE QUITAR ON
-       ultimos_estados[1] = TRUE;                      //FANSTATE ULTIMO ESTADO PONER AUTO
-
-        if((data[4] & GPIO_PIN_STATUS) != NORMAL_STATE_EXTRA_BUTTONS)   // Y as� sucesivamente para el resto de pines.
-        {
-            EstadoEntradas.SystemState = Cool;
-            //******************************************************
-            Task_setPri(((pthread_Obj*)salidas_thread)->task, 1);
-            Task_setPri(((pthread_Obj*)heartbeat_thread)->task, 1);
-            //******************************************************
-            if(ultimos_estados[2] == FALSE)
-                event = TRUE;
-            ultimos_estados[2] = TRUE;
-            ultimos_estados[3] = FALSE;
-            ultimos_estados[4] = FALSE;
-        }
-        else if((data[5] & GPIO_PIN_STATUS) != NORMAL_STATE_EXTRA_BUTTONS)
-        {
-            EstadoEntradas.SystemState = Off;
-            //******************************************************
-            print("Salida y HeatBeat apagados\n\r");
-            Task_setPri(((pthread_Obj*)salidas_thread)->task, -1);
-            Task_setPri(((pthread_Obj*)heartbeat_thread)->task, -1);
-            //******************************************************
-            if(ultimos_estados[3] == FALSE)
-                event = TRUE;
-            ultimos_estados[2] = FALSE;
-            ultimos_estados[3] = TRUE;
-            ultimos_estados[4] = FALSE;
-        }
-        else if((data[6] & GPIO_PIN_STATUS) != NORMAL_STATE_EXTRA_BUTTONS)
-        {
-            EstadoEntradas.SystemState = Heat;
-            //******************************************************
-            Task_setPri(((pthread_Obj*)salidas_thread)->task, 1);
-            Task_setPri(((pthread_Obj*)heartbeat_thread)->task, 1);
-            //******************************************************
-            if(ultimos_estados[4] == FALSE)
-                event = TRUE;
-            ultimos_estados[2] = FALSE;
-            ultimos_estados[3] = FALSE;
-            ultimos_estados[4] = TRUE;
-        }
-        else
-        {
-            EstadoEntradas.SystemState = Off;       //SI NO SE PRESIONO CUALQUIERA DELOS BOTONES PASADOS PON SystemState en OFF
-            //******************************************************
-            Task_setPri(((pthread_Obj*)salidas_thread)->task, -1);
-            Task_setPri(((pthread_Obj*)heartbeat_thread)->task, -1);
-            //******************************************************
-            ultimos_estados[2] = FALSE;
-            ultimos_estados[3] = FALSE;
-            ultimos_estados[4] = FALSE;
-        }
-    }
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_ActualizarSalidas
-* Returned Value   : None.
-* Comments         :
-*    Decide a partir de las entradas actualizadas las salidas principales,
-*    y en ciertos casos, en base a una cuesti�n de temperatura, la salida del 'fan'.
-*
-*END***********************************************************************************/
-void HVAC_ActualizarSalidas(void)
-{
-    // Cambia el valor de las salidas de acuerdo a entradas.
-
-    if(EstadoEntradas.FanState == On)                               // Para FAN on.
-    {
-        FAN_LED_State = 1;
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG1, &fan);
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &heat);
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &cool);
-    }
-
-    else if(EstadoEntradas.FanState == Auto)                        // Para FAN automatico.
-    {
-        switch(EstadoEntradas.SystemState)
-        {
-        case Off:   ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &fan);
-                    ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &heat);
-                    ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &cool);
-                    FAN_LED_State = 0;
-                    break;
-        case Heat:  HVAC_Heat();
-                    break;
-        case Cool:  HVAC_Cool();
-                    break;
-        }
-    }
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_Heat
-* Returned Value   : None.
-* Comments         :
-*    Decide a partir de la temperatura actual y la deseada, si se debe activar el fan.
-*    (La temperatura deseada debe ser mayor a la actual). El estado del fan debe estar
-*    en 'auto' y este modo debe estar activado para entrar a la funci�n.
-*
-*END***********************************************************************************/
-void HVAC_Heat(void)
-{
-    ioctl(output_port, GPIO_IOCTL_WRITE_LOG1, &heat);
-    ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &cool);
-
-    if(TemperaturaActual < SetPoint)                    // El fan se debe encender si se quiere una temp. m�s alta.
-    {
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG1, &fan);
-        FAN_LED_State = 1;
-    }
-    else
-    {
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &fan);
-        FAN_LED_State = 0;
-    }
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_Cool
-* Returned Value   : None.
-* Comments         :
-*    Decide a partir de la temperatura actual y la deseada, si se debe activar el fan.
-*    (La temperatura deseada debe ser menor a la actual). El estado del fan debe estar
-*    en 'auto' y este modo debe estar activado para entrar a la funci�n.
-*
-*END***********************************************************************************/
-void HVAC_Cool(void)
-{
-    ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &heat);
-    ioctl(output_port, GPIO_IOCTL_WRITE_LOG1, &cool);
-
-    if(TemperaturaActual > SetPoint)                        // El fan se debe encender si se quiere una temp. m�s baja.
-    {
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG1, &fan);
-        FAN_LED_State = 1;
-    }
-    else
-    {
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &fan);
-        FAN_LED_State = 0;
-    }
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_Heartbeat
-* Returned Value   : None.
-* Comments         :
-*    Funci�n que prende y apaga una salida para notificar que el sistema est� activo.
-*    El periodo en que se hace esto depende de una entrada del ADC en esta funci�n.
-*
-*END***********************************************************************************/
-void HVAC_Heartbeat(void)               // Funci�n de 'alive' del sistema.
-{
-   _mqx_int val;
-   boolean flag = 0;
-   static boolean bandera_inicial = 0;
-
-   if(bandera_inicial == 0)
-   {
-       // Entrando por primera vez, empieza a correr el canal de heartbeat.
-       ioctl (fd_ch_H, IOCTL_ADC_RUN_CHANNEL, NULL);
-       bandera_inicial = 1;
-   }
-
-   // Valor se guarda en val, flag nos dice si fue exitoso.
-   flag =  (fd_adc && fread_f(fd_ch_H, &val, sizeof(val))) ? 1 : 0;
-
-   if(flag != TRUE)
-   {
-       printf("Error al leer archivo. Cierre del programa\r\n");
-       exit(1);
-   }
-
-    delay = 15000 + (100 * val / 4);            // Lectura del ADC por medio de la funci�n.
-    //Nota: delay no puede ser mayor a 1,000,000 ya que luego se generan problemas en usleep.
-
-    if(toggle)
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG1, &hbeat);
-    else
-        ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, &hbeat);
-
-    toggle ^= 1;                             // Toggle.
-
-    usleep(delay);                           // Delay marcado por el heart_beat.
-    return;
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_PrintState
-* Returned Value   : None.
-* Comments         :
-*    Imprime via UART la situaci�n actual del sistema en t�rminos de temperaturas
-*    actual y deseada, estado del abanico, del sistema y estado de las entradas.
-*    Imprime cada cierto n�mero de iteraciones y justo despues de recibir un cambio
-*    en las entradas, produci�ndose un inicio en las iteraciones.
-*END***********************************************************************************/
-void HVAC_PrintState(void)
-{
-    static uint_32 delay = DELAY;
-    delay -= DELAY;
-
-    if(delay <= 0 || event == TRUE)
-    {
-        event = FALSE;
-        delay = SEC;
-
-        sprintf(state,"Fan: %s, System: %s, SetPoint: %0.2f\n\r",
-                    EstadoEntradas.FanState == On? "On":"Auto",
-                    SysSTR[EstadoEntradas.SystemState],
-                    SetPoint);
-        print(state);
-
-        sprintf(state,"Temperatura Actual: %0.2f�C %0.2f�F  Fan: %s\n\r\n\r",
-                    TemperaturaActual,
-                    ((TemperaturaActual*9.0/5.0) + 32),
-                    FAN_LED_State?"On":"Off");
-        print(state);
-    }
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_SetPointUp
-* Returned Value   : None.
-* Comments         :
-*    Sube el valor deseado (set point). Llamado por interrupci�n a causa del SW1.
-*
-*END***********************************************************************************/
-void HVAC_SetPointUp(void)
-{
-    SetPoint += 0.5;
-    event = TRUE;
-}
-
-/*FUNCTION******************************************************************************
-*
-* Function Name    : HVAC_SetPointDown
-* Returned Value   : None.
-* Comments         :
-*    Baja el valor deseado (set point). Llamado por interrupci�n a causa del SW2.
-*
-*END***********************************************************************************/
-void HVAC_SetPointDown(void)
-{
-    SetPoint -= 0.5;
-    event = TRUE;
-}
-
+ // FileName:        HVAC_IO.c
+ // Dependencies:    HVAC.h
+ // Processor:       MSP432
+ // Board:           MSP432P401R
+ // Program version: CCS V8.3 TI
+ // Company:         Texas Instruments
+ // Description:     Funciones de control de HW a trav�s de estados y objetos.
+ // Authors:         Jos� Luis Chac�n M. y Jes�s Alejandro Navarro Acosta.
+ // Updated:         11/2018
+
+#include "HVAC.h"
+
+/* Definici�n de botones. */
+#define TEMP_PLUS   (BSP_BUTTON1 & ~(GPIO_PIN_IRQ | GPIO_IRQ_EDGE_H_TO_L))  /* Botones de suma y resta al valor deseado, */
+#define TEMP_MINUS  (BSP_BUTTON2 & ~(GPIO_PIN_IRQ | GPIO_IRQ_EDGE_H_TO_L))  /* con antirrebote en lugar de interrupcion. */
+
+#define FAN_ON      BSP_BUTTON3     /* Botones para identificaci�n del estado del sistema. */
+#define FAN_AUTO    BSP_BUTTON4
+#define SYSTEM_COOL BSP_BUTTON5
+#define SYSTEM_OFF  BSP_BUTTON6
+#define SYSTEM_HEAT BSP_BUTTON7
+
+/* Definici�n de leds. */
+#define FAN_LED     BSP_LED1        /* Leds para denotar el estado de las salidas. */
+#define HEAT_LED    BSP_LED2
+#define HBeat_LED   BSP_LED3
+#define COOL_LED    BSP_LED4
+
+/* Variables sobre las cuales se maneja el sistema. */
+
+float TemperaturaActual = 20;  // Temperatura.
+float SetPoint = 25.0;         // V. Deseado.
+
+_mqx_int delay;                // Delay aplicado al heartbeat.
+
+bool FAN_LED_State = 0;                                     // Estado led_FAN.
+const char* SysSTR[] = {"Cool","Off","Heat","Only Fan"};    // Control de los estados.
+
+/* Archivos sobre los cuales se escribe toda la informaci�n */
+FILE _PTR_ input_port = NULL, _PTR_ output_port = NULL;                  // Entradas y salidas.
+FILE _PTR_ fd_adc = NULL, _PTR_ fd_ch_T = NULL, _PTR_ fd_ch_H = NULL;    // ADC: ch_T -> Temperature, ch_H -> Pot.
+FILE _PTR_ fd_fan = NULL;                                                // Velocidad del abanico (PWM).
+FILE _PTR_ fd_uart = NULL;                                               // Comunicaci�n serial as�ncrona.
+
+// Estructuras iniciales.
+
+static const ADC_CONVERSION_POINT pot_table[] =                                  // Pot -> periodo del heartbeat en uS.
+{
+    {     0,  15000 },                                                           // Pot al minimo.
+    { 16383, 424575 }                                                            // Pot al maximo (15000 + 100 * 16383 / 4).
+};
+
+static const ADC_CONVERSION_STRUCT pot_conversion =
+{
+    ADC_CONVERSION_TABLE,                                                        // Tabla de puntos.
+    pot_table,
+    sizeof(pot_table) / sizeof(pot_table[0]),
+    0, 0, 0, 0, 0                                                                // Solo aplican a termistores y sensor interno.
+};
+
+const PWM_INIT_STRUCT fan_pwm_init =
+{
+    PWM_TA2,                                                                    // TA2.1 -> P5.6.
+    PWM_CCR1,
+    25000,                                                                      // 25 kHz, fuera del rango audible.
+    0                                                                           // Abanico detenido.
+};
+
+const ADC_INIT_STRUCT adc_init =
+{
+    ADC_RESOLUTION_DEFAULT,                                                     // Resoluci�n.
+    ADC_CLKDiv8                                                                 // Divisi�n de reloj.
+};
+
+const ADC_INIT_CHANNEL_STRUCT adc_ch_param =
+{
+    TEMPERATURE_ANALOG_PIN,                                                      // Fuente de lectura, 'ANx'.
+    ADC_CHANNEL_MEASURE_LOOP | ADC_CHANNEL_START_NOW | ADC_INTERNAL_TEMPERATURE
+                             | ADC_CHANNEL_ADAPTIVE,                             // Banderas de inicializaci�n (temperatura)
+    50000,                                                                       // Periodo en uS, base 1000.
+    ADC_TRIGGER_1,                                                               // Trigger l�gico que puede activar este canal.
+    800000,                                                                      // Techo del periodo adaptativo en uS.
+    4,                                                                           // Tolerancia en cuentas (aprox. 0.3 C).
+    NULL,                                                                        // Sin tabla; se lee con IOCTL_ADC_READ_TEMPERATURE.
+    0,                                                                           // Resolucion del modulo (14 bits).
+    0                                                                            // Muestreo del modulo; el sensor pide al menos 5 uS.
+};
+
+const ADC_INIT_CHANNEL_STRUCT adc_ch_param2 =
+{
+    AN1,                                                                         // Fuente de lectura, 'ANx'.
+    ADC_CHANNEL_MEASURE_LOOP | ADC_CHANNEL_ADAPTIVE,                             // Banderas de inicializaci�n (pot).
+    20000,                                                                       // Periodo en uS, base 1000.
+    ADC_TRIGGER_2,                                                               // Trigger l�gico que puede activar este canal.
+    400000,                                                                      // Techo del periodo adaptativo en uS.
+    64,                                                                          // Tolerancia en cuentas (aprox. 1.6 ms de heartbeat).
+    &pot_conversion,                                                             // Conversion directa a uS de heartbeat.
+    8,                                                                           // 8 bits bastan para el periodo del heartbeat.
+    32                                                                           // Ciclos de muestreo (el pot es de baja impedancia).
+};
+
+// Posicion de cada entrada en la mascara de GPIO_IOCTL_READ_MASK (orden de input_set).
+#define IN_TEMP_PLUS        (1 << 0)
+#define IN_TEMP_MINUS       (1 << 1)
+#define IN_FAN_SHIFT        2                                                   // FAN_ON, FAN_AUTO.
+#define IN_SYSTEM_SHIFT     4                                                   // SYSTEM_COOL, SYSTEM_OFF, SYSTEM_HEAT.
+#define IN_EXTRA_MASK       0x7C                                                // Botones externos (bits 2 a 6).
+#define IN_EXTRA_NORMAL     ((NORMAL_STATE_EXTRA_BUTTONS == VCC) ? IN_EXTRA_MASK : 0)
+
+#define SIN_CAMBIO          0xFF
+
+// Decodificacion de los botones activos: FAN_ON tiene prioridad sobre FAN_AUTO,
+// y COOL sobre OFF sobre HEAT. Ningun boton de sistema equivale a Off.
+static const uint8_t fan_decode[4]    = { SIN_CAMBIO, On, Auto, On };
+static const uint8_t system_decode[8] = { Off, Cool, Off, Cool, Heat, Cool, Off, Cool };
+
+// Antirrebote de todos los botones; TEMP_PLUS y TEMP_MINUS se activan en bajo.
+static const GPIO_DEBOUNCE_INIT_STRUCT debounce_init =
+{
+    IN_TEMP_PLUS | IN_TEMP_MINUS | IN_EXTRA_MASK,                               // Pines.
+    IN_TEMP_PLUS | IN_TEMP_MINUS | IN_EXTRA_NORMAL,                             // Activos en bajo.
+    20,                                                                         // mS estables para aceptar un cambio.
+    800                                                                         // mS para 'long press'.
+};
+
+// Todas las entradas por interrupcion: el hilo de entradas duerme hasta el siguiente evento.
+#define INPUT_EVENTS        4                                                   // Registros por lectura.
+
+static const GPIO_QUEUE_INIT_STRUCT queue_init =
+{
+    IN_TEMP_PLUS | IN_TEMP_MINUS | IN_EXTRA_MASK,                               // Pines.
+    16,                                                                         // Registros en la cola.
+    0                                                                           // Espera sin limite.
+};
+
+static const uint_32 fan[] =                                                    // Formato de los leds, uno por uno.
+{
+     FAN_LED,
+     GPIO_LIST_END
+};
+
+static const uint_32 heat[] =                                                   // Formato de los leds, uno por uno.
+{
+     HEAT_LED,
+     GPIO_LIST_END
+};
+
+const uint_32 hbeat[] =                                                         // Formato de los leds, uno por uno.
+{
+     HBeat_LED,
+     GPIO_LIST_END
+};
+
+static const uint_32 cool[] =                                                   // Formato de los leds, uno por uno.
+{
+     COOL_LED,
+     GPIO_LIST_END
+};
+
+// Conjuntos compilados de las listas anteriores (se escriben sin pasar por el archivo).
+static GPIO_PIN_SET fan_set  = { fan  };
+static GPIO_PIN_SET heat_set = { heat };
+static GPIO_PIN_SET cool_set = { cool };
+
+static GPIO_PIN_HANDLE hbeat_pin = { HBeat_LED };                               // LED de heartbeat por bit-band.
+
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_InicialiceIO
+* Returned Value   : boolean; inicializaci�n correcta.
+* Comments         :
+*    Abre los archivos e inicializa las configuraciones deseadas de entrada y salida GPIO.
+*
+*END***********************************************************************************/
+boolean HVAC_InicialiceIO(void)
+{
+    // Estructuras iniciales de entradas y salidas.
+    const uint_32 output_set[] =
+    {
+         FAN_LED   | GPIO_PIN_STATUS_0,
+         HEAT_LED  | GPIO_PIN_STATUS_0,
+         HBeat_LED | GPIO_PIN_STATUS_0,
+         COOL_LED  | GPIO_PIN_STATUS_0,
+         GPIO_LIST_END
+    };
+
+    const uint_32 input_set[] =
+    {
+        TEMP_PLUS,
+        TEMP_MINUS,
+        FAN_ON,
+        FAN_AUTO,
+        SYSTEM_COOL,
+        SYSTEM_OFF,
+        SYSTEM_HEAT,
+
+        GPIO_LIST_END
+    };
+
+    // Iniciando GPIO.
+    ////////////////////////////////////////////////////////////////////
+
+    output_port =  fopen_f("gpio:write", (char_ptr) &output_set);
+    input_port =   fopen_f("gpio:read", (char_ptr) &input_set);
+    fd_fan =       fopen_f("pwm:", (char_ptr) &fan_pwm_init);
+
+    if (output_port)
+    {
+        ioctl(output_port, GPIO_IOCTL_WRITE_LOG0, NULL);                    // Inicialmente salidas apagadas.
+
+        if ((ioctl(output_port, GPIO_IOCTL_COMPILE_SET, &fan_set)  != IO_OK) ||
+            (ioctl(output_port, GPIO_IOCTL_COMPILE_SET, &heat_set) != IO_OK) ||
+            (ioctl(output_port, GPIO_IOCTL_COMPILE_SET, &cool_set) != IO_OK) ||
+            (ioctl(output_port, GPIO_IOCTL_PIN_HANDLE,  &hbeat_pin) != IO_OK))
+            return FALSE;
+    }
+
+    if (input_port && ((ioctl(input_port, GPIO_IOCTL_DEBOUNCE, (pointer) &debounce_init) != IO_OK) ||
+                       (ioctl(input_port, GPIO_IOCTL_EVENT_QUEUE, (pointer) &queue_init) != IO_OK)))
+        return FALSE;                                                       // Antirrebote y cola de eventos.
+
+    return (input_port != NULL) && (output_port != NULL) && (fd_fan != NULL);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_InicialiceADC
+* Returned Value   : boolean; inicializaci�n correcta.
+* Comments         :
+*    Abre los archivos e inicializa las configuraciones deseadas para
+*    el m�dulo general ADC y dos de sus canales; uno para la temperatura, otro para
+*    el heartbeat.
+*
+*END***********************************************************************************/
+
+boolean HVAC_InicialiceADC (void)
+{
+    // Iniciando ADC y canales.
+    ////////////////////////////////////////////////////////////////////
+
+    fd_adc   = fopen_f("adc:",  (const char*) &adc_init);               // M�dulo.
+    fd_ch_T =  fopen_f("adc:1", (const char*) &adc_ch_param);           // Canal uno, arranca al instante.
+    fd_ch_H =  fopen_f("adc:2", (const char*) &adc_ch_param2);          // Canal dos.
+
+    return (fd_adc != NULL) && (fd_ch_T != NULL) && (fd_ch_H != NULL);  // Valida que se crearon los archivos.
+}
+
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_InicialiceUART
+* Returned Value   : boolean; inicializaci�n correcta.
+* Comments         :
+*    Abre los archivos e inicializa las configuraciones deseadas para
+*    configurar el modulo UART (comunicaci�n as�ncrona).
+*
+*END***********************************************************************************/
+boolean HVAC_InicialiceUART (void)
+{
+    // Estructura inicial de comunicaci�n serie.
+    const UART_INIT_STRUCT uart_init =
+    {
+        /* Selected port */        1,
+        /* Selected pins */        {1,2},
+        /* Clk source */           SM_CLK,
+        /* Baud rate */            BR_115200,
+
+        /* Usa paridad */          NO_PARITY,
+        /* Bits protocolo  */      EIGHT_BITS,
+        /* Sobremuestreo */        OVERSAMPLE,
+        /* Bits de stop */         ONE_STOP_BIT,
+        /* Direccion TX */         LSB_FIRST,
+
+        /* Int char's \b */        NO_INTERRUPTION,
+        /* Int char's err�neos */  NO_INTERRUPTION
+    };
+
+    // Inicializaci�n de archivo.
+    fd_uart = fopen_f("uart:", (const char*) &uart_init);
+
+    return (fd_uart != NULL); // Valida que se crearon los archivos.
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_ActualizarEntradas
+* Returned Value   : None.
+* Comments         :
+*    Espera (bloqueado) el siguiente evento filtrado de las entradas y actualiza
+*    los indicadores sobre los cuales surgiran las salidas.
+*
+*END***********************************************************************************/
+void HVAC_ActualizarEntradas(void)
+{
+    GPIO_EVENT eventos[INPUT_EVENTS];
+    GPIO_DEBOUNCE_EVENTS entradas;
+    uint_32 activas, i;
+    uint8_t fan_sel, sys_sel;
+
+    if(!fread_f(input_port, (pointer) eventos, sizeof(eventos)))                // Duerme hasta el siguiente evento.
+        return;
+
+    for(i = 0; (i < INPUT_EVENTS) && (eventos[i].edge != GPIO_EVENT_NONE); i++)
+    {
+        if(eventos[i].edge != GPIO_EVENT_PRESS)                                 // Un paso por cada presion limpia.
+            continue;
+        if((1 << eventos[i].pin) == IN_TEMP_PLUS)
+            HVAC_SetPointUp();
+        else if((1 << eventos[i].pin) == IN_TEMP_MINUS)
+            HVAC_SetPointDown();
+    }
+
+    ioctl(input_port, GPIO_IOCTL_GET_EVENTS, &entradas);                        // Estado ya filtrado.
+    activas = entradas.state;                                                   // 1 = boton activo.
+
+    fan_sel = fan_decode[(activas >> IN_FAN_SHIFT) & 0x03];
+    if(fan_sel == SIN_CAMBIO)                                                   // Sin FAN_ON ni FAN_AUTO se conserva todo.
+        return;
+
+    sys_sel = (fan_sel == On) ? FanOnly : system_decode[(activas >> IN_SYSTEM_SHIFT) & 0x07];
+
+    // Contra el modo vigente, que tambien cambian el comando MODE y Modbus.
+    if((fan_sel == EstadoEntradas.FanState) && (sys_sel == EstadoEntradas.SystemState))
+        return;
+
+    HVAC_SetMode(fan_sel, sys_sel);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_SetMode
+* Returned Value   : None.
+* Comments         :
+*    Fija el estado del abanico y del sistema (desde los botones o por comando)
+*    y detiene o reanuda los hilos de salidas y heartbeat segun el sistema.
+*
+*END***********************************************************************************/
+void HVAC_SetMode(uint8_t fan_sel, uint8_t sys_sel)
+{
+    EstadoEntradas.FanState = fan_sel;
+    EstadoEntradas.SystemState = sys_sel;
+
+    if(sys_sel == Off)
+    {
+        HVAC_LOG("Salida y HeatBeat apagados");
+        Task_setPri(((pthread_Obj*)salidas_thread)->task, -1);
+        Task_setPri(((pthread_Obj*)heartbeat_thread)->task, -1);
+    }
+    else
+    {
+        Task_setPri(((pthread_Obj*)salidas_thread)->task, 1);
+        Task_setPri(((pthread_Obj*)heartbeat_thread)->task, 1);
+    }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_ActualizarSalidas
+* Returned Value   : None.
+* Comments         :
+*    Decide a partir de las entradas actualizadas las salidas principales,
+*    y en ciertos casos, en base a una cuesti�n de temperatura, la salida del 'fan'.
+*
+*END***********************************************************************************/
+void HVAC_ActualizarSalidas(void)
+{
+    ioctl(fd_ch_T, IOCTL_ADC_READ_TEMPERATURE, (pointer) &TemperaturaActual);   // Actualiza valor de temperatura.
+
+    // Cambia el valor de las salidas de acuerdo a entradas.
+
+    if(EstadoEntradas.FanState == On)                               // Para FAN on.
+    {
+        HVAC_Fan(PWM_DUTY_FULL);
+        gpio_set_log0(&heat_set);
+        gpio_set_log0(&cool_set);
+    }
+
+    else if(EstadoEntradas.FanState == Auto)                        // Para FAN automatico.
+    {
+        switch(EstadoEntradas.SystemState)
+        {
+        case Off:   HVAC_Fan(0);
+                    gpio_set_log0(&heat_set);
+                    gpio_set_log0(&cool_set);
+                    break;
+        case Heat:  HVAC_Heat();
+                    break;
+        case Cool:  HVAC_Cool();
+                    break;
+        }
+    }
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Heat
+* Returned Value   : None.
+* Comments         :
+*    Decide a partir de la temperatura actual y la deseada la velocidad del fan.
+*    (La temperatura deseada debe ser mayor a la actual). El estado del fan debe estar
+*    en 'auto' y este modo debe estar activado para entrar a la funci�n.
+*
+*END***********************************************************************************/
+void HVAC_Heat(void)
+{
+    float diferencia = SetPoint - TemperaturaActual;
+
+    gpio_set_log1(&heat_set);
+    gpio_set_log0(&cool_set);
+
+    if(TemperaturaActual < SetPoint)                    // El fan se debe encender si se quiere una temp. m�s alta.
+        HVAC_Fan(diferencia >= (float) PWM_DUTY_FULL / FAN_PWM_GAIN ?      // Velocidad proporcional a la diferencia.
+                 PWM_DUTY_FULL : (uint_32) (diferencia * FAN_PWM_GAIN));
+    else
+        HVAC_Fan(0);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Cool
+* Returned Value   : None.
+* Comments         :
+*    Decide a partir de la temperatura actual y la deseada la velocidad del fan.
+*    (La temperatura deseada debe ser menor a la actual). El estado del fan debe estar
+*    en 'auto' y este modo debe estar activado para entrar a la funci�n.
+*
+*END***********************************************************************************/
+void HVAC_Cool(void)
+{
+    float diferencia = TemperaturaActual - SetPoint;
+
+    gpio_set_log0(&heat_set);
+    gpio_set_log1(&cool_set);
+
+    if(TemperaturaActual > SetPoint)                        // El fan se debe encender si se quiere una temp. m�s baja.
+        HVAC_Fan(diferencia >= (float) PWM_DUTY_FULL / FAN_PWM_GAIN ?      // Velocidad proporcional a la diferencia.
+                 PWM_DUTY_FULL : (uint_32) (diferencia * FAN_PWM_GAIN));
+    else
+        HVAC_Fan(0);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Fan
+* Returned Value   : None.
+* Comments         :
+*    Fija la velocidad del abanico (por mil) en el PWM y refleja en FAN_LED si
+*    esta girando. Solo escribe cuando la velocidad cambia.
+*
+*END***********************************************************************************/
+void HVAC_Fan(uint_32 duty)
+{
+    static uint_32 ultimo = PWM_DUTY_FULL + 1;
+
+    if(duty == ultimo)
+        return;
+    ultimo = duty;
+
+    ioctl(fd_fan, IOCTL_PWM_SET_DUTY, &duty);
+
+    FAN_LED_State = (duty > 0);
+    if(FAN_LED_State)
+        gpio_set_log1(&fan_set);
+    else
+        gpio_set_log0(&fan_set);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Heartbeat
+* Returned Value   : None.
+* Comments         :
+*    Funci�n que prende y apaga una salida para notificar que el sistema est� activo.
+*    El periodo en que se hace esto depende de una entrada del ADC en esta funci�n.
+*
+*END***********************************************************************************/
+void HVAC_Heartbeat(void)               // Funci�n de 'alive' del sistema.
+{
+   _mqx_int val;
+   boolean flag = 0;
+   static boolean bandera_inicial = 0;
+
+   if(bandera_inicial == 0)
+   {
+       // Entrando por primera vez, empieza a correr el canal de heartbeat.
+       ioctl (fd_ch_H, IOCTL_ADC_RUN_CHANNEL, NULL);
+       bandera_inicial = 1;
+   }
+
+   // Valor se guarda en val, flag nos dice si fue exitoso.
+   flag =  (fd_adc && ioctl(fd_ch_H, IOCTL_ADC_READ_CALIBRATED, &val) == IO_OK) ? 1 : 0;
+
+   if(flag != TRUE)
+   {
+       HVAC_LOG("Error al leer archivo. Cierre del programa");
+       HVAC_LogFlush();
+       exit(1);
+   }
+
+    delay = val;                                // Lectura del ADC ya convertida a uS por la tabla del canal.
+    //Nota: delay no puede ser mayor a 1,000,000 ya que luego se generan problemas en usleep.
+
+    gpio_pin_toggle(&hbeat_pin);             // Toggle atomico del LED (bit-band).
+
+    usleep(delay);                           // Delay marcado por el heart_beat.
+    return;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_PrintState
+* Returned Value   : None.
+* Comments         :
+*    Reporta el estado (texto o trama, segun FORMAT) solo cuando cambia algo
+*    significativo: temperatura en REPORT_TEMP_DELTA o mas, velocidad del
+*    abanico en REPORT_DUTY_DELTA o mas, o cualquier cambio de set point, modo
+*    o salidas. Nunca mas de uno cada REPORT_MIN_INTERVAL_MS (los cambios
+*    dentro del intervalo salen juntos al terminarlo) y, sin cambios, uno cada
+*    REPORT_HEARTBEAT_MS para saber que el sistema sigue vivo.
+*END***********************************************************************************/
+void HVAC_PrintState(void)
+{
+    static int32_t  temperatura = 0, deseada = 0;                               // Lo ultimo que se reporto.
+    static uint32_t salidas = 0, duty = 0, ultimo = 0;
+    static uint8_t  fan = 0xFF, sistema = 0xFF;                                 // Fuerza el primer reporte.
+    uint32_t ms, transcurrido, salidas_ahora = 0, duty_ahora = 0;
+    int32_t  temperatura_ahora, deseada_ahora;
+
+    ms = timer_timebase_us() / 1000;
+    transcurrido = ms - ultimo;
+    if(transcurrido < REPORT_MIN_INTERVAL_MS)
+        return;
+
+    temperatura_ahora = HVAC_Centesimas(TemperaturaActual);
+    deseada_ahora = HVAC_Centesimas(SetPoint);
+    ioctl(output_port, GPIO_IOCTL_READ_MASK, &salidas_ahora);
+    ioctl(fd_fan, IOCTL_PWM_GET_DUTY, &duty_ahora);
+    salidas_ahora &= REPORT_OUTPUTS_MASK;
+
+    if((transcurrido < REPORT_HEARTBEAT_MS) &&
+       (abs(temperatura_ahora - temperatura) < REPORT_TEMP_DELTA) &&
+       (abs((int32_t) duty_ahora - (int32_t) duty) < REPORT_DUTY_DELTA) &&
+       (deseada_ahora == deseada) && (salidas_ahora == salidas) &&
+       (EstadoEntradas.FanState == fan) && (EstadoEntradas.SystemState == sistema))
+        return;                                                                 // Nada que valga la pena enviar.
+
+    temperatura = temperatura_ahora;
+    deseada = deseada_ahora;
+    salidas = salidas_ahora;
+    duty = duty_ahora;
+    fan = EstadoEntradas.FanState;
+    sistema = EstadoEntradas.SystemState;
+    ultimo = ms;
+
+    if(formato_reporte == REPORT_BINARY)
+        HVAC_EnviaTelemetria();
+    else
+        HVAC_EnviaEstado();
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_EnviaEstado
+* Returned Value   : None.
+* Comments         :
+*    Imprime el estado del sistema directo en la cola del UART, con enteros en
+*    centesimas de grado: no usa sprintf ni el printf de punto flotante, y casi
+*    no ocupa pila del hilo de salidas. La llaman el hilo de salidas y el
+*    interprete de comandos.
+*
+*END***********************************************************************************/
+void HVAC_EnviaEstado(void)
+{
+    int32_t temperatura = HVAC_Centesimas(TemperaturaActual);
+
+    print_begin();
+    print_str("Fan: ");
+    print_str(EstadoEntradas.FanState == On? "On":"Auto");
+    print_str(", System: ");
+    print_str(SysSTR[EstadoEntradas.SystemState]);
+    print_str(", SetPoint: ");
+    print_fixed(HVAC_Centesimas(SetPoint), 2);
+    print_str("\n\rTemperatura Actual: ");
+    print_fixed(temperatura, 2);
+    print_str("�C ");
+    print_fixed(temperatura * 9 / 5 + 3200, 2);                 // Centesimas de grado F.
+    print_str("�F  Fan: ");
+    print_str(FAN_LED_State?"On":"Off");
+    print_str("\n\r\n\r");
+    print_end();
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Centesimas
+* Returned Value   : Grados en centesimas, redondeados.
+* Comments         :
+*    Unica conversion de punto flotante de los reportes; el resto es entero.
+*
+*END***********************************************************************************/
+int32_t HVAC_Centesimas(float grados)
+{
+    return (int32_t) (grados * 100.0f + (grados < 0 ? -0.5f : 0.5f));
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_SetPointUp
+* Returned Value   : None.
+* Comments         :
+*    Sube el valor deseado (set point). Llamado con cada presion (ya filtrada) de SW1.
+*
+*END***********************************************************************************/
+void HVAC_SetPointUp(void)
+{
+    SetPoint += 0.5;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_SetPointDown
+* Returned Value   : None.
+* Comments         :
+*    Baja el valor deseado (set point). Llamado con cada presion (ya filtrada) de SW2.
+*
+*END***********************************************************************************/
+void HVAC_SetPointDown(void)
+{
+    SetPoint -= 0.5;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Comandos
+* Returned Value   : None.
+* Comments         :
+*    Interprete de comandos por UART. Duerme hasta recibir una linea completa y
+*    la ejecuta; responde OK o ERR. Comandos (sin distinguir mayusculas):
+*      SP <grados>                 Fija el valor deseado.
+*      MODE COOL|HEAT|OFF|FAN      Fija el modo (hasta que cambien los botones).
+*      STATE?                      Imprime el estado del sistema.
+*      STATS                       Imprime contadores de los drivers.
+*      FORMAT TEXT|BIN             Reporte periodico en texto o en tramas binarias.
+*
+*END***********************************************************************************/
+void HVAC_Comandos(void)
+{
+    char linea[MAX_CMD_SIZE];
+    char *p;
+    float valor;
+
+    if(!fread_f(fd_uart, (pointer) linea, sizeof(linea)))                       // Duerme hasta recibir una linea.
+        return;
+
+    for(p = linea; *p != '\0'; p++)
+        *p = toupper((unsigned char) *p);
+
+    if(!strncmp(linea, "SP ", 3))
+    {
+        valor = strtof(linea + 3, &p);
+        while(*p == ' ')                                                        // Solo se aceptan espacios despues.
+            p++;
+        if((p == linea + 3) || (*p != '\0') || (valor < (float) SETPOINT_MIN) || (valor > (float) SETPOINT_MAX))
+        {
+            print("ERR\n\r");
+            return;
+        }
+        SetPoint = valor;
+    }
+    else if(!strcmp(linea, "MODE COOL"))
+        HVAC_SetMode(Auto, Cool);
+    else if(!strcmp(linea, "MODE HEAT"))
+        HVAC_SetMode(Auto, Heat);
+    else if(!strcmp(linea, "MODE OFF"))
+        HVAC_SetMode(Auto, Off);
+    else if(!strcmp(linea, "MODE FAN"))
+        HVAC_SetMode(On, FanOnly);
+    else if(!strcmp(linea, "STATE?"))
+    {
+        HVAC_EnviaEstado();
+        return;
+    }
+    else if(!strcmp(linea, "FORMAT TEXT"))
+        formato_reporte = REPORT_TEXT;
+    else if(!strcmp(linea, "FORMAT BIN"))
+        formato_reporte = REPORT_BINARY;
+    else if(!strcmp(linea, "STATS"))
+    {
+        HVAC_EnviaEstadisticas();
+        return;
+    }
+    else
+    {
+        print("ERR\n\r");
+        return;
+    }
+
+    print("OK\n\r");
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_EnviaEstadisticas
+* Returned Value   : None.
+* Comments         :
+*    Imprime los contadores de los drivers: colas del UART, eventos perdidos de las
+*    entradas, cambios de cada salida, velocidad actual del abanico, tramas Modbus e
+*    interrupciones del timer32_2 (promedio por segundo desde el arranque).
+*
+*END***********************************************************************************/
+void HVAC_EnviaEstadisticas(void)
+{
+    char mensaje[MAX_MSG_SIZE];
+    UART_TX_STATUS tx;
+    UART_RX_STATUS rx;
+    GPIO_QUEUE_STATUS cola;
+    GPIO_PIN_CHANGES cambios[3] = { { FAN_LED }, { HEAT_LED }, { COOL_LED } };
+    uint_32 duty = 0, i;
+    uint64_t segundos = timer_timebase_us() / SEC;
+
+    ioctl(fd_uart, IO_IOCTL_SERIAL_TX_STATUS, &tx);
+    ioctl(fd_uart, IO_IOCTL_SERIAL_RX_STATUS, &rx);
+    ioctl(input_port, GPIO_IOCTL_QUEUE_STATUS, &cola);
+    ioctl(fd_fan, IOCTL_PWM_GET_DUTY, &duty);
+    for(i = 0; i < 3; i++)
+        ioctl(output_port, GPIO_IOCTL_PIN_CHANGES, &cambios[i]);
+
+    sprintf(mensaje, "UART tx: %u pend, %u perd; rx: %u perd\n\r",
+            (unsigned) tx.pending, (unsigned) tx.dropped, (unsigned) rx.dropped);
+    print(mensaje);
+
+    sprintf(mensaje, "Entradas: %u pend, %u perd\n\r",
+            (unsigned) cola.pending, (unsigned) cola.lost);
+    print(mensaje);
+
+    sprintf(mensaje, "Cambios fan/heat/cool: %u/%u/%u  Fan: %u/1000\n\r",
+            (unsigned) cambios[0].changes, (unsigned) cambios[1].changes,
+            (unsigned) cambios[2].changes, (unsigned) duty);
+    print(mensaje);
+
+    sprintf(mensaje, "Modbus: %u tramas, %u errores, %u excepciones\n\r",
+            (unsigned) modbus_esclavo.requests, (unsigned) (modbus_esclavo.errors + modbus_errores_trama),
+            (unsigned) modbus_esclavo.exceptions);
+    print(mensaje);
+
+    sprintf(mensaje, "Timer32_2: %u int, %u int/s\n\r",
+            (unsigned) timer_interrupts, (unsigned) (segundos ? timer_interrupts / segundos : 0));
+    print(mensaje);
+}
@@ -0,0 +1,272 @@
+ // FileName:        HVAC_Modbus.c
+ // Dependencies:    HVAC.h
+ // Processor:       MSP432
+ // Board:           MSP432P401R
+ // Program version: CCS V8.3 TI
+ // Company:         Texas Instruments
+ // Description:     Esclavo Modbus RTU del HVAC: mapa de registros, recepcion por interrupcion y tiempos de trama.
+ // Authors:         MarcoCaldM, sobre los drivers de Jose Luis Chacon M. y Jesus Alejandro Navarro Acosta.
+ // Updated:         10/2026
+
+#include "HVAC.h"
+
+/*
+ *  Registros de entrada (funcion 4, solo lectura):
+ *
+ *    0     temperatura     Centesimas de grado C, con signo.
+ *    1     set point       Centesimas de grado C, con signo.
+ *    2     abanico         enum FAN.
+ *    3     sistema         enum SYSTEM.
+ *    4     salidas         Bit 0 fan, 1 heat, 2 heartbeat, 3 cool (orden de output_set).
+ *    5     velocidad       Por mil del PWM del abanico.
+ *
+ *  Registros holding (funciones 3, 6 y 16):
+ *
+ *    0     set point       Centesimas de grado C; fuera de SETPOINT_MIN..SETPOINT_MAX
+ *                          responde la excepcion 3.
+ *    1     modo            enum SYSTEM; FanOnly enciende el abanico, los demas lo
+ *                          dejan en Auto (como MODE del interprete de comandos).
+ *
+ *  Una trama termina con 3.5 caracteres de silencio, medidos con el Timer_A
+ *  apartado desde el ultimo caracter recibido; un hueco de mas de 1.5
+ *  caracteres dentro de la trama (o un error de paridad) la invalida.
+ */
+
+#define MB_IN_TEMP          0
+#define MB_IN_SETPOINT      1
+#define MB_IN_FAN           2
+#define MB_IN_SYSTEM        3
+#define MB_IN_OUTPUTS       4
+#define MB_IN_DUTY          5
+#define MB_INPUT_COUNT      6
+
+#define MB_HOLD_SETPOINT    0
+#define MB_HOLD_MODE        1
+#define MB_HOLDING_COUNT    2
+
+#define MB_SETPOINT_MIN     ((int16_t) (SETPOINT_MIN * 100))    // Centesimas; se calculan al compilar.
+#define MB_SETPOINT_MAX     ((int16_t) (SETPOINT_MAX * 100))
+
+#define MB_CHAR_BITS        11                  // Inicio, 8 datos, paridad y stop.
+#define MB_TIMER_DIV        64                  // ID /8 e IDEX /8: 750 kHz con SMCLK de 48 MHz.
+#define MB_TIMER_CTL        (TIMER_A_CTL_SSEL__SMCLK | TIMER_A_CTL_ID__8)
+#define MB_TIMER            ((Timer_A_Type _PTR_) ((uint32_t) TIMER_A0 + 0x400 * BSP_MODBUS_TIMER))
+#define MB_TIMER_IRQ        (INT_TA0_0 + 2 * BSP_MODBUS_TIMER)  // Interrupcion del CCR0.
+
+extern float TemperaturaActual, SetPoint;
+extern FILE _PTR_ output_port, _PTR_ fd_fan;
+
+FILE _PTR_ fd_modbus = NULL;
+
+static uint16_t HVAC_ModbusLeeEntrada(uint16_t reg);
+static uint16_t HVAC_ModbusLeeHolding(uint16_t reg);
+static uint8_t  HVAC_ModbusEscribe(uint16_t reg, uint16_t valor);
+
+MODBUS_SLAVE modbus_esclavo =
+{
+    MODBUS_ADDRESS,
+    MB_HOLDING_COUNT,
+    MB_INPUT_COUNT,
+    HVAC_ModbusLeeHolding,
+    HVAC_ModbusLeeEntrada,
+    HVAC_ModbusEscribe,
+    0, 0, 0
+};
+
+/* Trama en recepcion. Las ISR la llenan mientras 'trama_lista' es falso; despues
+ * es del hilo hasta que la procesa. */
+static uint8_t           trama[MODBUS_MAX_FRAME];
+static volatile uint32_t recibidos = 0;
+static volatile boolean  trama_mala = FALSE;
+static volatile boolean  trama_lista = FALSE;
+static sem_t             trama_sem;
+
+static uint16_t          mb_t15;                // Cuentas entre fines de caracter que ya son hueco de 1.5.
+
+/* Tramas que la ISR descarta por hueco, paridad o largo. Solo la ISR la escribe;
+ * 'modbus_esclavo.errors' (CRC) solo lo escribe el hilo en modbus_process. */
+volatile uint32_t modbus_errores_trama = 0;
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_ModbusRx
+* Returned Value   : None.
+* Comments         :
+*    Funcion de recepcion del UART de Modbus (se llama desde su ISR). Guarda
+*    el caracter y reinicia la cuenta de silencio del Timer_A. Mientras el
+*    hilo procesa una trama, lo que llegue se descarta: el maestro espera la
+*    respuesta antes de volver a preguntar.
+*
+*END***********************************************************************************/
+static void HVAC_ModbusRx(void)
+{
+    EUSCI_A_Type _PTR_ uart = UART_MODULE[BSP_MODBUS_PORT];
+    boolean error = (uart -> STATW & EUSCI_A_STATW_RXERR) != 0;
+    uint8_t c = uart -> RXBUF;                                  // Leer RXBUF limpia la bandera y los errores.
+    uint16_t silencio = MB_TIMER -> R;
+
+    if(trama_lista)
+        return;
+
+    if((recibidos > 0) && (silencio > mb_t15))
+        trama_mala = TRUE;
+    if(error || (recibidos == MODBUS_MAX_FRAME))
+        trama_mala = TRUE;
+    else
+        trama[recibidos++] = c;
+
+    MB_TIMER -> CTL = MB_TIMER_CTL | TIMER_A_CTL_MC__UP | TIMER_A_CTL_CLR;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_ModbusSilencio
+* Returned Value   : None.
+* Comments         :
+*    Hwi del CCR0 del Timer_A: pasaron 3.5 caracteres sin recibir, la trama
+*    termino. Si es valida se la entrega al hilo; si no, se descarta.
+*
+*END***********************************************************************************/
+static void HVAC_ModbusSilencio(UArg arg)
+{
+    MB_TIMER -> CTL = MB_TIMER_CTL | TIMER_A_CTL_MC__STOP | TIMER_A_CTL_CLR;
+    MB_TIMER -> CCTL[0] &= ~TIMER_A_CCTLN_CCIFG;
+
+    if(trama_mala || (recibidos == 0))
+    {
+        modbus_errores_trama++;
+        recibidos = 0;
+        trama_mala = FALSE;
+        return;
+    }
+
+    trama_lista = TRUE;
+    sem_post(&trama_sem);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_InicialiceModbus
+* Returned Value   : Si se pudo abrir el puerto y apartar el Timer_A.
+* Comments         :
+*    Abre el UART de Modbus (8E1), engancha la recepcion por caracter y
+*    programa el Timer_A con t3.5 (fijo en 1.75 mS arriba de 19200 baud,
+*    como pide la especificacion).
+*
+*END***********************************************************************************/
+boolean HVAC_InicialiceModbus(void)
+{
+    const UART_INIT_STRUCT modbus_init =
+    {
+        /* Selected port */        BSP_MODBUS_PORT,
+        /* Selected pins */        {2,3},
+        /* Clk source */           SM_CLK,
+        /* Baud rate */            (Baud_Rate) BSP_MODBUS_BAUD,
+
+        /* Usa paridad */          EVEN,
+        /* Bits protocolo  */      EIGHT_BITS,
+        /* Sobremuestreo */        OVERSAMPLE,
+        /* Bits de stop */         ONE_STOP_BIT,
+        /* Direccion TX */         LSB_FIRST,
+
+        /* Int char's \b */        NO_INTERRUPTION,
+        /* Int char's erroneos */  NO_INTERRUPTION
+    };
+    uint32_t cuentas_ms = pwm_smclk() / MB_TIMER_DIV / 1000;
+    uint32_t caracter = 1000000 * MB_CHAR_BITS / BSP_MODBUS_BAUD;       // uS.
+    uint32_t t15 = 750, t35 = 1750;                                     // uS.
+
+    if(pwm_timer_reserve(BSP_MODBUS_TIMER) != IO_OK)
+        return FALSE;
+
+    if(BSP_MODBUS_BAUD <= 19200)
+    {
+        t15 = caracter * 3 / 2;
+        t35 = caracter * 7 / 2;
+    }
+
+    mb_t15 = (t15 + caracter) * cuentas_ms / 1000;
+    MB_TIMER -> CTL = MB_TIMER_CTL | TIMER_A_CTL_MC__STOP | TIMER_A_CTL_CLR;
+    MB_TIMER -> EX0 = TIMER_A_EX0_IDEX__8;
+    MB_TIMER -> CCR[0] = t35 * cuentas_ms / 1000;
+    MB_TIMER -> CCTL[0] = TIMER_A_CCTLN_CCIE;
+
+    sem_init(&trama_sem, 0, 0);
+    Int_registerHwi(MB_TIMER_IRQ, HVAC_ModbusSilencio, 0);            // Hwi: puede postear trama_sem.
+    Int_enableInterrupt(MB_TIMER_IRQ);
+
+    fd_modbus = fopen_f(BSP_MODBUS_UART, (const char*) &modbus_init);
+    if(fd_modbus == NULL)
+        return FALSE;
+
+    return (ioctl(fd_modbus, IO_IOCTL_SERIAL_IRQ_FUNCTION, (pointer) HVAC_ModbusRx) == IO_OK);
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Modbus
+* Returned Value   : None.
+* Comments         :
+*    Duerme hasta que termina una trama, la procesa y envia la respuesta (si
+*    la hay) por la cola del UART de Modbus.
+*
+*END***********************************************************************************/
+void HVAC_Modbus(void)
+{
+    static uint8_t respuesta[MODBUS_MAX_FRAME];
+    uint32_t largo;
+
+    if(sem_wait(&trama_sem) != 0)
+        return;
+
+    largo = modbus_process(&modbus_esclavo, trama, recibidos, respuesta);
+
+    recibidos = 0;
+    trama_lista = FALSE;                                        // Desde aqui la ISR vuelve a recibir.
+
+    if(largo != 0)                                              // Sin ioctl(): no apaga la RX de Modbus mientras espera.
+        uart_write(BSP_MODBUS_PORT, respuesta, largo);
+}
+
+/* Registros de entrada. */
+static uint16_t HVAC_ModbusLeeEntrada(uint16_t reg)
+{
+    uint32_t valor = 0;
+
+    switch(reg)
+    {
+        case MB_IN_TEMP:        return (uint16_t) HVAC_Centesimas(TemperaturaActual);
+        case MB_IN_SETPOINT:    return (uint16_t) HVAC_Centesimas(SetPoint);
+        case MB_IN_FAN:         return EstadoEntradas.FanState;
+        case MB_IN_SYSTEM:      return EstadoEntradas.SystemState;
+        case MB_IN_OUTPUTS:     ioctl(output_port, GPIO_IOCTL_READ_MASK, &valor); return valor & 0x0F;
+        case MB_IN_DUTY:        ioctl(fd_fan, IOCTL_PWM_GET_DUTY, &valor); return valor;
+        default:                return 0;
+    }
+}
+
+/* Registros holding. */
+static uint16_t HVAC_ModbusLeeHolding(uint16_t reg)
+{
+    if(reg == MB_HOLD_SETPOINT)
+        return (uint16_t) HVAC_Centesimas(SetPoint);
+    return EstadoEntradas.SystemState;
+}
+
+static uint8_t HVAC_ModbusEscribe(uint16_t reg, uint16_t valor)
+{
+    int16_t centesimas = (int16_t) valor;
+
+    if(reg == MB_HOLD_SETPOINT)
+    {
+        if((centesimas < MB_SETPOINT_MIN) || (centesimas > MB_SETPOINT_MAX))
+            return MODBUS_EX_ILLEGAL_VALUE;
+        SetPoint = centesimas / 100.0f;
+        return MODBUS_EX_NONE;
+    }
+
+    if(valor > FanOnly)
+        return MODBUS_EX_ILLEGAL_VALUE;
+    HVAC_SetMode((valor == FanOnly) ? On : Auto, valor);
+    return MODBUS_EX_NONE;
+}
@@ -0,0 +1,230 @@
+ // FileName:        HVAC_Telemetry.c
+ // Dependencies:    HVAC.h
+ // Processor:       MSP432
+ // Board:           MSP432P401R
+ // Program version: CCS V8.3 TI
+ // Company:         Texas Instruments
+ // Description:     Reporte binario del estado del HVAC y bitacora tokenizada: tramas COBS con CRC-16.
+ // Authors:         MarcoCaldM, sobre los drivers de Jose Luis Chacon M. y Jesus Alejandro Navarro Acosta.
+ // Updated:         10/2026
+
+#include "HVAC.h"
+
+/*
+ *  Trama de telemetria (little endian), antes de COBS:
+ *
+ *    0     tipo            TELEMETRY_TYPE_STATE
+ *    1-2   secuencia       Cuenta cada trama enviada.
+ *    3-4   temperatura     Centesimas de grado C, con signo.
+ *    5-6   set point       Centesimas de grado C, con signo.
+ *    7     abanico         enum FAN.
+ *    8     sistema         enum SYSTEM.
+ *    9     salidas         Bit 0 fan, 1 heat, 2 heartbeat, 3 cool (orden de output_set).
+ *    10-11 velocidad       Por mil del PWM del abanico.
+ *    12-13 CRC-16          CCITT (0x1021, inicial 0xFFFF) de los bytes 0-11.
+ *
+ *  Trama de bitacora (HVAC_LOG), igual con CRC y COBS:
+ *
+ *    0     tipo            TELEMETRY_TYPE_LOG
+ *    1-2   identificador   Desplazamiento del formato dentro de .log_fmt.
+ *    3-6   tiempo          mS de la base de tiempo (timer_timebase_us).
+ *    7-    argumentos      0..LOG_MAX_ARGS palabras de 32 bits; su numero sale
+ *                          del largo de la trama.
+ *
+ *  COBS quita los ceros de la trama y un cero la termina, asi que el receptor
+ *  se resincroniza en el siguiente cero aunque pierda bytes.
+ */
+
+extern float TemperaturaActual, SetPoint;
+extern FILE _PTR_ output_port, _PTR_ fd_fan, _PTR_ fd_uart;
+
+uint8_t formato_reporte = REPORT_TEXT;                  // Cambia con el comando FORMAT.
+
+/* CRC-16 CCITT por nibbles: tabla de 16 entradas en lugar de 256. */
+static const uint16_t crc_nibble[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Crc16
+* Returned Value   : CRC-16 CCITT de 'length' bytes.
+* Comments         :
+*    Dos pasos de tabla por byte (nibble alto y bajo).
+*
+*END***********************************************************************************/
+uint16_t HVAC_Crc16(const uint8_t *data, uint32_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while(length--)
+    {
+        crc = (crc << 4) ^ crc_nibble[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ crc_nibble[(crc >> 12) ^ (*data & 0x0F)];
+        data++;
+    }
+
+    return crc;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Cobs
+* Returned Value   : Bytes escritos en 'out', incluido el cero final.
+* Comments         :
+*    Codifica 'length' bytes con COBS. 'out' necesita length + length / 254 + 2
+*    bytes.
+*
+*END***********************************************************************************/
+uint32_t HVAC_Cobs(const uint8_t *in, uint32_t length, uint8_t *out)
+{
+    uint32_t codigo = 0;                                // Lugar del byte de codigo del bloque actual.
+    uint32_t n = 1;
+
+    out[codigo] = 1;
+    while(length--)
+    {
+        if(*in != 0)
+        {
+            out[n++] = *in;
+            out[codigo]++;
+        }
+        if((*in == 0) || (out[codigo] == 0xFF))         // Fin de bloque: un cero o 254 datos.
+        {
+            codigo = n++;
+            out[codigo] = 1;
+        }
+        in++;
+    }
+
+    out[n++] = 0;                                       // Delimitador de trama.
+    return n;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_EnviaTelemetria
+* Returned Value   : None.
+* Comments         :
+*    Arma la trama de estado, le agrega el CRC, la codifica con COBS y la encola
+*    en el UART. No hay formateo de texto ni punto flotante mas alla de escalar
+*    las temperaturas.
+*
+*END***********************************************************************************/
+void HVAC_EnviaTelemetria(void)
+{
+    static uint16_t secuencia = 0;
+    uint8_t  trama[TELEMETRY_FRAME_SIZE];
+    uint8_t  salida[TELEMETRY_FRAME_SIZE + 2];
+    uint32_t salidas = 0, duty = 0;
+    int16_t  temperatura = (int16_t) HVAC_Centesimas(TemperaturaActual);
+    int16_t  deseada = (int16_t) HVAC_Centesimas(SetPoint);
+    uint16_t crc;
+
+    ioctl(output_port, GPIO_IOCTL_READ_MASK, &salidas);
+    ioctl(fd_fan, IOCTL_PWM_GET_DUTY, &duty);
+
+    trama[0]  = TELEMETRY_TYPE_STATE;
+    trama[1]  = secuencia & 0xFF;
+    trama[2]  = secuencia >> 8;
+    trama[3]  = temperatura & 0xFF;
+    trama[4]  = (uint16_t) temperatura >> 8;
+    trama[5]  = deseada & 0xFF;
+    trama[6]  = (uint16_t) deseada >> 8;
+    trama[7]  = EstadoEntradas.FanState;
+    trama[8]  = EstadoEntradas.SystemState;
+    trama[9]  = salidas & 0x0F;
+    trama[10] = duty & 0xFF;
+    trama[11] = duty >> 8;
+
+    crc = HVAC_Crc16(trama, TELEMETRY_FRAME_SIZE - 2);
+    trama[12] = crc & 0xFF;
+    trama[13] = crc >> 8;
+
+    secuencia++;
+    print_raw(salida, HVAC_Cobs(trama, TELEMETRY_FRAME_SIZE, salida));
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_Log
+* Returned Value   : None.
+* Comments         :
+*    Destino de HVAC_LOG. 'fmt' apunta a .log_fmt, que no existe en el MSP432:
+*    solo se usa su direccion como identificador. Los argumentos de mas se
+*    descartan.
+*
+*END***********************************************************************************/
+void HVAC_Log(const char *fmt, uint32_t nargs, const uint32_t *args)
+{
+    uint8_t  trama[7 + 4 * LOG_MAX_ARGS + 2];
+    uint8_t  salida[sizeof(trama) + 2];
+    uint16_t id = (uint32_t) fmt - LOG_FMT_BASE;
+    uint32_t n = 0, i;
+    uint32_t ms = timer_timebase_us() / 1000;                   // Misma base que eventos y muestras.
+    uint16_t crc;
+
+    if(nargs > LOG_MAX_ARGS)
+        nargs = LOG_MAX_ARGS;
+
+    trama[n++] = TELEMETRY_TYPE_LOG;
+    trama[n++] = id & 0xFF;
+    trama[n++] = id >> 8;
+    for(i = 0; i < 4; i++)
+        trama[n++] = ms >> (8 * i);
+    while(nargs--)
+    {
+        for(i = 0; i < 4; i++)
+            trama[n++] = *args >> (8 * i);
+        args++;
+    }
+
+    crc = HVAC_Crc16(trama, n);
+    trama[n++] = crc & 0xFF;
+    trama[n++] = crc >> 8;
+
+    print_raw(salida, HVAC_Cobs(trama, n, salida));
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_LogFloat
+* Returned Value   : Patron de bits de 'x'.
+* Comments         :
+*    Para pasar un float a HVAC_LOG sin convertirlo a entero (LOG_FLOAT).
+*
+*END***********************************************************************************/
+uint32_t HVAC_LogFloat(float x)
+{
+    union { float f; uint32_t u; } bits;
+
+    bits.f = x;
+    return bits.u;
+}
+
+/*FUNCTION******************************************************************************
+*
+* Function Name    : HVAC_LogFlush
+* Returned Value   : None.
+* Comments         :
+*    Espera a que la cola de transmision se vacie; para los errores que
+*    terminan el programa justo despues de reportarse.
+*
+*END***********************************************************************************/
+void HVAC_LogFlush(void)
+{
+    UART_TX_STATUS estado;
+
+    if(fd_uart == NULL)
+        return;
+
+    do
+    {
+        if(ioctl(fd_uart, IO_IOCTL_SERIAL_TX_STATUS, &estado) != IO_OK)
+            return;
+        if(estado.pending)
+            usleep(MILLIS);
+    } while(estado.pending);
+}
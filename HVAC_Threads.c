@@ -1,86 +1,122 @@
- // FileName:        HVAC_Thread.c
- // Dependencies:    HVAC.h
- // Processor:       MSP432
- // Board:           MSP432P401R
- // Program version: CCS V8.3 TI
- // Company:         Texas Instruments
- // Description:     Definicin de los funciones de los threads del HVAC.
- // Authors:         Jos Luis Chacn M. y Jess Alejandro Navarro Acosta.
- // Updated:         11/2018
-
-#include "HVAC.h"                           // Incluye definicin del sistema.
-
-void *Entradas_Thread(void *arg0);
-void *Salidas_Thread(void *arg0);
-void *HeartBeat_Thread(void *arg0);
-
-
-/*********************************THREAD*************************************
- * Function: Entradas_Thread
- * Preconditions: None.
- * Overview: Se inicializa el sistema y perifricos. Constantemente actualiza
- *           el estado del sistema basndose en las entradas.
- * Input:  Apuntador vaco que puede apuntar cualquier tipo de dato.
- * Output: None.
- *
- *****************************************************************************/
-
-
-void *Entradas_Thread(void *arg0)
-{
-   bool flag = TRUE;
-   SystemInit();
-
-   flag &= HVAC_InicialiceIO();
-   flag &= HVAC_InicialiceADC();
-   flag &= HVAC_InicialiceUART();
-
-   if(flag != TRUE)
-   {
-       printf("Error al crear archivo. Cierre del programa\r\n");
-       exit(1);
-   }
-
-   printf("Iniciando HVAC 3 Hilos.\r\n");
-
-   while(TRUE)
-   {
-       HVAC_ActualizarEntradas();
-       usleep(DELAY);
-   }
-}
-
-/*********************************THREAD*****************************************
- * Function: Salidas_Thread
- * Preconditions: Haber inicializado los mdulos GPIO y UART.
- * Overview: Constantemente actualiza las salidas e imprime el estado del sistema.
- * Input:  Apuntador vaco que puede apuntar cualquier tipo de dato.
- * Output: None.
- *
- ********************************************************************************/
-void *Salidas_Thread(void *arg0)
-{
-   while(TRUE)
-   {
-       HVAC_ActualizarSalidas();
-       HVAC_PrintState();
-       usleep(DELAY);
-   }
-}
-
-
-/*********************************THREAD***************************************************
- * Function: HeartBeat_Thread
- * Preconditions: Haber inicializado el mdulo ADC y los GPIO.
- * Overview: Hace un toggle a un estado en base a un delay controlado por un canal del ADC.
- *           El toggle se ve reflejado en una de la salidas del HVAC.
- * Input:  Apuntador vaco que puede apuntar cualquier tipo de dato.
- * Output: None.
- *
- *******************************************************************************************/
-
-void *HeartBeat_Thread(void *arg0)
-{
-    while(TRUE)
-        HVAC_Heartbeat();
-}
+ // FileName:        HVAC_Thread.c
+ // Dependencies:    HVAC.h
+ // Processor:       MSP432
+ // Board:           MSP432P401R
+ // Program version: CCS V8.3 TI
+ // Company:         Texas Instruments
+ // Description:     Definición de los funciones de los threads del HVAC.
+ // Authors:         José Luis Chacón M. y Jesús Alejandro Navarro Acosta.
+ // Updated:         11/2018
+
+#include "HVAC.h"                           // Incluye definición del sistema.
+
+void *Entradas_Thread(void *arg0);
+void *Salidas_Thread(void *arg0);
+void *HeartBeat_Thread(void *arg0);
+void *Comandos_Thread(void *arg0);
+void *Modbus_Thread(void *arg0);
+
+
+/*********************************THREAD*************************************
+ * Function: Entradas_Thread
+ * Preconditions: None.
+ * Overview: Se inicializa el sistema y periféricos. Actualiza el estado del
+ *           sistema con cada evento de las entradas; sin eventos, no corre.
+ * Input:  Apuntador vacío que puede apuntar cualquier tipo de dato.
+ * Output: None.
+ *
+ *****************************************************************************/
+
+
+void *Entradas_Thread(void *arg0)
+{
+   bool flag = TRUE;
+   SystemInit();
+   timer_timebase_init();               // Base de tiempo comun, ya con el reloj final.
+
+   flag &= HVAC_InicialiceIO();
+   flag &= HVAC_InicialiceADC();
+   flag &= HVAC_InicialiceUART();
+   flag &= HVAC_InicialiceModbus();
+
+   if(flag != TRUE)
+   {
+       HVAC_LOG("Error al crear archivo. Cierre del programa");
+       HVAC_LogFlush();
+       exit(1);
+   }
+
+   HVAC_LOG("Iniciando HVAC 3 Hilos.");
+
+   while(TRUE)
+       HVAC_ActualizarEntradas();       // Bloquea en la cola de eventos de las entradas.
+}
+
+/*********************************THREAD*****************************************
+ * Function: Salidas_Thread
+ * Preconditions: Haber inicializado los módulos GPIO y UART.
+ * Overview: Constantemente actualiza las salidas e imprime el estado del sistema.
+ * Input:  Apuntador vacío que puede apuntar cualquier tipo de dato.
+ * Output: None.
+ *
+ ********************************************************************************/
+void *Salidas_Thread(void *arg0)
+{
+   while(TRUE)
+   {
+       HVAC_ActualizarSalidas();
+       HVAC_PrintState();
+       usleep(DELAY);
+   }
+}
+
+
+/*********************************THREAD***************************************************
+ * Function: HeartBeat_Thread
+ * Preconditions: Haber inicializado el módulo ADC y los GPIO.
+ * Overview: Hace un toggle a un estado en base a un delay controlado por un canal del ADC.
+ *           El toggle se ve reflejado en una de la salidas del HVAC.
+ * Input:  Apuntador vacío que puede apuntar cualquier tipo de dato.
+ * Output: None.
+ *
+ *******************************************************************************************/
+
+void *HeartBeat_Thread(void *arg0)
+{
+    while(TRUE)
+        HVAC_Heartbeat();
+}
+
+
+/*********************************THREAD***************************************************
+ * Function: Comandos_Thread
+ * Preconditions: Haber inicializado el módulo UART (lo hace Entradas_Thread).
+ * Overview: Ejecuta los comandos recibidos por UART, una línea a la vez. Duerme mientras
+ *           no llega una línea completa, así que no le quita tiempo a los hilos de control.
+ * Input:  Apuntador vacío que puede apuntar cualquier tipo de dato.
+ * Output: None.
+ *
+ *******************************************************************************************/
+
+void *Comandos_Thread(void *arg0)
+{
+    while(TRUE)
+        HVAC_Comandos();
+}
+
+
+/*********************************THREAD***************************************************
+ * Function: Modbus_Thread
+ * Preconditions: Haber inicializado el esclavo Modbus (lo hace Entradas_Thread).
+ * Overview: Atiende al maestro Modbus RTU: duerme hasta que el silencio de 3.5 caracteres
+ *           cierra una trama, la procesa y responde.
+ * Input:  Apuntador vacío que puede apuntar cualquier tipo de dato.
+ * Output: None.
+ *
+ *******************************************************************************************/
+
+void *Modbus_Thread(void *arg0)
+{
+    while(TRUE)
+        HVAC_Modbus();
+}
@@ -14,6 +14,8 @@
 extern void *Entradas_Thread(void *arg0);   // Threads que arrancar�n inicialmente.
 extern void *Salidas_Thread(void *arg0);
 extern void *HeartBeat_Thread(void *arg0);
+extern void *Comandos_Thread(void *arg0);
+extern void *Modbus_Thread(void *arg0);
 
 int main(void)
 {
@@ -63,6 +65,29 @@ int main(void)
     retc = pthread_create(&heartbeat_thread, &pAttrs, HeartBeat_Thread, NULL);  // Creaci�n del thread.
     if (retc != 0) { while (1); }
 
+   /**********************
+    ** Comandos Thread   *
+    **********************/
+
+    pthread_attr_init(&pAttrs);                                                 /* Reinicio de parametros. */
+    priParam.sched_priority = 1;                                                // Duerme hasta recibir una linea.
+    retc |= pthread_attr_setstacksize(&pAttrs, THREADSTACKSIZE4);
+    if (retc != 0) { while (1); }
+    pthread_attr_setschedparam(&pAttrs, &priParam);
+    retc = pthread_create(&comandos_thread, &pAttrs, Comandos_Thread, NULL);
+    if (retc != 0) { while (1); }
+
+   /**********************
+    ** Modbus Thread     *
+    **********************/
+    pthread_attr_init(&pAttrs);                                                 /* Reinicio de parametros. */
+    priParam.sched_priority = 2;                                                // Responde al maestro antes que los reportes.
+    retc |= pthread_attr_setstacksize(&pAttrs, THREADSTACKSIZE5);
+    if (retc != 0) { while (1); }
+    pthread_attr_setschedparam(&pAttrs, &priParam);
+    retc = pthread_create(&modbus_thread, &pAttrs, Modbus_Thread, NULL);
+    if (retc != 0) { while (1); }
+
    /* Arranque del sistema. */
    BIOS_start();
    return (0);
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# FileName:        log_decoder.py
+# Dependencies:    Python 3; pyserial solo para leer directo de un puerto serie.
+# Description:     Decodificador en la PC de la bitacora tokenizada (HVAC_LOG) y de
+#                  las tramas de telemetria del HVAC. Los formatos se toman de la
+#                  seccion .log_fmt del .out de la misma compilacion.
+#
+# Uso:
+#   log_decoder.py Debug/HVAC_TRES_HILOS_OBJ_MACM.out /dev/ttyACM0 [--baud 115200]
+#   log_decoder.py Debug/HVAC_TRES_HILOS_OBJ_MACM.out captura.bin
+#
+# Lo que no es trama valida (texto del modo FORMAT TEXT, respuestas del interprete)
+# se muestra tal cual.
+
+import argparse
+import os
+import re
+import stat
+import struct
+import sys
+
+TELEMETRY_TYPE_STATE = 0x01
+TELEMETRY_TYPE_LOG = 0x02
+LOG_FMT_BASE = 0x90000000          # Igual que en HVAC.h y en el .cmd.
+
+FAN = ["On", "Auto"]
+SYSTEM = ["Cool", "Off", "Heat", "FanOnly"]
+
+
+def load_formats(elf_path):
+    """Regresa (direccion de .log_fmt, contenido) del ELF de TI (ARM, 32 bits)."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        sys.exit("%s: no es un ELF de 32 bits" % elf_path)
+    end = "<" if elf[5] == 1 else ">"
+    shoff, = struct.unpack_from(end + "I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", elf, 0x2E)
+
+    def section(i):
+        return struct.unpack_from(end + "IIIIIIIIII", elf, shoff + i * shentsize)
+
+    names = section(shstrndx)
+    for i in range(shnum):
+        sh = section(i)
+        start = names[4] + sh[0]
+        name = elf[start:elf.index(b"\0", start)].decode()
+        if name == ".log_fmt":
+            return sh[3], elf[sh[4]:sh[4] + sh[5]]
+    sys.exit("%s: no tiene seccion .log_fmt" % elf_path)
+
+
+def crc16(data):
+    """CRC-16 CCITT (0x1021, inicial 0xFFFF), como HVAC_Crc16."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frame(data):
+    """Trama con CRC valido (sin el CRC), o None."""
+    raw = cobs_decode(data)
+    if raw is None or len(raw) < 3:
+        return None
+    if crc16(raw[:-2]) != struct.unpack_from("<H", raw, len(raw) - 2)[0]:
+        return None
+    return raw[:-2]
+
+
+CONVERSION = re.compile(r"%[-+ #0]*(\d+|\*)?(\.\d+)?(hh|h|ll|l|z|t)?([diouxXcfFeEgGsp%])")
+
+
+def render(fmt, args):
+    """printf de C con los argumentos crudos de 32 bits."""
+    out = []
+    pos = 0
+    args = list(args)
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group(4)
+        spec = m.group(0)[:m.start(3) - m.start()] if m.group(3) else m.group(0)[:-1]
+        if conv == "%":
+            out.append("%")
+            continue
+        word = args.pop(0) if args else 0
+        if conv in "di":
+            out.append((spec + "d") % struct.unpack("<i", struct.pack("<I", word))[0])
+        elif conv in "fFeEgG":
+            out.append((spec + conv) % struct.unpack("<f", struct.pack("<I", word))[0])
+        elif conv == "c":
+            out.append((spec + "c") % chr(word & 0xFF))
+        elif conv in "sp":
+            out.append("<0x%08X>" % word)          # Solo viajo el apuntador.
+        else:
+            out.append((spec + ("d" if conv == "u" else conv)) % word)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def show(raw, formats):
+    kind = raw[0]
+    if kind == TELEMETRY_TYPE_LOG and (len(raw) - 7) % 4 == 0:
+        ident, ms = struct.unpack_from("<HI", raw, 1)
+        args = struct.unpack_from("<%dI" % ((len(raw) - 7) // 4), raw, 7)
+        base, table = formats
+        offset = LOG_FMT_BASE + ident - base
+        if 0 <= offset < len(table):
+            fmt = table[offset:table.index(b"\0", offset)].decode("latin-1")
+            text = render(fmt, args)
+        else:
+            text = "<formato %d desconocido> %s" % (ident, " ".join("0x%08X" % a for a in args))
+        return "[%10.3f] %s" % (ms / 1000.0, text)
+    if kind == TELEMETRY_TYPE_STATE and len(raw) == 12:
+        seq, temp, sp, fan, system, outputs, duty = struct.unpack_from("<HhhBBBH", raw, 1)
+        return "#%u Temp: %.2f SetPoint: %.2f Fan: %s System: %s Salidas: 0x%X Duty: %u" % (
+            seq, temp / 100.0, sp / 100.0,
+            FAN[fan] if fan < len(FAN) else fan,
+            SYSTEM[system] if system < len(SYSTEM) else system,
+            outputs, duty)
+    return "<trama tipo 0x%02X, %d bytes>" % (kind, len(raw))
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer
+    if stat.S_ISCHR(os.stat(path).st_mode):
+        import serial
+        return serial.Serial(path, baud)
+    return open(path, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodifica la bitacora y telemetria del HVAC.")
+    parser.add_argument("elf", help=".out de la compilacion que corre en la tarjeta")
+    parser.add_argument("input", help="puerto serie, archivo capturado o - para stdin")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    formats = load_formats(args.elf)
+    source = open_input(args.input, args.baud)
+    pending = bytearray()
+
+    while True:
+        chunk = source.read(1)
+        if not chunk:
+            break
+        if chunk != b"\0":
+            pending += chunk
+            continue
+        # Un cero cierra una trama; lo anterior a ella en el mismo tramo es texto.
+        for start in range(len(pending)):
+            raw = frame(bytes(pending[start:]))
+            if raw is not None:
+                sys.stdout.write(pending[:start].decode("latin-1"))
+                print(show(raw, formats))
+                break
+        else:
+            sys.stdout.write(pending.decode("latin-1"))
+        sys.stdout.flush()
+        pending.clear()
+
+    sys.stdout.write(pending.decode("latin-1"))
+
+
+if __name__ == "__main__":
+    main()
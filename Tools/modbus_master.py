@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# FileName:        modbus_master.py
+# Dependencies:    Python 3; pyserial solo para puertos serie reales.
+# Description:     Maestro Modbus RTU minimo para probar el esclavo del HVAC (HVAC_Modbus.c)
+#                  desde la PC: por el puerto serie de la tarjeta o por un pty de Linux
+#                  (p. ej. el extremo que deja "socat -d -d pty,raw,echo=0 pty,raw,echo=0").
+#
+# Uso:
+#   modbus_master.py /dev/ttyUSB0 estado
+#   modbus_master.py /dev/pts/5 setpoint 23.5
+#   modbus_master.py /dev/pts/5 modo heat
+#   modbus_master.py /dev/pts/5 leer 4 0 6          # Funcion, primer registro, cantidad.
+
+import argparse
+import os
+import struct
+import sys
+import termios
+import time
+
+MODBUS_ADDRESS = 1                 # Igual que en HVAC.h.
+BAUD = 19200                       # Igual que BSP_MODBUS_BAUD (8E1).
+
+# Registros; ver HVAC_Modbus.c.
+IN_NAMES = ["Temp", "SetPoint", "Fan", "System", "Salidas", "Duty"]
+HOLD_SETPOINT = 0
+HOLD_MODE = 1
+MODES = {"cool": 0, "off": 1, "heat": 2, "fan": 3}
+FAN = ["On", "Auto"]
+SYSTEM = ["Cool", "Off", "Heat", "FanOnly"]
+
+EXCEPTIONS = {1: "funcion ilegal", 2: "direccion ilegal", 3: "valor ilegal", 4: "falla del esclavo"}
+
+
+def crc16(data):
+    """CRC-16 de Modbus (0xA001 reflejado, inicial 0xFFFF), como modbus_crc16."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+class Link:
+    """Puerto serie o pty en modo crudo; el fin de trama es el silencio."""
+
+    def __init__(self, path, baud):
+        self.char_time = 11.0 / baud
+        try:
+            import serial
+            self.port = serial.Serial(path, baud, parity=serial.PARITY_EVEN, timeout=0)
+            self.read = lambda: self.port.read(256)
+            self.write = self.port.write
+        except ImportError:
+            fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+            attrs = termios.tcgetattr(fd)
+            attrs[0] = attrs[1] = attrs[3] = 0                       # Crudo: sin eco ni traduccion.
+            speed = getattr(termios, "B%d" % baud)
+            attrs[2] = termios.CS8 | termios.PARENB | termios.CREAD | termios.CLOCAL
+            attrs[4] = attrs[5] = speed
+            try:
+                termios.tcsetattr(fd, termios.TCSANOW, attrs)
+            except termios.error:                                    # Algunos pty no aceptan paridad
+                attrs[2] &= ~termios.PARENB                          # (ni la usan).
+                termios.tcsetattr(fd, termios.TCSANOW, attrs)
+            self.read = lambda: self._read(fd)
+            self.write = lambda data: os.write(fd, data)
+
+    @staticmethod
+    def _read(fd):
+        try:
+            return os.read(fd, 256)
+        except BlockingIOError:
+            return b""
+
+    def transact(self, request, timeout=1.0):
+        self.read()                                                  # Descarta basura previa.
+        self.write(request + struct.pack("<H", crc16(request)))
+        reply = b""
+        deadline = time.time() + timeout
+        quiet = max(3.5 * self.char_time, 0.00175) * 4               # Holgura por el sistema operativo.
+        last = None
+        while time.time() < deadline:
+            chunk = self.read()
+            if chunk:
+                reply += chunk
+                last = time.time()
+            elif last is not None and time.time() - last > quiet:
+                break
+            time.sleep(0.001)
+        if not reply:
+            raise IOError("sin respuesta del esclavo")
+        if len(reply) < 5 or crc16(reply[:-2]) != struct.unpack("<H", reply[-2:])[0]:
+            raise IOError("respuesta con CRC o largo invalido: %s" % reply.hex())
+        if reply[1] & 0x80:
+            raise IOError("excepcion %d (%s)" % (reply[2], EXCEPTIONS.get(reply[2], "?")))
+        return reply[:-2]
+
+
+def read_registers(link, function, first, count):
+    reply = link.transact(struct.pack(">BBHH", MODBUS_ADDRESS, function, first, count))
+    return struct.unpack(">%dH" % count, reply[3:3 + 2 * count])
+
+
+def write_register(link, reg, value):
+    link.transact(struct.pack(">BBHH", MODBUS_ADDRESS, 0x06, reg, value & 0xFFFF))
+
+
+def signed(value):
+    return value - 0x10000 if value & 0x8000 else value
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Maestro Modbus RTU para el HVAC.")
+    parser.add_argument("port", help="puerto serie o pty")
+    parser.add_argument("command", choices=["estado", "setpoint", "modo", "leer"])
+    parser.add_argument("args", nargs="*")
+    parser.add_argument("--baud", type=int, default=BAUD)
+    args = parser.parse_args()
+
+    link = Link(args.port, args.baud)
+    try:
+        if args.command == "estado":
+            regs = read_registers(link, 0x04, 0, len(IN_NAMES))
+            print("Temp: %.2f SetPoint: %.2f Fan: %s System: %s Salidas: 0x%X Duty: %u" % (
+                signed(regs[0]) / 100.0, signed(regs[1]) / 100.0,
+                FAN[regs[2]] if regs[2] < len(FAN) else regs[2],
+                SYSTEM[regs[3]] if regs[3] < len(SYSTEM) else regs[3],
+                regs[4], regs[5]))
+        elif args.command == "setpoint":
+            write_register(link, HOLD_SETPOINT, int(round(float(args.args[0]) * 100)))
+            print("OK")
+        elif args.command == "modo":
+            write_register(link, HOLD_MODE, MODES[args.args[0].lower()])
+            print("OK")
+        else:
+            function, first, count = (int(a, 0) for a in args.args[:3])
+            print(" ".join("%d" % v for v in read_registers(link, function, first, count)))
+    except (IOError, IndexError, KeyError, ValueError) as error:
+        sys.exit("error: %s" % error)
+
+
+if __name__ == "__main__":
+    main()
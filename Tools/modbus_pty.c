@@ -0,0 +1,173 @@
+// FileName:        modbus_pty.c
+// Dependencies:    gcc de la PC (Linux); Drivers_obj/modbus_rtu.c.
+// Description:     Esclavo Modbus RTU del HVAC en un pty de Linux: recibe tramas por el
+//                  silencio entre caracteres, las pasa a modbus_process (el mismo codigo
+//                  que corre en la tarjeta) y devuelve la respuesta. El mapa de registros
+//                  imita al de HVAC_Modbus.c con un estado simulado, para probar
+//                  Tools/modbus_master.py de punta a punta sin la tarjeta.
+//
+// Uso (desde la raiz del proyecto):
+//   gcc -Wall -I Drivers_obj Tools/modbus_pty.c Drivers_obj/modbus_rtu.c -o modbus_pty
+//   ./modbus_pty                                  # Imprime el pty, p. ej. /dev/pts/5.
+//   Tools/modbus_master.py /dev/pts/5 estado      # Funcion 4.
+//   Tools/modbus_master.py /dev/pts/5 leer 4 0 7  # Excepcion 2 (direccion ilegal).
+//
+// Solo para la PC: Tools/ esta excluido del proyecto de CCS (.cproject), asi que este
+// main() no entra al firmware.
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include "modbus_rtu.h"
+
+#define MODBUS_ADDRESS      1           // Igual que en HVAC.h.
+#define SILENCIO_MS         5           // t3.5 (1.75 mS) con holgura por el sistema operativo.
+
+// Mapa de registros de HVAC_Modbus.c.
+#define MB_IN_TEMP          0
+#define MB_IN_SETPOINT      1
+#define MB_IN_FAN           2
+#define MB_IN_SYSTEM        3
+#define MB_IN_OUTPUTS       4
+#define MB_IN_DUTY          5
+#define MB_INPUT_COUNT      6
+
+#define MB_HOLD_SETPOINT    0
+#define MB_HOLD_MODE        1
+#define MB_HOLDING_COUNT    2
+
+#define SETPOINT_MIN        10.0        // Igual que en HVAC.h.
+#define SETPOINT_MAX        35.0
+
+enum { Cool, Off, Heat, FanOnly };      // enum SYSTEM.
+enum { On, Auto };                      // enum FAN.
+
+// Estado simulado del HVAC (centesimas de grado C).
+static int16_t  temperatura = 2350;
+static int16_t  set_point = 2200;
+static uint16_t fan = Auto;
+static uint16_t sistema = Off;
+
+static uint16_t lee_entrada(uint16_t reg)
+{
+    switch (reg)
+    {
+        case MB_IN_TEMP:        return (uint16_t) temperatura;
+        case MB_IN_SETPOINT:    return (uint16_t) set_point;
+        case MB_IN_FAN:         return fan;
+        case MB_IN_SYSTEM:      return sistema;
+        case MB_IN_OUTPUTS:     return (fan == On);             // Bit 0: abanico (no se simula el resto).
+        case MB_IN_DUTY:        return (fan == On) ? 1000 : 0;
+        default:                return 0;
+    }
+}
+
+static uint16_t lee_holding(uint16_t reg)
+{
+    return (reg == MB_HOLD_SETPOINT) ? (uint16_t) set_point : sistema;
+}
+
+static uint8_t escribe(uint16_t reg, uint16_t valor)
+{
+    int16_t centesimas = (int16_t) valor;
+
+    if (reg == MB_HOLD_SETPOINT)
+    {
+        if ((centesimas < SETPOINT_MIN * 100) || (centesimas > SETPOINT_MAX * 100))
+            return MODBUS_EX_ILLEGAL_VALUE;
+        set_point = centesimas;
+        return MODBUS_EX_NONE;
+    }
+
+    if (valor > FanOnly)
+        return MODBUS_EX_ILLEGAL_VALUE;
+    sistema = valor;
+    fan = (valor == FanOnly) ? On : Auto;
+    return MODBUS_EX_NONE;
+}
+
+static MODBUS_SLAVE esclavo =
+{
+    MODBUS_ADDRESS,
+    MB_HOLDING_COUNT,
+    MB_INPUT_COUNT,
+    lee_holding,
+    lee_entrada,
+    escribe,
+    0, 0, 0
+};
+
+int main(void)
+{
+    uint8_t trama[MODBUS_MAX_FRAME], respuesta[MODBUS_MAX_FRAME];
+    uint32_t recibidos = 0, largo;
+    struct termios modo;
+    struct pollfd espera;
+    int maestro, esclavo_fd, listos;
+    ssize_t n;
+
+    if ((maestro = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(maestro) || unlockpt(maestro))
+    {
+        perror("pty");
+        return 1;
+    }
+
+    // Se conserva abierto el lado esclavo para que el pty no se cuelgue entre maestros.
+    if ((esclavo_fd = open(ptsname(maestro), O_RDWR | O_NOCTTY)) < 0)
+    {
+        perror(ptsname(maestro));
+        return 1;
+    }
+    tcgetattr(esclavo_fd, &modo);
+    cfmakeraw(&modo);
+    tcsetattr(esclavo_fd, TCSANOW, &modo);
+
+    printf("%s\n", ptsname(maestro));
+    fflush(stdout);
+
+    espera.fd = maestro;
+    espera.events = POLLIN;
+
+    for (;;)
+    {
+        // Sin trama en curso se duerme; con trama, el silencio la termina.
+        listos = poll(&espera, 1, recibidos ? SILENCIO_MS : -1);
+        if (listos < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            return 1;
+        }
+
+        if (listos > 0)
+        {
+            n = read(maestro, trama + recibidos, sizeof(trama) - recibidos);
+            if (n > 0)
+                recibidos += n;
+            if (recibidos < sizeof(trama))
+                continue;
+        }
+
+        if (recibidos == 0)
+            continue;
+
+        largo = modbus_process(&esclavo, trama, recibidos, respuesta);
+        fprintf(stderr, "trama de %u bytes, respuesta de %u (%u tramas, %u errores, %u excepciones)\n",
+                (unsigned) recibidos, (unsigned) largo, (unsigned) esclavo.requests,
+                (unsigned) esclavo.errors, (unsigned) esclavo.exceptions);
+        recibidos = 0;
+
+        if (largo != 0 && write(maestro, respuesta, largo) != (ssize_t) largo)
+        {
+            perror("write");
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,172 @@
+// FileName:        test_timer_wheel.c
+// Dependencies:    gcc de la PC; Drivers_obj/timer_f_msp432.c (se incluye completo).
+// Description:     Prueba en la PC de la rueda de tiempos: 1000 unidades con periodos de
+//                  1 a 3600 s corren un dia simulado, con latencia de interrupcion al azar,
+//                  y al final cada una debe tener exactamente los vencimientos y el tiempo
+//                  contado que le tocan (deriva cero). Se corre con un step exacto (1000 uS)
+//                  y con uno que deja resto en cada periodo (1024 uS). Los registros del
+//                  Timer32 y las funciones Int_* se simulan aqui; no hace falta la tarjeta.
+//
+// Uso (desde la raiz del proyecto):
+//   gcc -Wall -I . -I Drivers_obj Tools/test_timer_wheel.c -o test_timer_wheel
+//   ./test_timer_wheel              # Sale con 0 si ninguna unidad tiene deriva.
+//
+// Solo para la PC: Tools/ esta excluido del proyecto de CCS (.cproject), asi que este
+// main() no entra al firmware.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "types.h"
+#include "structures.h"
+#include "Files.h"
+
+// Lo que el driver toma de HVAC.h, BSP.h y msp.h; HVAC.h se salta por su guarda.
+#define _hvac_h_
+#define __SYSTEM_CLOCK              48000000
+#define STEP                        1000
+#define MILLIS                      1000
+#define SEC                         1000000
+#define TRUE                        1           // De xdc/std.h, por medio de SYS/BIOS.
+#define FALSE                       0
+
+#include "timer_f_msp432.h"
+
+// Registros del Timer32: timer32_1 es la base de tiempo, timer32_2 el disparo.
+typedef struct
+{
+    volatile uint32_t LOAD, VALUE, CONTROL, INTCLR, RIS, MIS, BGLOAD;
+
+} TIMER32_SIM;
+
+static TIMER32_SIM timer32_sim[2];
+
+#define TIMER32_1                   (&timer32_sim[0])
+#define TIMER32_2                   (&timer32_sim[1])
+#define TIMER32_CONTROL_ONESHOT     0x01
+#define TIMER32_CONTROL_SIZE        0x02
+#define TIMER32_CONTROL_PRESCALE_0  0x00
+#define TIMER32_CONTROL_IE          0x20
+#define TIMER32_CONTROL_ENABLE      0x80
+#define TIMER32_RIS_RAW_IFG         0x01
+#define INT_T32_INT1                41
+#define INT_T32_INT2                42
+
+void Int_disable (void) { }
+void Int_enable (void) { }
+void Int_enableInterrupt (uint32_t interruptNumber) { (void) interruptNumber; }
+void Int_registerInterrupt (uint_32 interruptNumber, void (*intHandler)(void)) { (void) interruptNumber; (void) intHandler; }
+
+#include "timer_f_msp432.c"
+
+#define UNIDADES        1000
+#define DIA_S           86400u
+#define LATENCIA_US     2500            // Latencia maxima de entrada a Timer_Handler (mas de un tick).
+#define INICIO          0xFFF00000u     // Cerca de la primera vuelta del timer32_1.
+
+static IO_DEVICE_STRUCT dispositivo = { "timer:", NULL, NULL, NULL, NULL };
+static FILE_f           archivos[UNIDADES + 1];
+static uint32_t         periodos[UNIDADES];
+static uint64_t         ciclos;         // Ciclos de MCLK simulados.
+
+// Pone la base de tiempo en 't' ciclos: la cuenta del timer32_1 y sus vueltas.
+static void reloj (uint64_t t)
+{
+    ciclos = t;
+    TIMER32_1 -> VALUE = ~(uint32_t) t;
+    timebase_epoch = (uint32_t) (t >> 32);
+}
+
+// Ticks en que vence el n-esimo periodo: el periodo exacto en uS, redondeado hacia abajo.
+static uint64_t vencimiento (uint32_t periodo, uint64_t n, uint32_t step)
+{
+    return n * periodo * SEC / step;
+}
+
+static uint32_t prueba (uint32_t step)
+{
+    TIMER_INIT_STRUCT general = { RUN, step };
+    TIMER_UNIT_INIT_STRUCT init = { RUN, 0, { 25, 0, 0 }, 0 };  // 25 h: no se alcanza en un dia.
+    TIMER_UNIT_DATA_PTR unit;
+    uint64_t ticks = (uint64_t) DIA_S * SEC / step, fin, n, segundos;
+    uint32_t interrupciones = 0, fallas = 0, azar = 12345, i;
+    char nombre[16];
+
+    reloj(INICIO);
+    archivos[UNIDADES].DEV_PTR = &dispositivo;
+    if (timer_open(&archivos[UNIDADES], "timer:", (char_ptr) &general) != IO_OK)
+        return 1;
+    fin = timer_last + ticks * TIMEBASE_TICKS_PER_US * step;
+
+    for (i = 0; i < UNIDADES; i++)
+    {
+        periodos[i] = 1 + (i * 7919) % 3600;
+        init.time_period = periodos[i];
+
+        sprintf(nombre, "timer:%u", (unsigned) (i * 61));
+        archivos[i].DEV_PTR = &dispositivo;
+        if (timer_open(&archivos[i], nombre, (char_ptr) &init) != IO_OK)
+            return 1;
+    }
+
+    // El timer32_2 dispara LOAD ciclos despues de programarse; la interrupcion entra tarde.
+    while (ciclos + TIMER32_2 -> LOAD <= fin)
+    {
+        azar = azar * 1103515245 + 12345;
+        reloj(ciclos + TIMER32_2 -> LOAD + (azar >> 8) % (LATENCIA_US * TIMEBASE_TICKS_PER_US));
+        if (ciclos > fin)
+            reloj(fin);
+        Timer_Handler();
+        interrupciones++;
+    }
+    reloj(fin);
+    timer_sync();
+
+    for (i = 0; i < UNIDADES; i++)
+    {
+        unit = (TIMER_UNIT_DATA_PTR) archivos[i].DEV_DATA_PTR;
+
+        // Vencimientos que ya pasaron en el dia: el siguiente debe seguir programado exacto.
+        n = ticks * step / ((uint64_t) periodos[i] * SEC);
+        while (vencimiento(periodos[i], n + 1, step) <= ticks)
+            n++;
+        while (n > 0 && vencimiento(periodos[i], n, step) > ticks)
+            n--;
+        segundos = (n * periodos[i]) % DIA_S;
+
+        if ((unit -> expires != (uint32_t) vencimiento(periodos[i], n + 1, step)) ||
+            (unit -> time[HOURS] * 3600 + unit -> time[MINUTES] * 60 + unit -> time[SECONDS] != segundos))
+        {
+            if (fallas++ < 5)
+                printf("FALLA step %u: unidad %u (%u s) vence en %u, debe en %u; cuenta %02u:%02u:%02u\n",
+                       (unsigned) step, (unsigned) unit -> num, (unsigned) periodos[i], (unsigned) unit -> expires,
+                       (unsigned) vencimiento(periodos[i], n + 1, step), (unsigned) unit -> time[HOURS],
+                       (unsigned) unit -> time[MINUTES], (unsigned) unit -> time[SECONDS]);
+        }
+    }
+
+    printf("step %4u uS: %u unidades, %llu ticks, %u interrupciones (%.1f/s), %u con deriva\n",
+           (unsigned) step, UNIDADES, (unsigned long long) ticks, (unsigned) interrupciones,
+           interrupciones / (double) DIA_S, (unsigned) fallas);
+
+    // Cierre a mano: timer_close usa el FILE de la tarjeta.
+    while (timer -> units != NULL)
+    {
+        unit = timer -> units;
+        timer -> units = unit -> all;
+        free(unit);
+    }
+    free(timer);
+    timer = NULL;
+    timer_activated[SOLO_TIMER] = FALSE;
+    timer_tick = STEP;
+
+    return fallas;
+}
+
+int main (void)
+{
+    uint32_t fallas = prueba(1000) + prueba(1024);
+
+    return fallas ? 1 : 0;
+}
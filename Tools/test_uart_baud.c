@@ -0,0 +1,156 @@
+// FileName:        test_uart_baud.c
+// Dependencies:    gcc de la PC; Drivers_obj/uart_baud_MSP432.c.
+// Description:     Prueba en la PC de uart_baud_divisors() contra la tabla de ajustes
+//                  recomendados de TI (Technical Reference Manual del MSP432, tabla 24-5)
+//                  y del error promedio de bit a 48 MHz, el SMCLK de la tarjeta.
+//
+// Uso (desde la raiz del proyecto):
+//   gcc -Wall -I Drivers_obj Tools/test_uart_baud.c Drivers_obj/uart_baud_MSP432.c -o test_uart_baud
+//   ./test_uart_baud                # Sale con 0 si todo coincide.
+//
+// Solo para la PC: Tools/ esta excluido del proyecto de CCS (.cproject), asi que este
+// main() no entra al firmware.
+
+#include <stdio.h>
+#include "types.h"
+#include "Files.h"
+#include "uart_baud_MSP432.h"
+
+// Renglon de la tabla de TI. 'search' marca los UCBRSx que TI obtuvo con su busqueda
+// de error minimo y no con la tabla 24-4 (la que usa el driver): ahi solo se exige la
+// misma cantidad de bits modulados, es decir, el mismo periodo promedio de bit.
+typedef struct
+{
+    unsigned brclk;
+    unsigned baud;
+    unsigned os16;
+    unsigned brw;
+    unsigned brf;
+    unsigned brs;
+    unsigned search;
+
+} TI_BAUD_ROW;
+
+static const TI_BAUD_ROW ti_table[] =
+{
+    {    32768,   1200, 1,   1, 11, 0x25, 0 },
+    {    32768,   2400, 0,  13,  0, 0xB6, 0 },
+    {    32768,   4800, 0,   6,  0, 0xEE, 0 },
+    {    32768,   9600, 0,   3,  0, 0x92, 0 },
+    {  1000000,   9600, 1,   6,  8, 0x20, 0 },
+    {  1000000,  19200, 1,   3,  4, 0x02, 0 },
+    {  1000000,  38400, 1,   1, 10, 0x00, 0 },
+    {  1000000,  57600, 0,  17,  0, 0x4A, 0 },
+    {  1000000, 115200, 0,   8,  0, 0xD6, 0 },
+    {  1048576,   9600, 1,   6, 13, 0x22, 0 },
+    {  1048576,  19200, 1,   3,  6, 0xAD, 0 },
+    {  1048576,  38400, 1,   1, 11, 0x25, 0 },
+    {  1048576,  57600, 0,  18,  0, 0x11, 0 },
+    {  1048576, 115200, 0,   9,  0, 0x08, 0 },
+    {  3000000,   9600, 1,  19,  8, 0x55, 0 },
+    {  4000000,   9600, 1,  26,  0, 0xB6, 0 },
+    {  4000000,  38400, 1,   6,  8, 0x20, 0 },
+    {  4000000,  57600, 1,   4,  5, 0x55, 0 },
+    {  4000000, 115200, 1,   2,  2, 0xBB, 0 },
+    {  4000000, 230400, 0,  17,  0, 0x4A, 0 },
+    {  8000000,   9600, 1,  52,  1, 0x49, 1 },
+    {  8000000,  19200, 1,  26,  0, 0xB6, 0 },
+    {  8000000,  57600, 1,   8, 10, 0xF7, 0 },
+    {  8000000, 115200, 1,   4,  5, 0x55, 0 },
+    {  8000000, 230400, 1,   2,  2, 0xBB, 0 },
+    {  8000000, 460800, 0,  17,  0, 0x4A, 0 },
+    { 12000000,   9600, 1,  78,  2, 0x00, 0 },
+    { 12000000,  19200, 1,  39,  1, 0x00, 0 },
+    { 12000000,  57600, 1,  13,  0, 0x25, 0 },
+    { 12000000, 115200, 1,   6,  8, 0x20, 0 },
+    { 12000000, 230400, 1,   3,  4, 0x02, 0 },
+    { 12000000, 460800, 1,   1, 10, 0x00, 0 },
+    { 16000000,   9600, 1, 104,  2, 0xD6, 1 },
+    { 16000000,  38400, 1,  26,  0, 0xB6, 0 },
+    { 16000000,  57600, 1,  17,  5, 0xDD, 0 },
+    { 16000000, 115200, 1,   8, 10, 0xF7, 0 },
+    { 16000000, 230400, 1,   4,  5, 0x55, 0 },
+    { 16000000, 460800, 1,   2,  2, 0xBB, 0 },
+    { 24000000,   9600, 1, 156,  4, 0x00, 0 },
+};
+
+// Baud rates que debe soportar la tarjeta con SMCLK = __SYSTEM_CLOCK.
+static const unsigned board_bauds[] = { 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600 };
+
+#define BOARD_BRCLK         48000000u
+#define MAX_AVG_ERROR_PPM   2000            // 0.2 % de error promedio por bit.
+
+static unsigned bits_set(unsigned v)
+{
+    unsigned n = 0;
+
+    for (; v; v >>= 1)
+        n += v & 1;
+    return n;
+}
+
+// Error del periodo promedio de bit en ppm: UCBRSx agrega un ciclo de BRCLK en los bits
+// marcados de cada 8, asi que en promedio agrega (bits en 1) / 8.
+static long avg_error_ppm(unsigned brclk, unsigned baud, const UART_BAUD_DIVISORS *div)
+{
+    double cycles = div->os16 ? 16.0 * div->brw + div->brf : (double) div->brw;
+    double n = (double) brclk / baud;
+
+    cycles += bits_set(div->brs) / 8.0;
+    return (long) ((cycles - n) / n * 1e6);
+}
+
+int main(void)
+{
+    UART_BAUD_DIVISORS div;
+    unsigned i, failures = 0;
+    long ppm;
+
+    for (i = 0; i < sizeof(ti_table) / sizeof(ti_table[0]); i++)
+    {
+        const TI_BAUD_ROW *row = &ti_table[i];
+        int ok = (uart_baud_divisors(row->brclk, row->baud, row->os16, &div) == IO_OK) &&
+                 (div.os16 == row->os16) && (div.brw == row->brw) && (div.brf == row->brf) &&
+                 (row->search ? (bits_set(div.brs) == bits_set(row->brs)) : (div.brs == row->brs));
+
+        if (!ok)
+        {
+            printf("FALLA %8u Hz %6u baud: UCOS16 %u UCBRx %u UCBRFx %u UCBRSx 0x%02X (TI: %u %u %u 0x%02X)\n",
+                   row->brclk, row->baud, (unsigned) div.os16, div.brw, div.brf, div.brs,
+                   row->os16, row->brw, row->brf, row->brs);
+            failures++;
+        }
+    }
+
+    for (i = 0; i < sizeof(board_bauds) / sizeof(board_bauds[0]); i++)
+    {
+        if (uart_baud_divisors(BOARD_BRCLK, board_bauds[i], 1, &div) != IO_OK)
+        {
+            printf("FALLA %u Hz %6u baud: sin divisores\n", BOARD_BRCLK, board_bauds[i]);
+            failures++;
+            continue;
+        }
+
+        ppm = avg_error_ppm(BOARD_BRCLK, board_bauds[i], &div);
+        if ((ppm > MAX_AVG_ERROR_PPM) || (ppm < -MAX_AVG_ERROR_PPM))
+        {
+            printf("FALLA %u Hz %6u baud: error promedio %ld ppm\n", BOARD_BRCLK, board_bauds[i], ppm);
+            failures++;
+        }
+    }
+
+    // Limites: baud rate 0, BRCLK menor a 3 veces el baud rate y UCBRx de mas de 16 bits.
+    if ((uart_baud_divisors(BOARD_BRCLK, 0, 1, &div) != IO_ERR) ||
+        (uart_baud_divisors(32768, 115200, 0, &div) != IO_ERR) ||
+        (uart_baud_divisors(BOARD_BRCLK, 300, 0, &div) != IO_ERR))
+    {
+        printf("FALLA limites: se aceptaron divisores imposibles\n");
+        failures++;
+    }
+
+    printf("%u renglones de TI, %u baud rates a %u Hz: %u fallas\n",
+           (unsigned) (sizeof(ti_table) / sizeof(ti_table[0])),
+           (unsigned) (sizeof(board_bauds) / sizeof(board_bauds[0])), BOARD_BRCLK, failures);
+
+    return failures ? 1 : 0;
+}